@@ -0,0 +1,110 @@
+#ifndef CORE_ALIGNED_ALLOCATOR_H
+#define CORE_ALIGNED_ALLOCATOR_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief STL allocator of over-aligned memory for SIMD loads.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+namespace pml {
+
+    /**
+    * @class aligned_allocator
+    *
+    * @brief
+    * STL allocator whose memory begins at a multiple of Alignment bytes.
+    * The default 64 bytes is a cache line and the width of AVX-512 registers,
+    * so that std::vector<double, aligned_allocator<double>> can be loaded by _mm256_load_pd and _mm512_load_pd.
+    * Memory is obtained by _aligned_malloc or posix_memalign, which does not depend on the aligned new of C++17.
+    */
+    template<class T, std::size_t Alignment = 64>
+    class aligned_allocator
+    {
+        static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+        static_assert(Alignment >= alignof(T), "Alignment must not be smaller than the natural alignment.");
+        static_assert(Alignment % sizeof(void*) == 0, "Alignment must be a multiple of the pointer size.");
+
+    public:
+        using value_type = T;
+
+        static constexpr std::size_t alignment = Alignment;
+
+        template<class U>
+        struct rebind
+        {
+            using other = aligned_allocator<U, Alignment>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template<class U>
+        aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept
+        {}
+
+        T* allocate(std::size_t inNumber)
+        {
+            if (inNumber > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                throw std::bad_alloc();
+            }
+
+            const auto lBytes = std::max<std::size_t>(inNumber * sizeof(T), 1);
+
+#ifdef _WIN32
+            auto* lPtr = _aligned_malloc(lBytes, Alignment);
+#else
+            void* lPtr = nullptr;
+            if (posix_memalign(&lPtr, Alignment, lBytes) != 0) {
+                lPtr = nullptr;
+            }
+#endif
+            if (!lPtr) {
+                throw std::bad_alloc();
+            }
+
+            return static_cast<T*>(lPtr);
+        }
+
+        void deallocate(T* inPtr, std::size_t) noexcept
+        {
+#ifdef _WIN32
+            _aligned_free(inPtr);
+#else
+            free(inPtr);
+#endif
+        }
+    };
+
+    template<class T, class U, std::size_t Alignment>
+    bool operator==(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&) noexcept
+    {
+        return true;
+    }
+
+    template<class T, class U, std::size_t Alignment>
+    bool operator!=(const aligned_allocator<T, Alignment>& inLhs, const aligned_allocator<U, Alignment>& inRhs) noexcept
+    {
+        return !(inLhs == inRhs);
+    }
+
+    /**
+    * @brief std::vector whose data() is aligned to Alignment bytes.
+    */
+    template<class T, std::size_t Alignment = 64>
+    using aligned_vector = std::vector<T, aligned_allocator<T, Alignment>>;
+
+} // pml
+
+#endif
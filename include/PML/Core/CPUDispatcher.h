@@ -14,11 +14,18 @@
 #include <vector>
 #include <array>
 #include <bitset>
+#include <algorithm>
+#include <thread>
+#include <cstdint>
 
 #ifndef _MSC_VER
 #include <cpuid.h>
 #endif
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 namespace pml {
 
     /**
@@ -40,10 +47,12 @@ namespace pml {
             std::bitset<32> f_1_ECX_;
             std::bitset<32> f_1_EDX_;
             std::bitset<32> f_7_EBX_;
+            std::uint64_t mXCR0; // register states enabled by the OS, or zero if XGETBV is unavailable.
 
             std::vector<std::array<int, 4>> data_;
             std::vector<std::array<int, 4>> extdata_;
             std::size_t mOptimalAlignment;
+            std::vector<std::size_t> mAvailableCores;
 
             CPUData(const CPUData&)            = delete;
             CPUData(CPUData&&)                 = delete;
@@ -58,9 +67,11 @@ namespace pml {
                 f_1_ECX_{ 0 },
                 f_1_EDX_{ 0 },
                 f_7_EBX_{ 0 },
+                mXCR0(0),
                 data_{},
                 extdata_{},
-                mOptimalAlignment(16)
+                mOptimalAlignment(16),
+                mAvailableCores{}
             {
 #ifdef _MSC_VER
                 std::array<int, 4> cpui;
@@ -169,13 +180,65 @@ namespace pml {
                     uint32_t edx = 0;
                     uint32_t eax = 7;
 
-                    __cpuid(7, eax, f_7_EBX_, ecx.reg, edx);
+                    // the sub-leaf must be specified, otherwise ECX is undefined.
+                    __cpuid_count(7, 0, eax, f_7_EBX_, ecx.reg, edx);
+                }
+#endif
+                // XGETBV is available only if the OS has enabled XSAVE.
+                if (f_1_ECX_[27])
+                {
+#ifdef _MSC_VER
+                    mXCR0 = _xgetbv(0);
+#else
+                    uint32_t lEAX = 0;
+                    uint32_t lEDX = 0;
+                    __asm__ __volatile__("xgetbv" : "=a"(lEAX), "=d"(lEDX) : "c"(0));
+                    mXCR0 = (static_cast<std::uint64_t>(lEDX) << 32) | lEAX;
+#endif
+                }
+
+                mOptimalAlignment = (f_7_EBX_[16] && isAVX512StateEnabled()) ? 64 :
+                                    (f_7_EBX_[ 5] && isAVXStateEnabled())    ? 32 :
+                                    (f_1_ECX_[28] && isAVXStateEnabled())    ? 32 :
+                                                                               16;
+
+#ifdef __linux__
+                // logical CPUs on which this process is allowed to run.
+                cpu_set_t lCPUSet;
+                CPU_ZERO(&lCPUSet);
+                if (sched_getaffinity(0, sizeof(lCPUSet), &lCPUSet) == 0)
+                {
+                    for (std::size_t i = 0; i < static_cast<std::size_t>(CPU_SETSIZE); ++i)
+                    {
+                        if (CPU_ISSET(i, &lCPUSet)) {
+                            mAvailableCores.push_back(i);
+                        }
+                    }
                 }
 #endif
-                mOptimalAlignment = f_7_EBX_[16] ? 64 :
-                                    f_7_EBX_[ 5] ? 32 :
-                                    f_1_ECX_[28] ? 32 :
-                                                   16;
+                if (mAvailableCores.empty())
+                {
+                    const auto lCoreNumber = std::max(std::thread::hardware_concurrency(), 1U);
+                    for (std::size_t i = 0; i < lCoreNumber; ++i) {
+                        mAvailableCores.push_back(i);
+                    }
+                }
+            }
+
+            /**
+            * @brief Does the OS save the XMM and YMM registers (XCR0 bits 1 and 2) ?
+            */
+            bool isAVXStateEnabled() const
+            {
+                return ((mXCR0 & 0x6) == 0x6);
+            }
+
+            /**
+            * @brief Does the OS save the YMM registers, the opmasks and the ZMM registers (XCR0 bits 1, 2 and 5-7) ?
+            */
+            bool isAVX512StateEnabled() const
+            {
+                return ((mXCR0 & 0xE6) == 0xE6);
             }
         };
 
@@ -253,59 +316,99 @@ namespace pml {
         }
 
         /**
-        * @brief Is FMA supported ?
+        * @brief Has the OS enabled XSAVE, which XGETBV requires (OSXSAVE) ?
+        */
+        static bool isOSXSAVE()
+        {
+            return getCPUData().f_1_ECX_[27];
+        }
+
+        /**
+        * @brief Does the OS save the YMM registers on context switches ? AVX, FMA and AVX2 can be used only if so.
+        */
+        static bool isAVXStateEnabled()
+        {
+            return getCPUData().isAVXStateEnabled();
+        }
+
+        /**
+        * @brief Does the OS save the opmask and ZMM registers on context switches ? AVX512 can be used only if so.
+        */
+        static bool isAVX512StateEnabled()
+        {
+            return getCPUData().isAVX512StateEnabled();
+        }
+
+        /**
+        * @brief Is FMA supported by the CPU and enabled by the OS ?
         */
         static bool isFMA()
         {
-            return getCPUData().f_1_ECX_[12];
+            return getCPUData().f_1_ECX_[12] && isAVXStateEnabled();
         }
 
         /**
-        * @brief Is AVX supported ?
+        * @brief Is AVX supported by the CPU and enabled by the OS ?
         */
         static bool isAVX()
         {
-            return getCPUData().f_1_ECX_[28];
+            return getCPUData().f_1_ECX_[28] && isAVXStateEnabled();
         }
 
         /**
-        * @brief Is AVX2 supported ?
+        * @brief Is AVX2 supported by the CPU and enabled by the OS ?
         */
         static bool isAVX2()
         {
-            return getCPUData().f_7_EBX_[5];
+            return getCPUData().f_7_EBX_[5] && isAVXStateEnabled();
         }
 
         /**
-        * @brief Are standard AVX512 instructions supported ?
+        * @brief Are standard AVX512 instructions supported by the CPU and enabled by the OS ?
         */
         static bool isAVX512F()
         {
-            return getCPUData().f_7_EBX_[16];
+            return getCPUData().f_7_EBX_[16] && isAVX512StateEnabled();
         }
 
         /**
-        * @brief Is AVX512PF supported ?
+        * @brief Is AVX512PF supported by the CPU and enabled by the OS ?
         */
         static bool isAVX512PF()
         {
-            return getCPUData().f_7_EBX_[26];
+            return getCPUData().f_7_EBX_[26] && isAVX512StateEnabled();
         }
 
         /**
-        * @brief Is AVX512ER supported ?
+        * @brief Is AVX512ER supported by the CPU and enabled by the OS ?
         */
         static bool isAVX512ER()
         {
-            return getCPUData().f_7_EBX_[27];
+            return getCPUData().f_7_EBX_[27] && isAVX512StateEnabled();
         }
 
         /**
-        * @brief Is AVX512CD supported ?
+        * @brief Is AVX512CD supported by the CPU and enabled by the OS ?
         */
         static bool isAVX512CD()
         {
-            return getCPUData().f_7_EBX_[28];
+            return getCPUData().f_7_EBX_[28] && isAVX512StateEnabled();
+        }
+
+        /**
+        * @brief Is AVX512BW supported by the CPU and enabled by the OS ?
+        */
+        static bool isAVX512BW()
+        {
+            return getCPUData().f_7_EBX_[30] && isAVX512StateEnabled();
+        }
+
+        /**
+        * @brief Is PCLMULQDQ (carry-less multiplication) supported ?
+        */
+        static bool isPCLMULQDQ()
+        {
+            return getCPUData().f_1_ECX_[1];
         }
 
         /**
@@ -316,6 +419,15 @@ namespace pml {
             return getCPUData().mOptimalAlignment;
         }
 
+        /**
+        * @brief Get indices of the logical cores on which the present process can run.
+        *        On Linux these are taken from the affinity mask of the process, otherwise 0, 1, ..., std::thread::hardware_concurrency()-1.
+        */
+        static const std::vector<std::size_t>& getAvailableCores()
+        {
+            return getCPUData().mAvailableCores;
+        }
+
         /**
         * @brief Output supported instruction set extensions of the runtime CPU architecture.
         *
@@ -339,6 +451,10 @@ namespace pml {
             support_message("SSE4.1", CPUDispatcher::isSSE41());
             support_message("SSE4.2", CPUDispatcher::isSSE42());
 
+            support_message("OSXSAVE", CPUDispatcher::isOSXSAVE());
+            support_message("YMM state", CPUDispatcher::isAVXStateEnabled());
+            support_message("ZMM state", CPUDispatcher::isAVX512StateEnabled());
+
             support_message("FMA   ", CPUDispatcher::isFMA());
             support_message("AVX   ", CPUDispatcher::isAVX());
             support_message("AVX2  ", CPUDispatcher::isAVX2());
@@ -347,6 +463,11 @@ namespace pml {
             support_message("AVX512PF", CPUDispatcher::isAVX512PF());
             support_message("AVX512ER", CPUDispatcher::isAVX512ER());
             support_message("AVX512CD", CPUDispatcher::isAVX512CD());
+            support_message("AVX512BW", CPUDispatcher::isAVX512BW());
+
+            support_message("PCLMULQDQ", CPUDispatcher::isPCLMULQDQ());
+
+            outStream << "Available logical cores: " << CPUDispatcher::getAvailableCores().size() << std::endl;
         }
     
     }; // CPUDispatcher
@@ -0,0 +1,274 @@
+#ifndef CORE_MAPPED_FILE_H
+#define CORE_MAPPED_FILE_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief Read-only memory-mapped files, and the atomic replacement of files written for them.
+*/
+
+#include <PML/Core/exception_handler.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pml {
+
+    /**
+    * @class MappedFile
+    *
+    * @brief
+    * RAII read-only mapping of a whole file by mmap (CreateFileMapping on Windows).
+    * The contents are read directly from the page cache without copies into stream buffers.
+    * If the file cannot be opened or mapped, isOpen() returns false and the range [begin(), end()) is empty.
+    * An empty file is open and has an empty range.
+    */
+    class MappedFile final
+    {
+    public:
+
+        /**
+        * @brief Expected access pattern, passed to madvise on POSIX systems.
+        */
+        enum class AccessHint
+        {
+            Normal,
+            Sequential,
+            Random,
+        };
+
+        /**
+        * @param[in] inFilePath
+        * The path to the target file.
+        *
+        * @param[in] inHint
+        * Expected access pattern. Sequential enables aggressive read-ahead.
+        */
+        explicit MappedFile(const std::string& inFilePath, AccessHint inHint = AccessHint::Sequential)
+            : mData(nullptr), mSize(0), mIsOpen(false)
+        {
+#ifdef _WIN32
+            const auto lFile = CreateFileA(
+                inFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                (inHint == AccessHint::Sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : (inHint == AccessHint::Random) ? FILE_FLAG_RANDOM_ACCESS : FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+            if (lFile == INVALID_HANDLE_VALUE) {
+                return;
+            }
+
+            LARGE_INTEGER lSize;
+            if (!GetFileSizeEx(lFile, &lSize))
+            {
+                CloseHandle(lFile);
+                return;
+            }
+
+            mSize = static_cast<std::size_t>(lSize.QuadPart);
+            if (mSize == 0)
+            {
+                CloseHandle(lFile);
+                mIsOpen = true;
+                return;
+            }
+
+            const auto lMapping = CreateFileMappingA(lFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(lFile);
+            if (!lMapping)
+            {
+                mSize = 0;
+                return;
+            }
+
+            mData = static_cast<const char*>(MapViewOfFile(lMapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(lMapping);
+#else
+            const auto lFile = open(inFilePath.c_str(), O_RDONLY);
+            if (lFile < 0) {
+                return;
+            }
+
+            struct stat lStat;
+            if ((fstat(lFile, &lStat) != 0) || !S_ISREG(lStat.st_mode))
+            {
+                close(lFile);
+                return;
+            }
+
+            mSize = static_cast<std::size_t>(lStat.st_size);
+            if (mSize == 0)
+            {
+                close(lFile);
+                mIsOpen = true;
+                return;
+            }
+
+            auto* lPtr = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, lFile, 0);
+            close(lFile);
+            if (lPtr == MAP_FAILED)
+            {
+                mSize = 0;
+                return;
+            }
+
+            const auto lAdvice
+                = (inHint == AccessHint::Sequential) ? MADV_SEQUENTIAL
+                : (inHint == AccessHint::Random)     ? MADV_RANDOM
+                :                                      MADV_NORMAL;
+            madvise(lPtr, mSize, lAdvice);
+
+            mData = static_cast<const char*>(lPtr);
+#endif
+            mIsOpen = (mData != nullptr);
+            if (!mIsOpen) {
+                mSize = 0;
+            }
+        }
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile(MappedFile&&)                 = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&)      = delete;
+
+        /**
+        * @brief Destructor. The mapping is released here.
+        */
+        ~MappedFile()
+        {
+            if (!mData) {
+                return;
+            }
+
+#ifdef _WIN32
+            UnmapViewOfFile(mData);
+#else
+            munmap(const_cast<char*>(mData), mSize);
+#endif
+        }
+
+        /**
+        * @brief Whether the file is mapped or not.
+        */
+        bool isOpen() const noexcept
+        {
+            return mIsOpen;
+        }
+
+        /**
+        * @brief The first byte of the file, or nullptr if the file is empty or not open.
+        */
+        const char* data() const noexcept
+        {
+            return mData;
+        }
+
+        /**
+        * @brief The size of the file in bytes.
+        */
+        std::size_t size() const noexcept
+        {
+            return mSize;
+        }
+
+        const char* begin() const noexcept
+        {
+            return mData;
+        }
+
+        const char* end() const noexcept
+        {
+            return mData + mSize;
+        }
+
+        /**
+        * @brief
+        * Size and modification time of inFilePath, used to detect files changed after derived data such as caches are written.
+        * The time is in the implementation-defined unit of std::filesystem::file_time_type.
+        *
+        * @return False if the status cannot be obtained.
+        */
+        static bool getStatus(const std::string& inFilePath, std::uint64_t& outSize, std::int64_t& outModifiedTime)
+        {
+            std::error_code lError;
+
+            const auto lSize = std::filesystem::file_size(inFilePath, lError);
+            if (lError) {
+                return false;
+            }
+
+            const auto lTime = std::filesystem::last_write_time(inFilePath, lError);
+            if (lError) {
+                return false;
+            }
+
+            outSize = static_cast<std::uint64_t>(lSize);
+            outModifiedTime = static_cast<std::int64_t>(lTime.time_since_epoch().count());
+
+            return true;
+        }
+
+    private:
+        const char* mData;
+        std::size_t mSize;
+        bool mIsOpen;
+    };
+
+    namespace detail {
+
+        /**
+        * @brief
+        * Writes inParts to inFilePath + ".tmp" and renames it to inFilePath,
+        * so that a reader (or a mapping) never sees a partially written file.
+        * The temporary file is closed before its state is checked, so that errors of the final flush are detected,
+        * and it is removed on failure.
+        *
+        * @throw std::runtime_error if the file cannot be written or replaced. inFilePath is then left unchanged.
+        */
+        inline void replace_file(const std::string& inFilePath, std::initializer_list<std::string_view> inParts)
+        {
+            const auto lTemporaryPath = inFilePath + ".tmp";
+            std::error_code lError;
+
+            std::ofstream lFile(lTemporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            for (const auto& part_i : inParts) {
+                lFile.write(part_i.data(), static_cast<std::streamsize>(part_i.size()));
+            }
+            lFile.close();
+
+            if (!lFile)
+            {
+                std::filesystem::remove(lTemporaryPath, lError);
+                PML_THROW_WITH_NESTED(std::runtime_error, "File " + lTemporaryPath + " cannot be written.");
+            }
+
+            std::filesystem::rename(lTemporaryPath, inFilePath, lError);
+            if (lError)
+            {
+                const auto lMessage = lError.message();
+                std::filesystem::remove(lTemporaryPath, lError);
+                PML_THROW_WITH_NESTED(std::runtime_error, "File " + inFilePath + " cannot be replaced: " + lMessage);
+            }
+        }
+    } // detail
+
+} // pml
+
+#endif
@@ -0,0 +1,360 @@
+#ifndef CORE_MEMORY_RESOURCE_H
+#define CORE_MEMORY_RESOURCE_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief Arena and pool memory resources compatible with std::pmr, for temporaries of hot paths.
+*/
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace pml {
+
+    /**
+    * @class ArenaResource
+    *
+    * @brief
+    * Monotonic (bump pointer) memory resource.
+    * Memory is carved out of chunks obtained from the upstream resource and deallocate() does nothing.
+    * reset() and rewind() make the memory reusable without returning the chunks to the upstream,
+    * so that repeated batches of temporaries stop touching the global heap after the first one.
+    * This class is not thread-safe; use ArenaResource::getThreadLocal() for per-thread scratch memory.
+    */
+    class ArenaResource final : public std::pmr::memory_resource
+    {
+        struct Chunk final
+        {
+            char* mData;
+            std::size_t mSize;
+        };
+
+    public:
+
+        /**
+        * @brief Position in the arena, see getMarker() and rewind().
+        */
+        struct Marker final
+        {
+            std::size_t mChunk;
+            std::size_t mOffset;
+        };
+
+        /**
+        * @param[in] inInitialSize
+        * Size of the first chunk in bytes. Following chunks are twice as large as the previous one at least.
+        *
+        * @param[in] inUpstream
+        * Resource from which chunks are allocated.
+        */
+        explicit ArenaResource(
+            std::size_t inInitialSize = 64 * 1024,
+            std::pmr::memory_resource* inUpstream = std::pmr::get_default_resource())
+            : mUpstream(inUpstream),
+            mInitialSize(std::max<std::size_t>(inInitialSize, 64)),
+            mChunks(),
+            mCurrent(0),
+            mOffset(0)
+        {}
+
+        ArenaResource(const ArenaResource&)            = delete;
+        ArenaResource(ArenaResource&&)                 = delete;
+        ArenaResource& operator=(const ArenaResource&) = delete;
+        ArenaResource& operator=(ArenaResource&&)      = delete;
+
+        /**
+        * @brief Destructor. All chunks are returned to the upstream.
+        */
+        ~ArenaResource() override
+        {
+            release();
+        }
+
+        /**
+        * @brief Make all memory reusable. Chunks are kept.
+        */
+        void reset() noexcept
+        {
+            mCurrent = 0;
+            mOffset  = 0;
+        }
+
+        /**
+        * @brief Return all chunks to the upstream.
+        */
+        void release() noexcept
+        {
+            for (const auto& chunk_i : mChunks) {
+                mUpstream->deallocate(chunk_i.mData, chunk_i.mSize, alignof(std::max_align_t));
+            }
+
+            mChunks.clear();
+            reset();
+        }
+
+        /**
+        * @brief Current position. Memory allocated after this can be reused by rewind(marker).
+        */
+        Marker getMarker() const noexcept
+        {
+            return Marker{ mCurrent, mOffset };
+        }
+
+        /**
+        * @brief Make memory allocated after inMarker reusable.
+        */
+        void rewind(const Marker& inMarker) noexcept
+        {
+            mCurrent = inMarker.mChunk;
+            mOffset  = inMarker.mOffset;
+        }
+
+        /**
+        * @brief Total size of chunks in bytes.
+        */
+        std::size_t getCapacity() const noexcept
+        {
+            std::size_t lCapacity = 0;
+            for (const auto& chunk_i : mChunks) {
+                lCapacity += chunk_i.mSize;
+            }
+
+            return lCapacity;
+        }
+
+        /**
+        * @brief Arena of the calling thread, which lives until the thread exits.
+        */
+        static ArenaResource& getThreadLocal()
+        {
+            static thread_local ArenaResource lArena;
+
+            return lArena;
+        }
+
+    private:
+
+        void* do_allocate(std::size_t inBytes, std::size_t inAlignment) override
+        {
+            for (; mCurrent < mChunks.size(); ++mCurrent, mOffset = 0)
+            {
+                if (auto* lPtr = carve(mChunks[mCurrent], inBytes, inAlignment)) {
+                    return lPtr;
+                }
+            }
+
+            const auto lLastSize = mChunks.empty() ? mInitialSize / 2 : mChunks.back().mSize;
+            const auto lSize = std::max(2 * lLastSize, inBytes + inAlignment);
+
+            mChunks.reserve(mChunks.size() + 1);
+            mChunks.push_back(Chunk{ static_cast<char*>(mUpstream->allocate(lSize, alignof(std::max_align_t))), lSize });
+            mCurrent = mChunks.size() - 1;
+            mOffset  = 0;
+
+            return carve(mChunks.back(), inBytes, inAlignment);
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override
+        {}
+
+        bool do_is_equal(const std::pmr::memory_resource& inOther) const noexcept override
+        {
+            return (this == &inOther);
+        }
+
+        void* carve(const Chunk& inChunk, std::size_t inBytes, std::size_t inAlignment) noexcept
+        {
+            const auto lAddress = reinterpret_cast<std::uintptr_t>(inChunk.mData) + mOffset;
+            const auto lAligned = (lAddress + inAlignment - 1) & ~(static_cast<std::uintptr_t>(inAlignment) - 1);
+            const auto lNextOffset = static_cast<std::size_t>(lAligned - reinterpret_cast<std::uintptr_t>(inChunk.mData)) + inBytes;
+
+            if (lNextOffset > inChunk.mSize) {
+                return nullptr;
+            }
+
+            mOffset = lNextOffset;
+
+            return reinterpret_cast<void*>(lAligned);
+        }
+
+        std::pmr::memory_resource* mUpstream;
+        std::size_t mInitialSize;
+        std::vector<Chunk> mChunks;
+        std::size_t mCurrent;
+        std::size_t mOffset;
+    };
+
+    /**
+    * @class ArenaScope
+    *
+    * @brief RAII helper which rewinds an arena to the position at the construction when it is destroyed.
+    *        Objects allocated from the arena inside the scope must be destroyed before this.
+    */
+    class ArenaScope final
+    {
+    public:
+        explicit ArenaScope(ArenaResource& inArena = ArenaResource::getThreadLocal()) noexcept
+            : mArena(inArena), mMarker(inArena.getMarker())
+        {}
+
+        ArenaScope(const ArenaScope&)            = delete;
+        ArenaScope(ArenaScope&&)                 = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+        ArenaScope& operator=(ArenaScope&&)      = delete;
+
+        ~ArenaScope()
+        {
+            mArena.rewind(mMarker);
+        }
+
+        ArenaResource& getArena() const noexcept
+        {
+            return mArena;
+        }
+
+    private:
+        ArenaResource& mArena;
+        ArenaResource::Marker mMarker;
+    };
+
+    /**
+    * @class PoolResource
+    *
+    * @brief
+    * Memory resource keeping free lists of fixed size blocks, 16, 32, 64, ..., 4096 bytes.
+    * Deallocated blocks are pushed on the free list of its size class and reused by the next allocation in O(1).
+    * Larger requests are forwarded to the upstream directly.
+    * Unlike ArenaResource, memory is reusable block by block, which suits objects with various lifetimes such as reused containers.
+    * This class is not thread-safe.
+    */
+    class PoolResource final : public std::pmr::memory_resource
+    {
+        struct FreeBlock final
+        {
+            FreeBlock* mNext;
+        };
+
+        static constexpr std::size_t MIN_BLOCK_SIZE  = 16;
+        static constexpr std::size_t CLASS_NUMBER    = 9;   // 16, 32, ..., 4096
+        static constexpr std::size_t MAX_BLOCK_SIZE  = (MIN_BLOCK_SIZE << (CLASS_NUMBER - 1));
+        static constexpr std::size_t BLOCKS_PER_SLAB = 32;
+
+    public:
+        explicit PoolResource(std::pmr::memory_resource* inUpstream = std::pmr::get_default_resource())
+            : mUpstream(inUpstream), mFreeLists(), mSlabs()
+        {
+            mFreeLists.fill(nullptr);
+        }
+
+        PoolResource(const PoolResource&)            = delete;
+        PoolResource(PoolResource&&)                 = delete;
+        PoolResource& operator=(const PoolResource&) = delete;
+        PoolResource& operator=(PoolResource&&)      = delete;
+
+        /**
+        * @brief Destructor. All slabs are returned to the upstream.
+        */
+        ~PoolResource() override
+        {
+            release();
+        }
+
+        /**
+        * @brief Return all slabs to the upstream. Blocks in use become invalid.
+        */
+        void release() noexcept
+        {
+            for (const auto& slab_i : mSlabs) {
+                mUpstream->deallocate(slab_i.first, slab_i.second, MAX_BLOCK_SIZE);
+            }
+
+            mSlabs.clear();
+            mFreeLists.fill(nullptr);
+        }
+
+    private:
+
+        static std::size_t getClass(std::size_t inBytes, std::size_t inAlignment) noexcept
+        {
+            const auto lSize = std::max({ inBytes, inAlignment, MIN_BLOCK_SIZE });
+
+            std::size_t lClass = 0;
+            while ((MIN_BLOCK_SIZE << lClass) < lSize) {
+                ++lClass;
+            }
+
+            return lClass;
+        }
+
+        void* do_allocate(std::size_t inBytes, std::size_t inAlignment) override
+        {
+            if ((inBytes > MAX_BLOCK_SIZE) || (inAlignment > MAX_BLOCK_SIZE)) {
+                return mUpstream->allocate(inBytes, inAlignment);
+            }
+
+            const auto lClass = getClass(inBytes, inAlignment);
+
+            if (!mFreeLists[lClass])
+            {
+                // blocks are aligned to their size since slabs are aligned to MAX_BLOCK_SIZE.
+                const auto lBlockSize = (MIN_BLOCK_SIZE << lClass);
+                const auto lSlabSize  = std::max(lBlockSize * BLOCKS_PER_SLAB, MAX_BLOCK_SIZE);
+                auto* lSlab = static_cast<char*>(mUpstream->allocate(lSlabSize, MAX_BLOCK_SIZE));
+
+                try {
+                    mSlabs.emplace_back(lSlab, lSlabSize);
+                }
+                catch (...)
+                {
+                    mUpstream->deallocate(lSlab, lSlabSize, MAX_BLOCK_SIZE);
+                    throw;
+                }
+
+                for (auto lOffset = lSlabSize; lOffset >= lBlockSize; lOffset -= lBlockSize) {
+                    push(lClass, lSlab + lOffset - lBlockSize);
+                }
+            }
+
+            auto* lBlock = mFreeLists[lClass];
+            mFreeLists[lClass] = lBlock->mNext;
+
+            return lBlock;
+        }
+
+        void do_deallocate(void* inPtr, std::size_t inBytes, std::size_t inAlignment) override
+        {
+            if ((inBytes > MAX_BLOCK_SIZE) || (inAlignment > MAX_BLOCK_SIZE))
+            {
+                mUpstream->deallocate(inPtr, inBytes, inAlignment);
+                return;
+            }
+
+            push(getClass(inBytes, inAlignment), inPtr);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& inOther) const noexcept override
+        {
+            return (this == &inOther);
+        }
+
+        void push(std::size_t inClass, void* inPtr) noexcept
+        {
+            auto* lBlock = static_cast<FreeBlock*>(inPtr);
+            lBlock->mNext = mFreeLists[inClass];
+            mFreeLists[inClass] = lBlock;
+        }
+
+        std::pmr::memory_resource* mUpstream;
+        std::array<FreeBlock*, CLASS_NUMBER> mFreeLists;
+        std::vector<std::pair<char*, std::size_t>> mSlabs;
+    };
+
+} // pml
+
+#endif
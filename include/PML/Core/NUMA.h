@@ -0,0 +1,430 @@
+#ifndef CORE_NUMA_H
+#define CORE_NUMA_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief NUMA topology and NUMA-aware memory placement.
+*/
+
+#include <PML/Core/CPUDispatcher.h>
+#include <PML/Core/ThreadPool.h>
+#include <PML/Core/exception_handler.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace pml {
+
+    /**
+    * @brief Placement policy of pages of NUMA-aware allocations.
+    */
+    enum class NUMAPlacement
+    {
+        /**
+        * Pages are not touched at allocation and land on the node of the thread which touches them first.
+        * This is what usual allocators do.
+        */
+        Default,
+
+        /**
+        * Pages are interleaved round-robin over all nodes (Linux only, otherwise same as Default).
+        * This is the best choice when the access pattern of the array is unknown.
+        */
+        Interleaved,
+
+        /**
+        * Pages are touched at allocation by ThreadPool::parallelForStatic with the element range of the array.
+        * Hence each page lands on the node of the worker which processes it
+        * in later ThreadPool::parallelForStatic calls with the same range on the same (pinned) pool.
+        */
+        FirstTouch,
+    };
+
+    /**
+    * @class NUMATopology
+    *
+    * @brief
+    * NUMA nodes of the runtime machine and their logical cores.
+    * On Linux these are read from /sys/devices/system/node and no library is required.
+    * On the other platforms or if sysfs is not available, the machine is treated as a single node owning all cores.
+    */
+    class NUMATopology final
+    {
+        class TopologyData final
+        {
+        public:
+            std::vector<std::vector<std::size_t>> mCoresOfNodes;
+            std::vector<std::size_t> mNodeOfCores;
+            std::vector<std::size_t> mNodeIDs; // ids of the OS, which can be sparse.
+
+            TopologyData(const TopologyData&)            = delete;
+            TopologyData(TopologyData&&)                 = delete;
+            TopologyData& operator=(const TopologyData&) = delete;
+            TopologyData& operator=(TopologyData&&)      = delete;
+
+            ~TopologyData() = default;
+
+            TopologyData() : mCoresOfNodes(), mNodeOfCores(), mNodeIDs()
+            {
+#ifdef __linux__
+                // node ids can be sparse, so that exactly the online ones are visited.
+                std::ifstream lOnline("/sys/devices/system/node/online");
+                std::string lNodeList;
+                std::getline(lOnline, lNodeList);
+
+                for (const auto node_i : parseCPUList(lNodeList))
+                {
+                    std::ifstream lFile("/sys/devices/system/node/node" + std::to_string(node_i) + "/cpulist");
+                    std::string lCPUList;
+                    std::getline(lFile, lCPUList);
+
+                    // memory-only nodes are dropped.
+                    auto lCores = parseCPUList(lCPUList);
+                    if (!lCores.empty())
+                    {
+                        mCoresOfNodes.push_back(std::move(lCores));
+                        mNodeIDs.push_back(node_i);
+                    }
+                }
+#endif
+                if (mCoresOfNodes.empty())
+                {
+                    mCoresOfNodes.push_back(CPUDispatcher::getAvailableCores());
+                    mNodeIDs.assign(1, 0);
+                }
+
+                for (std::size_t lNode = 0; lNode < mCoresOfNodes.size(); ++lNode)
+                {
+                    for (const auto core_i : mCoresOfNodes[lNode])
+                    {
+                        if (mNodeOfCores.size() <= core_i) {
+                            mNodeOfCores.resize(core_i + 1, 0);
+                        }
+
+                        mNodeOfCores[core_i] = lNode;
+                    }
+                }
+            }
+
+            /**
+            * @brief Parse the sysfs list format of cpulist and node/online, e.g. "0-3,8-11".
+            */
+            static std::vector<std::size_t> parseCPUList(const std::string& inCPUList)
+            {
+                std::vector<std::size_t> lCores;
+                std::stringstream lStream(inCPUList);
+                std::string lToken;
+
+                while (std::getline(lStream, lToken, ','))
+                {
+                    if (lToken.empty() || lToken == "\n") {
+                        continue;
+                    }
+
+                    const auto lHyphen = lToken.find('-');
+                    const auto lFirst  = std::stoul(lToken.substr(0, lHyphen));
+                    const auto lLast   = (lHyphen == std::string::npos) ? lFirst : std::stoul(lToken.substr(lHyphen + 1));
+
+                    for (auto i = lFirst; i <= lLast; ++i) {
+                        lCores.push_back(i);
+                    }
+                }
+
+                return lCores;
+            }
+        };
+
+        static const TopologyData& getTopologyData()
+        {
+            static const TopologyData lData;
+
+            return lData;
+        }
+
+    public:
+
+        /**
+        * @brief The number of NUMA nodes having logical cores.
+        */
+        static std::size_t getNodeNumber()
+        {
+            return getTopologyData().mCoresOfNodes.size();
+        }
+
+        /**
+        * @brief Logical cores of the inNode-th node.
+        */
+        static const std::vector<std::size_t>& getCoresOfNode(std::size_t inNode)
+        {
+            return getTopologyData().mCoresOfNodes.at(inNode);
+        }
+
+        /**
+        * @brief
+        * The id of the inNode-th node given by the OS, e.g. N of /sys/devices/system/node/nodeN on Linux.
+        * Nodes are numbered contiguously by this class, while the ids of the OS can be sparse.
+        */
+        static std::size_t getNodeID(std::size_t inNode)
+        {
+            return getTopologyData().mNodeIDs.at(inNode);
+        }
+
+        /**
+        * @brief The node owning the logical core inCore.
+        */
+        static std::size_t getNodeOfCore(std::size_t inCore)
+        {
+            const auto& lNodeOfCores = getTopologyData().mNodeOfCores;
+
+            return (inCore < lNodeOfCores.size()) ? lNodeOfCores[inCore] : 0;
+        }
+
+        /**
+        * @brief Output NUMA nodes and their logical cores.
+        *
+        * @param[out] outStream
+        * NUMA topology.
+        */
+        static void outputNUMAInfo(std::ostream& outStream)
+        {
+            outStream << "NUMA Information" << std::endl;
+
+            for (std::size_t i = 0; i < getNodeNumber(); ++i)
+            {
+                outStream << "node" << getNodeID(i) << ":";
+                for (const auto core_i : getCoresOfNode(i)) {
+                    outStream << " " << core_i;
+                }
+                outStream << std::endl;
+            }
+        }
+    };
+
+    namespace detail {
+
+        inline std::size_t get_page_size()
+        {
+#ifdef _WIN32
+            SYSTEM_INFO lInfo;
+            GetSystemInfo(&lInfo);
+            return static_cast<std::size_t>(lInfo.dwPageSize);
+#else
+            return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        }
+
+        /**
+        * @brief Reserve untouched pages directly from the OS.
+        */
+        inline void* map_pages(std::size_t inBytes)
+        {
+#ifdef _WIN32
+            void* lPtr = VirtualAlloc(nullptr, inBytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+            void* lPtr = mmap(nullptr, inBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (lPtr == MAP_FAILED) {
+                lPtr = nullptr;
+            }
+#endif
+            if (!lPtr) {
+                throw std::bad_alloc();
+            }
+
+            return lPtr;
+        }
+
+        inline void unmap_pages(void* inPtr, std::size_t inBytes) noexcept
+        {
+#ifdef _WIN32
+            static_cast<void>(inBytes);
+            VirtualFree(inPtr, 0, MEM_RELEASE);
+#else
+            munmap(inPtr, inBytes);
+#endif
+        }
+
+        /**
+        * @brief
+        * Node mask of mbind with the bits of inNodeIDs.
+        * The kernel reads only maxnode - 1 bits, so that the mask has at least one bit after the largest id
+        * and its whole size in bits can be passed as maxnode.
+        */
+        inline std::vector<unsigned long> make_node_mask(const std::vector<std::size_t>& inNodeIDs)
+        {
+            constexpr std::size_t lBits = 8 * sizeof(unsigned long);
+
+            const auto lMaxID = inNodeIDs.empty() ? 0 : *std::max_element(inNodeIDs.cbegin(), inNodeIDs.cend());
+
+            std::vector<unsigned long> lNodeMask((lMaxID + 1) / lBits + 1, 0);
+            for (const auto id_i : inNodeIDs) {
+                lNodeMask[id_i / lBits] |= (1UL << (id_i % lBits));
+            }
+
+            return lNodeMask;
+        }
+
+        /**
+        * @brief Interleave pages over all NUMA nodes having cores by mbind(MPOL_INTERLEAVE). Failures are ignored.
+        */
+        inline void interleave_pages(void* inPtr, std::size_t inBytes)
+        {
+#if defined(__linux__) && defined(SYS_mbind)
+            constexpr int lMPOL_INTERLEAVE = 3;
+            constexpr std::size_t lBits = 8 * sizeof(unsigned long);
+
+            const auto lNodeNumber = NUMATopology::getNodeNumber();
+            if (lNodeNumber < 2) {
+                return;
+            }
+
+            std::vector<std::size_t> lNodeIDs;
+            for (std::size_t i = 0; i < lNodeNumber; ++i) {
+                lNodeIDs.push_back(NUMATopology::getNodeID(i));
+            }
+
+            const auto lNodeMask = make_node_mask(lNodeIDs);
+            syscall(SYS_mbind, inPtr, inBytes, lMPOL_INTERLEAVE, lNodeMask.data(), lNodeMask.size() * lBits, 0U);
+#else
+            static_cast<void>(inPtr);
+            static_cast<void>(inBytes);
+#endif
+        }
+
+        /**
+        * @brief Allocate inNumber elements of inElementSize bytes with inPlacement.
+        */
+        inline void* numa_allocate(
+            std::size_t inNumber,
+            std::size_t inElementSize,
+            NUMAPlacement inPlacement,
+            ThreadPool& inPool)
+        {
+            const auto lBytes = std::max<std::size_t>(inNumber * inElementSize, 1);
+            auto* lPtr = map_pages(lBytes);
+
+            if (inPlacement == NUMAPlacement::Interleaved) {
+                interleave_pages(lPtr, lBytes);
+            }
+            else if (inPlacement == NUMAPlacement::FirstTouch)
+            {
+                const auto lPageSize = get_page_size();
+                auto* lBytePtr = static_cast<char*>(lPtr);
+
+                // touch by element ranges so that the partition matches parallelForStatic(0, inNumber, ...).
+                inPool.parallelForStatic(0, inNumber, [&](std::size_t inFirst, std::size_t inLast)
+                {
+                    const auto lFirstByte = inFirst * inElementSize;
+                    const auto lLastByte  = inLast  * inElementSize;
+
+                    for (auto i = lFirstByte; i < lLastByte; i = (i / lPageSize + 1) * lPageSize) {
+                        lBytePtr[i] = 0;
+                    }
+                });
+            }
+
+            return lPtr;
+        }
+
+    } // detail
+
+    /**
+    * @class numa_allocator
+    *
+    * @brief
+    * STL allocator which places pages by NUMAPlacement.
+    * Memory is obtained directly from the OS in pages, so this allocator suits large arrays.
+    * With NUMAPlacement::FirstTouch, allocate(n) touches the pages by inPool.parallelForStatic(0, n, ...),
+    * and arrays should be processed by parallelForStatic with the same range on the same pool afterwards.
+    * Since the pages are already placed at this time, e.g. the serial value initialization by std::vector does not move them.
+    */
+    template<class T>
+    class numa_allocator
+    {
+    public:
+        using value_type = T;
+
+        template<class U>
+        struct rebind
+        {
+            using other = numa_allocator<U>;
+        };
+
+        explicit numa_allocator(
+            NUMAPlacement inPlacement = NUMAPlacement::Interleaved,
+            ThreadPool& inPool = ThreadPool::getInstance()) noexcept
+            : mPlacement(inPlacement), mPool(&inPool)
+        {}
+
+        template<class U>
+        numa_allocator(const numa_allocator<U>& inOther) noexcept
+            : mPlacement(inOther.getPlacement()), mPool(&inOther.getPool())
+        {}
+
+        T* allocate(std::size_t inNumber)
+        {
+            if (inNumber > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                throw std::bad_alloc();
+            }
+
+            return static_cast<T*>(detail::numa_allocate(inNumber, sizeof(T), mPlacement, *mPool));
+        }
+
+        void deallocate(T* inPtr, std::size_t inNumber) noexcept
+        {
+            detail::unmap_pages(inPtr, std::max<std::size_t>(inNumber * sizeof(T), 1));
+        }
+
+        NUMAPlacement getPlacement() const noexcept
+        {
+            return mPlacement;
+        }
+
+        ThreadPool& getPool() const noexcept
+        {
+            return *mPool;
+        }
+
+    private:
+        NUMAPlacement mPlacement;
+        ThreadPool* mPool;
+    };
+
+    template<class T, class U>
+    bool operator==(const numa_allocator<T>&, const numa_allocator<U>&) noexcept
+    {
+        // any instance can release memory allocated by another one.
+        return true;
+    }
+
+    template<class T, class U>
+    bool operator!=(const numa_allocator<T>& inLhs, const numa_allocator<U>& inRhs) noexcept
+    {
+        return !(inLhs == inRhs);
+    }
+
+} // pml
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef CORE_PERF_COUNTERS_H
+#define CORE_PERF_COUNTERS_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief Hardware performance counters of the calling thread.
+*/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace pml {
+
+    /**
+    * @brief Hardware events measured by PerfCounters.
+    */
+    enum class PerfEvent : std::size_t
+    {
+        Cycles = 0,
+        Instructions,
+        LLCMisses,
+        BranchMisses,
+    };
+
+    /**
+    * @class PerfCounters
+    *
+    * @brief
+    * Cycles, instructions, last level cache misses and branch misses of the calling thread in user space.
+    * On Linux these are read through perf_event_open(2).
+    * Each event is opened separately, and events which cannot be opened,
+    * e.g. by kernel.perf_event_paranoid, containers or virtual machines without PMU, are simply unavailable.
+    * On the other platforms all events are unavailable.
+    * Values are scaled by the running time if the kernel multiplexes the counters.
+    *
+    * @code
+    * pml::PerfCounters lCounters;
+    * lCounters.start();
+    * kernel();
+    * lCounters.stop();
+    * lCounters.outputCounters(std::cout);
+    * @endcode
+    */
+    class PerfCounters final
+    {
+    public:
+        static constexpr std::size_t EVENT_NUMBER = 4;
+
+        PerfCounters() : mFileDescriptors(), mValues()
+        {
+            mFileDescriptors.fill(-1);
+            mValues.fill(0);
+
+#ifdef __linux__
+            constexpr std::array<std::uint64_t, EVENT_NUMBER> lConfigs = {
+                PERF_COUNT_HW_CPU_CYCLES,
+                PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES,
+                PERF_COUNT_HW_BRANCH_MISSES,
+            };
+
+            for (std::size_t i = 0; i < EVENT_NUMBER; ++i)
+            {
+                perf_event_attr lAttribute;
+                std::memset(&lAttribute, 0, sizeof(lAttribute));
+                lAttribute.size           = sizeof(lAttribute);
+                lAttribute.type           = PERF_TYPE_HARDWARE;
+                lAttribute.config         = lConfigs[i];
+                lAttribute.disabled       = 1;
+                lAttribute.exclude_kernel = 1;
+                lAttribute.exclude_hv     = 1;
+                lAttribute.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                mFileDescriptors[i] = static_cast<int>(syscall(SYS_perf_event_open, &lAttribute, 0, -1, -1, 0));
+            }
+#endif
+        }
+
+        PerfCounters(const PerfCounters&)            = delete;
+        PerfCounters(PerfCounters&&)                 = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+        PerfCounters& operator=(PerfCounters&&)      = delete;
+
+        ~PerfCounters()
+        {
+#ifdef __linux__
+            for (const auto fd_i : mFileDescriptors)
+            {
+                if (fd_i >= 0) {
+                    close(fd_i);
+                }
+            }
+#endif
+        }
+
+        /**
+        * @brief Whether inEvent can be measured.
+        */
+        bool isAvailable(PerfEvent inEvent) const noexcept
+        {
+            return (mFileDescriptors[static_cast<std::size_t>(inEvent)] >= 0);
+        }
+
+        /**
+        * @brief Whether any event can be measured.
+        */
+        bool isAvailable() const noexcept
+        {
+            for (const auto fd_i : mFileDescriptors)
+            {
+                if (fd_i >= 0) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+        * @brief Reset and start counting.
+        */
+        void start() noexcept
+        {
+            mValues.fill(0);
+
+#ifdef __linux__
+            for (const auto fd_i : mFileDescriptors)
+            {
+                if (fd_i >= 0)
+                {
+                    ioctl(fd_i, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd_i, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+
+        /**
+        * @brief Stop counting and read the values.
+        */
+        void stop() noexcept
+        {
+#ifdef __linux__
+            for (std::size_t i = 0; i < EVENT_NUMBER; ++i)
+            {
+                if (mFileDescriptors[i] < 0) {
+                    continue;
+                }
+
+                ioctl(mFileDescriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+
+                // value, time enabled, time running.
+                std::uint64_t lBuffer[3] = { 0, 0, 0 };
+                if (read(mFileDescriptors[i], lBuffer, sizeof(lBuffer)) != static_cast<ssize_t>(sizeof(lBuffer))) {
+                    continue;
+                }
+
+                mValues[i] = (lBuffer[2] == 0 || lBuffer[2] == lBuffer[1])
+                    ? lBuffer[0]
+                    : static_cast<std::uint64_t>(static_cast<double>(lBuffer[0]) * static_cast<double>(lBuffer[1]) / static_cast<double>(lBuffer[2]));
+            }
+#endif
+        }
+
+        /**
+        * @brief Value of inEvent between the last start() and stop(), or zero if unavailable.
+        */
+        std::uint64_t getValue(PerfEvent inEvent) const noexcept
+        {
+            return mValues[static_cast<std::size_t>(inEvent)];
+        }
+
+        /**
+        * @brief Instructions per cycle, or zero if unavailable.
+        */
+        double getIPC() const noexcept
+        {
+            const auto lCycles = getValue(PerfEvent::Cycles);
+
+            return (lCycles == 0) ? 0.0 : static_cast<double>(getValue(PerfEvent::Instructions)) / static_cast<double>(lCycles);
+        }
+
+        /**
+        * @brief Output the values between the last start() and stop().
+        *
+        * @param[out] outStream
+        * Counters in one line, "n/a" for unavailable events.
+        * They are formatted in a local stream, so the precision and the flags of outStream are kept.
+        */
+        void outputCounters(std::ostream& outStream) const
+        {
+            std::ostringstream lStream;
+
+            const auto lOutput = [&](const char* inName, PerfEvent inEvent)
+            {
+                lStream << inName << ":";
+                if (isAvailable(inEvent)) {
+                    lStream << getValue(inEvent);
+                }
+                else {
+                    lStream << "n/a";
+                }
+            };
+
+            lOutput("cycles", PerfEvent::Cycles);
+            lStream << ", ";
+            lOutput("instructions", PerfEvent::Instructions);
+            lStream << ", IPC:";
+            if (isAvailable(PerfEvent::Cycles) && isAvailable(PerfEvent::Instructions)) {
+                lStream << std::fixed << std::setprecision(2) << getIPC();
+            }
+            else {
+                lStream << "n/a";
+            }
+            lStream << ", ";
+            lOutput("LLC-misses", PerfEvent::LLCMisses);
+            lStream << ", ";
+            lOutput("branch-misses", PerfEvent::BranchMisses);
+
+            outStream << lStream.str();
+        }
+
+    private:
+        std::array<int, EVENT_NUMBER> mFileDescriptors;
+        std::array<std::uint64_t, EVENT_NUMBER> mValues;
+    };
+
+} // pml
+
+#endif
@@ -0,0 +1,372 @@
+#ifndef CORE_PROFILER_H
+#define CORE_PROFILER_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief Low-overhead profiling scopes with thread-local aggregation.
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(PML_PROFILE_USE_STEADY_CLOCK) && (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+#define PML_PROFILE_USE_RDTSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#define PML_PROFILE_CONCAT_IMPL(X, Y) X##Y
+#define PML_PROFILE_CONCAT(X, Y) PML_PROFILE_CONCAT_IMPL(X, Y)
+
+/**
+* @def
+* Macro to measure the time spent in the present scope under the name NAME, a string literal.
+* Calls and elapsed ticks are aggregated per thread and reported by pml::Profiler::outputReport.
+* This macro expands to nothing unless PML_ENABLE_PROFILING is defined.
+* Time stamps are taken by rdtsc on x86 and by std::chrono::steady_clock otherwise or if PML_PROFILE_USE_STEADY_CLOCK is defined.
+*/
+#ifdef PML_ENABLE_PROFILING
+#define PML_PROFILE_SCOPE(NAME)                                                                                 \
+static const pml::detail::ProfileSite PML_PROFILE_CONCAT(lPMLProfileSite_, __LINE__)(NAME);                     \
+const pml::detail::ProfileScope PML_PROFILE_CONCAT(lPMLProfileScope_, __LINE__)(PML_PROFILE_CONCAT(lPMLProfileSite_, __LINE__))
+#else
+#define PML_PROFILE_SCOPE(NAME) static_cast<void>(0)
+#endif
+
+namespace pml {
+
+    namespace detail {
+
+        /**
+        * @brief Current time stamp in ticks of pml::Profiler::getTicksPerSecond().
+        */
+        inline std::uint64_t get_profile_ticks() noexcept
+        {
+#ifdef PML_PROFILE_USE_RDTSC
+            return static_cast<std::uint64_t>(__rdtsc());
+#else
+            return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        class ProfileSite;
+        class ProfileScope;
+
+    } // detail
+
+    /**
+    * @class Profiler
+    *
+    * @brief
+    * Registry of profiling sites created by PML_PROFILE_SCOPE.
+    * Each thread accumulates calls and ticks of each site in its own counters without synchronization,
+    * and outputReport() merges the counters of the living threads and those of the finished threads on demand.
+    */
+    class Profiler final
+    {
+    public:
+
+        /**
+        * @brief Maximum number of distinct PML_PROFILE_SCOPE sites. Further sites are not measured.
+        */
+        static constexpr std::size_t MAX_SITE_NUMBER = 512;
+
+        /**
+        * @brief Aggregated result of one name.
+        */
+        struct Entry final
+        {
+            std::string mName;
+            std::uint64_t mCallNumber;
+            double mSeconds;
+        };
+
+        /**
+        * @brief Merge counters of all threads by site names, sorted by the total time in descending order.
+        */
+        static std::vector<Entry> getEntries()
+        {
+            auto& lRegistry = getRegistry();
+            std::lock_guard<std::mutex> lLock(lRegistry.mMutex);
+
+            std::vector<Counter> lTotals(lRegistry.mRetired.begin(), lRegistry.mRetired.end());
+            for (const auto* thread_i : lRegistry.mThreads)
+            {
+                for (std::size_t i = 0; i < lRegistry.mNames.size(); ++i)
+                {
+                    lTotals[i].mCallNumber += thread_i->mCounters[i].mCallNumber.load(std::memory_order_relaxed);
+                    lTotals[i].mTicks      += thread_i->mCounters[i].mTicks.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::map<std::string, std::pair<std::uint64_t, std::uint64_t>> lByNames;
+            for (std::size_t i = 0; i < lRegistry.mNames.size(); ++i)
+            {
+                auto& lEntry = lByNames[lRegistry.mNames[i]];
+                lEntry.first  += lTotals[i].mCallNumber;
+                lEntry.second += lTotals[i].mTicks;
+            }
+
+            const auto lTicksPerSecond = getTicksPerSecond();
+
+            std::vector<Entry> lEntries;
+            for (const auto& name_i : lByNames)
+            {
+                if (name_i.second.first > 0) {
+                    lEntries.push_back(Entry{ name_i.first, name_i.second.first, static_cast<double>(name_i.second.second) / lTicksPerSecond });
+                }
+            }
+
+            std::stable_sort(lEntries.begin(), lEntries.end(), [](const Entry& inLhs, const Entry& inRhs) {
+                return inLhs.mSeconds > inRhs.mSeconds;
+            });
+
+            return lEntries;
+        }
+
+        /**
+        * @brief Output the aggregated profile of all threads.
+        *
+        * @param[out] outStream
+        * Names, calls, total time and average time of profiling sites.
+        * They are formatted in a local stream, so the precision and the flags of outStream are kept.
+        */
+        static void outputReport(std::ostream& outStream)
+        {
+            std::ostringstream lStream;
+            lStream << "Profile Report" << std::endl;
+
+            const auto lEntries = getEntries();
+
+            std::size_t lWidth = 4;
+            for (const auto& entry_i : lEntries) {
+                lWidth = std::max(lWidth, entry_i.mName.size());
+            }
+
+            lStream << std::left << std::setw(static_cast<int>(lWidth)) << "Name"
+                << std::right << std::setw(14) << "Calls"
+                << std::setw(14) << "Total[msec]"
+                << std::setw(14) << "Avg.[nsec]" << std::endl;
+
+            for (const auto& entry_i : lEntries)
+            {
+                lStream << std::left << std::setw(static_cast<int>(lWidth)) << entry_i.mName
+                    << std::right << std::setw(14) << entry_i.mCallNumber
+                    << std::setw(14) << std::fixed << std::setprecision(3) << entry_i.mSeconds * 1.0e3
+                    << std::setw(14) << std::fixed << std::setprecision(1) << entry_i.mSeconds * 1.0e9 / static_cast<double>(entry_i.mCallNumber)
+                    << std::endl;
+            }
+
+            outStream << lStream.str();
+        }
+
+        /**
+        * @brief Clear counters of all threads.
+        *        Scopes running concurrently in other threads may be partially lost.
+        */
+        static void reset()
+        {
+            auto& lRegistry = getRegistry();
+            std::lock_guard<std::mutex> lLock(lRegistry.mMutex);
+
+            for (auto& counter_i : lRegistry.mRetired)
+            {
+                counter_i.mCallNumber = 0;
+                counter_i.mTicks = 0;
+            }
+
+            for (auto* thread_i : lRegistry.mThreads)
+            {
+                for (auto& counter_i : thread_i->mCounters)
+                {
+                    counter_i.mCallNumber.store(0, std::memory_order_relaxed);
+                    counter_i.mTicks.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+        * @brief Frequency of time stamps, calibrated against std::chrono::steady_clock at the first call if rdtsc is used.
+        */
+        static double getTicksPerSecond()
+        {
+#ifdef PML_PROFILE_USE_RDTSC
+            static const double lTicksPerSecond = []()
+            {
+                const auto lStartTime  = std::chrono::steady_clock::now();
+                const auto lStartTicks = detail::get_profile_ticks();
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                const auto lEndTicks = detail::get_profile_ticks();
+                const auto lEndTime  = std::chrono::steady_clock::now();
+
+                return static_cast<double>(lEndTicks - lStartTicks) / std::chrono::duration<double>(lEndTime - lStartTime).count();
+            }();
+
+            return lTicksPerSecond;
+#else
+            using period = std::chrono::steady_clock::period;
+            return static_cast<double>(period::den) / static_cast<double>(period::num);
+#endif
+        }
+
+    private:
+
+        friend class detail::ProfileSite;
+        friend class detail::ProfileScope;
+
+        struct AtomicCounter final
+        {
+            // written only by the owner thread, read by reports.
+            std::atomic<std::uint64_t> mCallNumber{ 0 };
+            std::atomic<std::uint64_t> mTicks{ 0 };
+        };
+
+        struct Counter final
+        {
+            std::uint64_t mCallNumber = 0;
+            std::uint64_t mTicks = 0;
+        };
+
+        struct ThreadCounters;
+
+        struct Registry final
+        {
+            std::mutex mMutex;
+            std::vector<std::string> mNames;
+            std::vector<ThreadCounters*> mThreads;
+            std::array<Counter, MAX_SITE_NUMBER> mRetired{};
+        };
+
+        struct ThreadCounters final
+        {
+            std::array<AtomicCounter, MAX_SITE_NUMBER> mCounters;
+
+            ThreadCounters()
+            {
+                auto& lRegistry = getRegistry();
+                std::lock_guard<std::mutex> lLock(lRegistry.mMutex);
+                lRegistry.mThreads.push_back(this);
+            }
+
+            ThreadCounters(const ThreadCounters&)            = delete;
+            ThreadCounters(ThreadCounters&&)                 = delete;
+            ThreadCounters& operator=(const ThreadCounters&) = delete;
+            ThreadCounters& operator=(ThreadCounters&&)      = delete;
+
+            ~ThreadCounters()
+            {
+                auto& lRegistry = getRegistry();
+                std::lock_guard<std::mutex> lLock(lRegistry.mMutex);
+
+                for (std::size_t i = 0; i < MAX_SITE_NUMBER; ++i)
+                {
+                    lRegistry.mRetired[i].mCallNumber += mCounters[i].mCallNumber.load(std::memory_order_relaxed);
+                    lRegistry.mRetired[i].mTicks      += mCounters[i].mTicks.load(std::memory_order_relaxed);
+                }
+
+                lRegistry.mThreads.erase(std::find(lRegistry.mThreads.begin(), lRegistry.mThreads.end(), this));
+            }
+        };
+
+        static Registry& getRegistry()
+        {
+            // never destroyed, since thread-local counters may be merged after static destruction.
+            static Registry* lRegistry = new Registry();
+
+            return *lRegistry;
+        }
+
+        static ThreadCounters& getThreadCounters()
+        {
+            static thread_local ThreadCounters lCounters;
+
+            return lCounters;
+        }
+
+        static std::size_t registerSite(const char* inName)
+        {
+            auto& lRegistry = getRegistry();
+            std::lock_guard<std::mutex> lLock(lRegistry.mMutex);
+
+            if (lRegistry.mNames.size() >= MAX_SITE_NUMBER) {
+                return MAX_SITE_NUMBER;
+            }
+
+            lRegistry.mNames.emplace_back(inName);
+
+            return lRegistry.mNames.size() - 1;
+        }
+    };
+
+    namespace detail {
+
+        /**
+        * @brief A PML_PROFILE_SCOPE site, which is a static object registered once.
+        */
+        class ProfileSite final
+        {
+        public:
+            explicit ProfileSite(const char* inName)
+                : mIndex(Profiler::registerSite(inName))
+            {}
+
+            std::size_t getIndex() const noexcept
+            {
+                return mIndex;
+            }
+
+        private:
+            std::size_t mIndex;
+        };
+
+        /**
+        * @brief RAII timer of PML_PROFILE_SCOPE which adds the elapsed ticks to the counter of the calling thread.
+        */
+        class ProfileScope final
+        {
+        public:
+            explicit ProfileScope(const ProfileSite& inSite) noexcept
+                : mIndex(inSite.getIndex()), mStart(get_profile_ticks())
+            {}
+
+            ProfileScope(const ProfileScope&)            = delete;
+            ProfileScope(ProfileScope&&)                 = delete;
+            ProfileScope& operator=(const ProfileScope&) = delete;
+            ProfileScope& operator=(ProfileScope&&)      = delete;
+
+            ~ProfileScope()
+            {
+                const auto lElapsed = get_profile_ticks() - mStart;
+
+                if (mIndex < Profiler::MAX_SITE_NUMBER)
+                {
+                    auto& lCounter = Profiler::getThreadCounters().mCounters[mIndex];
+                    lCounter.mCallNumber.store(lCounter.mCallNumber.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    lCounter.mTicks.store(lCounter.mTicks.load(std::memory_order_relaxed) + lElapsed, std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            std::size_t mIndex;
+            std::uint64_t mStart;
+        };
+
+    } // detail
+} // pml
+
+#endif
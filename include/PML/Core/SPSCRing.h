@@ -0,0 +1,205 @@
+#ifndef CORE_SPSC_RING_H
+#define CORE_SPSC_RING_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief Bounded lock-free single-producer/single-consumer ring buffer.
+*/
+
+#include <PML/Core/exception_handler.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace pml {
+
+    /**
+    * @class SPSCRing
+    *
+    * @brief
+    * Bounded ring buffer passing items from one producer thread to one consumer thread.
+    * Items are passed by the acquire/release indices of both ends without locks,
+    * which are placed on separate cache lines.
+    * Only when the ring is full or empty, the waiting thread yields for a while and then sleeps on a condition variable,
+    * which the other thread notifies only if someone is sleeping.
+    */
+    template<class T>
+    class SPSCRing final
+    {
+    public:
+
+        /**
+        * @param[in] inCapacity
+        * The maximum number of items which must be a power of two.
+        */
+        explicit SPSCRing(std::size_t inCapacity)
+            : mSlots(new T[inCapacity]), mMask(inCapacity - 1), mHead(0), mTail(0), mIsClosed(false), mSleepingNumber(0)
+        {
+            if ((inCapacity == 0) || ((inCapacity & (inCapacity - 1)) != 0)) {
+                PML_THROW_WITH_NESTED(std::logic_error, "Capacity must be a power of two.");
+            }
+        }
+
+        SPSCRing(const SPSCRing&)            = delete;
+        SPSCRing(SPSCRing&&)                 = delete;
+        SPSCRing& operator=(const SPSCRing&) = delete;
+        SPSCRing& operator=(SPSCRing&&)      = delete;
+
+        ~SPSCRing() = default;
+
+        std::size_t capacity() const noexcept
+        {
+            return mMask + 1;
+        }
+
+        /**
+        * @brief Push inItem if the ring is not full. Only the producer thread may call this.
+        */
+        bool tryPush(T&& inItem)
+        {
+            const auto lHead = mHead.load(std::memory_order_relaxed);
+            if (lHead - mTail.load(std::memory_order_seq_cst) > mMask) {
+                return false;
+            }
+
+            mSlots[lHead & mMask] = std::move(inItem);
+            mHead.store(lHead + 1, std::memory_order_seq_cst);
+            notify();
+
+            return true;
+        }
+
+        /**
+        * @brief Pop the oldest item into outItem if the ring is not empty. Only the consumer thread may call this.
+        */
+        bool tryPop(T& outItem)
+        {
+            const auto lTail = mTail.load(std::memory_order_relaxed);
+            if (lTail == mHead.load(std::memory_order_seq_cst)) {
+                return false;
+            }
+
+            outItem = std::move(mSlots[lTail & mMask]);
+            mTail.store(lTail + 1, std::memory_order_seq_cst);
+            notify();
+
+            return true;
+        }
+
+        /**
+        * @brief Push inItem, waiting while the ring is full.
+        *
+        * @return False if the ring has been closed, in which case inItem is not pushed.
+        */
+        bool push(T&& inItem)
+        {
+            for (;;)
+            {
+                if (mIsClosed.load(std::memory_order_seq_cst)) {
+                    return false;
+                }
+
+                if (tryPush(std::move(inItem))) {
+                    return true;
+                }
+
+                wait([this]() {
+                    return mIsClosed.load(std::memory_order_seq_cst)
+                        || (mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_seq_cst) <= mMask);
+                });
+            }
+        }
+
+        /**
+        * @brief Pop the oldest item into outItem, waiting while the ring is empty.
+        *
+        * @return False if the ring is closed and empty.
+        */
+        bool pop(T& outItem)
+        {
+            for (;;)
+            {
+                if (tryPop(outItem)) {
+                    return true;
+                }
+
+                // items pushed before close() are still popped.
+                if (mIsClosed.load(std::memory_order_seq_cst)) {
+                    return tryPop(outItem);
+                }
+
+                wait([this]() {
+                    return mIsClosed.load(std::memory_order_seq_cst)
+                        || (mTail.load(std::memory_order_relaxed) != mHead.load(std::memory_order_seq_cst));
+                });
+            }
+        }
+
+        /**
+        * @brief Wake up the waiting thread and make further push() fail. Either thread may call this.
+        */
+        void close()
+        {
+            mIsClosed.store(true, std::memory_order_seq_cst);
+
+            std::lock_guard<std::mutex> lLock(mMutex);
+            mCondition.notify_all();
+        }
+
+        bool isClosed() const noexcept
+        {
+            return mIsClosed.load(std::memory_order_seq_cst);
+        }
+
+    private:
+
+        template<class Predicate>
+        void wait(const Predicate& inIsReady)
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                if (inIsReady()) {
+                    return;
+                }
+
+                std::this_thread::yield();
+            }
+
+            std::unique_lock<std::mutex> lLock(mMutex);
+            mSleepingNumber.fetch_add(1, std::memory_order_seq_cst);
+            mCondition.wait(lLock, inIsReady);
+            mSleepingNumber.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        void notify()
+        {
+            // the sequentially consistent index store above is ordered before this load,
+            // so that a thread going to sleep either sees the new index or is counted here.
+            if (mSleepingNumber.load(std::memory_order_seq_cst) > 0)
+            {
+                std::lock_guard<std::mutex> lLock(mMutex);
+                mCondition.notify_all();
+            }
+        }
+
+        std::unique_ptr<T[]> mSlots;
+        std::size_t mMask;
+
+        alignas(64) std::atomic<std::size_t> mHead;
+        alignas(64) std::atomic<std::size_t> mTail;
+
+        alignas(64) std::atomic<bool> mIsClosed;
+        std::atomic<std::size_t> mSleepingNumber;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+    };
+
+} // pml
+
+#endif
@@ -0,0 +1,917 @@
+#ifndef CORE_THREAD_POOL_H
+#define CORE_THREAD_POOL_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief Work-stealing thread pool shared by all parallel algorithms of PML.
+*/
+
+#include <PML/Core/CPUDispatcher.h>
+#include <PML/Core/exception_handler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace pml {
+
+    namespace detail {
+
+        /**
+        * @class WorkStealingDeque
+        *
+        * @brief
+        * Lock-free Chase-Lev deque of pointers.
+        * Only the owner thread may call push() and pop(), which work on the bottom end.
+        * Any thread may call steal(), which works on the top end.
+        * Old buffers are retained until destruction because thieves may still read them after growth.
+        */
+        template<class T>
+        class WorkStealingDeque final
+        {
+            class Buffer final
+            {
+            public:
+                explicit Buffer(std::int64_t inCapacity)
+                    : mCapacity(inCapacity),
+                    mData(new std::atomic<T*>[static_cast<std::size_t>(inCapacity)])
+                {}
+
+                std::int64_t capacity() const
+                {
+                    return mCapacity;
+                }
+
+                T* get(std::int64_t inIndex) const
+                {
+                    return mData[static_cast<std::size_t>(inIndex & (mCapacity - 1))].load(std::memory_order_relaxed);
+                }
+
+                void put(std::int64_t inIndex, T* inItem)
+                {
+                    mData[static_cast<std::size_t>(inIndex & (mCapacity - 1))].store(inItem, std::memory_order_relaxed);
+                }
+
+            private:
+                std::int64_t mCapacity;
+                std::unique_ptr<std::atomic<T*>[]> mData;
+            };
+
+        public:
+            /**
+            * @param[in] inCapacity
+            * Initial capacity which must be a power of two.
+            */
+            explicit WorkStealingDeque(std::int64_t inCapacity = 256)
+                : mTop(0), mBottom(0), mBuffer(nullptr), mBuffers()
+            {
+                mBuffers.push_back(std::make_unique<Buffer>(inCapacity));
+                mBuffer.store(mBuffers.back().get(), std::memory_order_relaxed);
+            }
+
+            WorkStealingDeque(const WorkStealingDeque&)            = delete;
+            WorkStealingDeque(WorkStealingDeque&&)                 = delete;
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+            WorkStealingDeque& operator=(WorkStealingDeque&&)      = delete;
+
+            ~WorkStealingDeque() = default;
+
+            /**
+            * @brief Push an item on the bottom. Only the owner thread may call this.
+            */
+            void push(T* inItem)
+            {
+                const auto lBottom = mBottom.load(std::memory_order_relaxed);
+                const auto lTop    = mTop.load(std::memory_order_acquire);
+                auto* lBuffer      = mBuffer.load(std::memory_order_relaxed);
+
+                if (lBottom - lTop > lBuffer->capacity() - 1)
+                {
+                    auto lNewBuffer = std::make_unique<Buffer>(2 * lBuffer->capacity());
+                    for (auto i = lTop; i < lBottom; ++i) {
+                        lNewBuffer->put(i, lBuffer->get(i));
+                    }
+
+                    lBuffer = lNewBuffer.get();
+                    mBuffers.push_back(std::move(lNewBuffer));
+                    mBuffer.store(lBuffer, std::memory_order_release);
+                }
+
+                lBuffer->put(lBottom, inItem);
+                mBottom.store(lBottom + 1, std::memory_order_release);
+            }
+
+            /**
+            * @brief Pop an item from the bottom. Only the owner thread may call this.
+            *
+            * @return nullptr if the deque is empty.
+            */
+            T* pop()
+            {
+                const auto lBottom = mBottom.load(std::memory_order_relaxed) - 1;
+                auto* lBuffer = mBuffer.load(std::memory_order_relaxed);
+                mBottom.store(lBottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto lTop = mTop.load(std::memory_order_relaxed);
+
+                if (lTop > lBottom)
+                {
+                    mBottom.store(lBottom + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                T* lItem = lBuffer->get(lBottom);
+
+                if (lTop == lBottom)
+                {
+                    // the last item; race against thieves.
+                    if (!mTop.compare_exchange_strong(lTop, lTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        lItem = nullptr;
+                    }
+
+                    mBottom.store(lBottom + 1, std::memory_order_relaxed);
+                }
+
+                return lItem;
+            }
+
+            /**
+            * @brief Steal an item from the top. Any thread may call this.
+            *
+            * @return nullptr if the deque is empty or the race against other threads is lost.
+            */
+            T* steal()
+            {
+                auto lTop = mTop.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const auto lBottom = mBottom.load(std::memory_order_acquire);
+
+                if (lTop >= lBottom) {
+                    return nullptr;
+                }
+
+                auto* lBuffer = mBuffer.load(std::memory_order_acquire);
+                T* lItem = lBuffer->get(lTop);
+
+                if (!mTop.compare_exchange_strong(lTop, lTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    return nullptr;
+                }
+
+                return lItem;
+            }
+
+            /**
+            * @brief Whether the deque looks empty or not. The result may be stale at once.
+            */
+            bool empty() const
+            {
+                return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+            }
+
+        private:
+            std::atomic<std::int64_t> mTop;
+            char mPadding[64];  // keeps mTop written by thieves and mBottom written by the owner on separate cache lines.
+            std::atomic<std::int64_t> mBottom;
+            std::atomic<Buffer*> mBuffer;
+            std::vector<std::unique_ptr<Buffer>> mBuffers;
+        };
+
+    } // detail
+
+    /**
+    * @class ThreadPool
+    *
+    * @brief
+    * Work-stealing task scheduler.
+    * Each worker owns a lock-free deque of tasks.
+    * A task of parallelFor recursively splits its range in halves until the range is not larger than the grain size,
+    * pushes the right halves on the own deque and processes the left one,
+    * and idle workers steal the largest remaining halves from the top of other deques.
+    * Parallel calls from inside a task are allowed; the calling worker helps to process tasks until its call finishes.
+    * parallelForStatic instead assigns fixed subranges to fixed workers,
+    * which keeps the data of each subrange on the core (and the NUMA node) of its worker across calls.
+    *
+    * PML's parallel algorithms share the single global instance, ThreadPool::getInstance(),
+    * which can be configured once by ThreadPool::configure() before its first use.
+    */
+    class ThreadPool final
+    {
+        struct Job final
+        {
+            void (*mInvoker)(const void*, std::size_t, std::size_t);
+            const void* mFunc;
+            std::size_t mGrainSize;
+            std::atomic<std::size_t> mPendingNumber;
+            std::atomic<bool> mIsFailed;
+            std::exception_ptr mException;
+            bool mIsDone;
+            std::mutex mMutex;
+            std::condition_variable mCondition;
+
+            template<class F>
+            Job(const F& inFunc, std::size_t inGrainSize)
+                : mInvoker([](const void* inF, std::size_t inFirst, std::size_t inLast) { (*static_cast<const F*>(inF))(inFirst, inLast); }),
+                mFunc(std::addressof(inFunc)),
+                mGrainSize(inGrainSize),
+                mPendingNumber(1),
+                mIsFailed(false),
+                mException(),
+                mIsDone(false)
+            {}
+        };
+
+        struct Task final
+        {
+            Job* mJob;
+            std::size_t mBegin;
+            std::size_t mEnd;
+            Task* mNext; // link in a mailbox.
+        };
+
+        struct Worker final
+        {
+            detail::WorkStealingDeque<Task> mDeque;
+            std::thread mThread;
+
+            // tasks which must be processed by this worker, see parallelForStatic.
+            std::mutex mMailboxMutex;
+            Task* mMailboxHead = nullptr;
+            Task* mMailboxTail = nullptr;
+            std::atomic<std::size_t> mMailedNumber{ 0 };
+        };
+
+    public:
+
+        /**
+        * @brief Constructor which launches worker threads.
+        *
+        * @param[in] inThreadNumber
+        * The number of worker threads. If this is zero, the number of CPUDispatcher::getAvailableCores() is used.
+        *
+        * @param[in] inIsPinned
+        * If true, i-th worker is pinned to the logical core CPUDispatcher::getAvailableCores()[i % (the number of available cores)].
+        */
+        explicit ThreadPool(std::size_t inThreadNumber = 0, bool inIsPinned = false)
+            : mWorkers(),
+            mIsPinned(inIsPinned),
+            mIsStopped(false),
+            mEpoch(0),
+            mSleepingNumber(0),
+            mSleepMutex(),
+            mSleepCondition(),
+            mInjectionMutex(),
+            mInjectionQueue(),
+            mInjectedNumber(0)
+        {
+            const auto lThreadNumber = (inThreadNumber == 0) ? CPUDispatcher::getAvailableCores().size() : inThreadNumber;
+
+            for (std::size_t i = 0; i < lThreadNumber; ++i) {
+                mWorkers.push_back(std::make_unique<Worker>());
+            }
+
+            try
+            {
+                for (std::size_t i = 0; i < lThreadNumber; ++i) {
+                    mWorkers[i]->mThread = std::thread([this, i]() { runWorker(i); });
+                }
+            }
+            catch (...)
+            {
+                stopWorkers();
+                PML_THROW_WITH_NESTED(std::runtime_error, "ThreadPool failed to launch worker threads.");
+            }
+        }
+
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool(ThreadPool&&)                 = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool& operator=(ThreadPool&&)      = delete;
+
+        /**
+        * @brief Destructor which joins all worker threads.
+        */
+        ~ThreadPool()
+        {
+            stopWorkers();
+        }
+
+        /**
+        * @brief Configure the global instance. This must be called before the first call of ThreadPool::getInstance().
+        *
+        * @param[in] inThreadNumber
+        * The number of worker threads. Zero means the number of CPUDispatcher::getAvailableCores().
+        *
+        * @param[in] inIsPinned
+        * Whether workers are pinned to the available cores or not.
+        */
+        static void configure(std::size_t inThreadNumber, bool inIsPinned)
+        {
+            auto& lConfig = getGlobalConfig();
+            std::lock_guard<std::mutex> lLock(lConfig.mMutex);
+
+            if (lConfig.mIsCreated) {
+                PML_THROW_WITH_NESTED(std::logic_error, "The global thread pool has already been created.");
+            }
+
+            lConfig.mThreadNumber = inThreadNumber;
+            lConfig.mIsPinned     = inIsPinned;
+        }
+
+        /**
+        * @brief Get the global instance shared by parallel algorithms of PML.
+        */
+        static ThreadPool& getInstance()
+        {
+            static ThreadPool lPool(createGlobalPool());
+
+            return lPool;
+        }
+
+        /**
+        * @brief The number of worker threads.
+        */
+        std::size_t getThreadNumber() const
+        {
+            return mWorkers.size();
+        }
+
+        /**
+        * @brief Whether worker threads are pinned to cores or not.
+        */
+        bool isPinned() const
+        {
+            return mIsPinned;
+        }
+
+        /**
+        * @brief
+        * Call inFunc(first, last) on disjoint subranges [first, last) which cover [inBegin, inEnd) in parallel.
+        * This function returns after all calls finish.
+        * If some calls throw, the remaining subranges are skipped and the first exception is rethrown as nested.
+        *
+        * @param[in] inBegin
+        * Begin of the index range.
+        *
+        * @param[in] inEnd
+        * End of the index range.
+        *
+        * @param[in] inGrainSize
+        * Subranges are not split further if their size is not larger than this.
+        * If this is zero, a size providing several subranges per worker is used.
+        *
+        * @param[in] inFunc
+        * Callable as inFunc(std::size_t first, std::size_t last).
+        */
+        template<class F>
+        void parallelFor(std::size_t inBegin, std::size_t inEnd, std::size_t inGrainSize, const F& inFunc)
+        {
+            PML_CATCH_BEGIN
+
+            if (inEnd <= inBegin) {
+                return;
+            }
+
+            const auto lGrainSize = (inGrainSize == 0) ? getDefaultGrainSize(inEnd - inBegin) : inGrainSize;
+
+            if ((inEnd - inBegin) <= lGrainSize)
+            {
+                inFunc(inBegin, inEnd);
+                return;
+            }
+
+            Job lJob(inFunc, lGrainSize);
+            submitAndWait(lJob, new Task{ &lJob, inBegin, inEnd, nullptr });
+
+            if (lJob.mException) {
+                std::rethrow_exception(lJob.mException);
+            }
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "ThreadPool::parallelFor failed.")
+        }
+
+        /**
+        * @brief
+        * Subrange of [inBegin, inEnd) which parallelForStatic assigns to the inIndex-th worker.
+        * The range is divided into getThreadNumber() consecutive blocks of almost equal size.
+        */
+        std::pair<std::size_t, std::size_t> getStaticRange(std::size_t inBegin, std::size_t inEnd, std::size_t inIndex) const
+        {
+            if (inEnd <= inBegin) {
+                return { inBegin, inBegin };
+            }
+
+            const auto lSize = inEnd - inBegin;
+            const auto lWorkerNumber = mWorkers.size();
+            const auto lQuotient  = lSize / lWorkerNumber;
+            const auto lRemainder = lSize % lWorkerNumber;
+
+            const auto lFirst = inBegin + inIndex * lQuotient + std::min(inIndex, lRemainder);
+
+            return { lFirst, lFirst + lQuotient + ((inIndex < lRemainder) ? 1 : 0) };
+        }
+
+        /**
+        * @brief
+        * Call inFunc(first, last) with getStaticRange(inBegin, inEnd, i) on the i-th worker for all non-empty subranges.
+        * Since the assignment is deterministic, data initialized through this function is touched by the same workers
+        * (and with pinned workers, by the same cores) in later calls with the same range.
+        * Exceptions are handled as parallelFor.
+        *
+        * @param[in] inFunc
+        * Callable as inFunc(std::size_t first, std::size_t last),
+        * or as inFunc(std::size_t index, std::size_t first, std::size_t last) with the index i of the subrange,
+        * e.g. to store a partial result per subrange without searching for it.
+        */
+        template<class F>
+        void parallelForStatic(std::size_t inBegin, std::size_t inEnd, const F& inFunc)
+        {
+            if constexpr (std::is_invocable_v<const F&, std::size_t, std::size_t, std::size_t>)
+            {
+                runStatic(inBegin, inEnd, [&](std::size_t inFirst, std::size_t inLast)
+                {
+                    inFunc(getStaticIndex(inBegin, inEnd, inFirst), inFirst, inLast);
+                });
+            }
+            else {
+                runStatic(inBegin, inEnd, inFunc);
+            }
+        }
+
+        /**
+        * @brief
+        * Parallel reduction.
+        * [inBegin, inEnd) is divided into consecutive chunks of inGrainSize elements,
+        * partial results inMap(first, last) of the chunks are computed in parallel,
+        * and they are folded in the chunk order as inReduce(...inReduce(inReduce(inInit, r_0), r_1)..., r_n).
+        * Thus the result does not depend on the scheduling but only on the grain size.
+        *
+        * @param[in] inGrainSize
+        * Chunk size. If this is zero, a size providing several chunks per worker is used.
+        *
+        * @param[in] inInit
+        * Initial value of the reduction.
+        *
+        * @param[in] inMap
+        * Callable as inMap(std::size_t first, std::size_t last) which returns T.
+        *
+        * @param[in] inReduce
+        * Callable as inReduce(T, T) which returns T.
+        */
+        template<class T, class M, class R>
+        T parallelReduce(
+            std::size_t inBegin,
+            std::size_t inEnd,
+            std::size_t inGrainSize,
+            T inInit,
+            const M& inMap,
+            const R& inReduce)
+        {
+            PML_CATCH_BEGIN
+
+            if (inEnd <= inBegin) {
+                return inInit;
+            }
+
+            const auto lGrainSize   = (inGrainSize == 0) ? getDefaultGrainSize(inEnd - inBegin) : inGrainSize;
+            const auto lChunkNumber = (inEnd - inBegin + lGrainSize - 1) / lGrainSize;
+
+            std::vector<T> lPartials(lChunkNumber, inInit);
+
+            parallelFor(0, lChunkNumber, 1, [&](std::size_t inFirst, std::size_t inLast)
+            {
+                for (auto c = inFirst; c < inLast; ++c)
+                {
+                    const auto lFirst = inBegin + c * lGrainSize;
+                    lPartials[c] = inMap(lFirst, std::min(lFirst + lGrainSize, inEnd));
+                }
+            });
+
+            auto lResult = std::move(inInit);
+            for (auto& partial_i : lPartials) {
+                lResult = inReduce(std::move(lResult), std::move(partial_i));
+            }
+
+            return lResult;
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "ThreadPool::parallelReduce failed.")
+        }
+
+    private:
+
+        struct GlobalConfig final
+        {
+            std::mutex mMutex;
+            std::size_t mThreadNumber = 0;
+            bool mIsPinned = false;
+            bool mIsCreated = false;
+        };
+
+        static GlobalConfig& getGlobalConfig()
+        {
+            static GlobalConfig lConfig;
+
+            return lConfig;
+        }
+
+        struct GlobalArgs final
+        {
+            std::size_t mThreadNumber;
+            bool mIsPinned;
+        };
+
+        static GlobalArgs createGlobalPool()
+        {
+            auto& lConfig = getGlobalConfig();
+            std::lock_guard<std::mutex> lLock(lConfig.mMutex);
+            lConfig.mIsCreated = true;
+
+            return GlobalArgs{ lConfig.mThreadNumber, lConfig.mIsPinned };
+        }
+
+        explicit ThreadPool(const GlobalArgs& inArgs)
+            : ThreadPool(inArgs.mThreadNumber, inArgs.mIsPinned)
+        {}
+
+        /**
+        * @brief The pool and the worker index of the current thread, or nullptr if it is not a worker.
+        */
+        static ThreadPool*& currentPool()
+        {
+            static thread_local ThreadPool* lPool = nullptr;
+
+            return lPool;
+        }
+
+        static std::size_t& currentIndex()
+        {
+            static thread_local std::size_t lIndex = 0;
+
+            return lIndex;
+        }
+
+        std::size_t getDefaultGrainSize(std::size_t inSize) const
+        {
+            return std::max<std::size_t>(1, inSize / (8 * std::max<std::size_t>(1, mWorkers.size())));
+        }
+
+        /**
+        * @brief The index i of the non-empty subrange getStaticRange(inBegin, inEnd, i) which starts at inFirst.
+        */
+        std::size_t getStaticIndex(std::size_t inBegin, std::size_t inEnd, std::size_t inFirst) const noexcept
+        {
+            const auto lSize = inEnd - inBegin;
+            const auto lWorkerNumber = mWorkers.size();
+            const auto lQuotient  = lSize / lWorkerNumber;
+            const auto lRemainder = lSize % lWorkerNumber;
+
+            // the first lRemainder subranges have one more element; the others are not empty only if lQuotient > 0.
+            const auto lOffset = inFirst - inBegin;
+            const auto lLongSize = lRemainder * (lQuotient + 1);
+
+            return (lOffset < lLongSize) ? lOffset / (lQuotient + 1) : lRemainder + (lOffset - lLongSize) / lQuotient;
+        }
+
+        /**
+        * @brief parallelForStatic with inFunc(first, last).
+        */
+        template<class F>
+        void runStatic(std::size_t inBegin, std::size_t inEnd, const F& inFunc)
+        {
+            PML_CATCH_BEGIN
+
+            if (inEnd <= inBegin) {
+                return;
+            }
+
+            const auto lWorkerNumber = mWorkers.size();
+
+            Job lJob(inFunc, std::numeric_limits<std::size_t>::max());
+            std::vector<std::unique_ptr<Task>> lTasks;
+            for (std::size_t i = 0; i < lWorkerNumber; ++i)
+            {
+                const auto lRange = getStaticRange(inBegin, inEnd, i);
+                lTasks.push_back(std::make_unique<Task>(Task{ &lJob, lRange.first, lRange.second, nullptr }));
+            }
+
+            lJob.mPendingNumber.store(lWorkerNumber);
+            for (std::size_t i = 0; i < lWorkerNumber; ++i) {
+                post(i, lTasks[i].release());
+            }
+
+            wait(lJob);
+
+            if (lJob.mException) {
+                std::rethrow_exception(lJob.mException);
+            }
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "ThreadPool::parallelForStatic failed.")
+        }
+
+        static void pinCurrentThread(std::size_t inIndex)
+        {
+            const auto& lCores = CPUDispatcher::getAvailableCores();
+            const auto lCore = lCores[inIndex % lCores.size()];
+
+#ifdef _WIN32
+            if (lCore < 8 * sizeof(DWORD_PTR)) {
+                SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << lCore);
+            }
+#elif defined(__linux__)
+            cpu_set_t lCPUSet;
+            CPU_ZERO(&lCPUSet);
+            CPU_SET(lCore, &lCPUSet);
+            pthread_setaffinity_np(pthread_self(), sizeof(lCPUSet), &lCPUSet);
+#else
+            static_cast<void>(lCore);
+#endif
+        }
+
+        void stopWorkers()
+        {
+            {
+                std::lock_guard<std::mutex> lLock(mSleepMutex);
+                mIsStopped.store(true);
+            }
+            mSleepCondition.notify_all();
+
+            for (auto& worker_i : mWorkers)
+            {
+                if (worker_i->mThread.joinable()) {
+                    worker_i->mThread.join();
+                }
+            }
+        }
+
+        void push(Task* inTask)
+        {
+            if (currentPool() == this) {
+                mWorkers[currentIndex()]->mDeque.push(inTask);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lLock(mInjectionMutex);
+                mInjectionQueue.push_back(inTask);
+                mInjectedNumber.fetch_add(1, std::memory_order_seq_cst);
+            }
+
+            mEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+            if (mSleepingNumber.load(std::memory_order_seq_cst) > 0)
+            {
+                std::lock_guard<std::mutex> lLock(mSleepMutex);
+                mSleepCondition.notify_one();
+            }
+        }
+
+        void post(std::size_t inIndex, Task* inTask) noexcept
+        {
+            auto& lWorker = *mWorkers[inIndex];
+            {
+                std::lock_guard<std::mutex> lLock(lWorker.mMailboxMutex);
+                if (lWorker.mMailboxTail) {
+                    lWorker.mMailboxTail->mNext = inTask;
+                }
+                else {
+                    lWorker.mMailboxHead = inTask;
+                }
+
+                lWorker.mMailboxTail = inTask;
+                lWorker.mMailedNumber.fetch_add(1, std::memory_order_seq_cst);
+            }
+
+            mEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+            if (mSleepingNumber.load(std::memory_order_seq_cst) > 0)
+            {
+                // the specific worker must wake up.
+                std::lock_guard<std::mutex> lLock(mSleepMutex);
+                mSleepCondition.notify_all();
+            }
+        }
+
+        Task* findTask(std::size_t inIndex, bool inIsWorker)
+        {
+            if (inIsWorker && (mWorkers[inIndex]->mMailedNumber.load(std::memory_order_seq_cst) > 0))
+            {
+                auto& lWorker = *mWorkers[inIndex];
+                std::lock_guard<std::mutex> lLock(lWorker.mMailboxMutex);
+                if (auto* lTask = lWorker.mMailboxHead)
+                {
+                    lWorker.mMailboxHead = lTask->mNext;
+                    if (!lWorker.mMailboxHead) {
+                        lWorker.mMailboxTail = nullptr;
+                    }
+
+                    lWorker.mMailedNumber.fetch_sub(1, std::memory_order_seq_cst);
+
+                    return lTask;
+                }
+            }
+
+            if (inIsWorker)
+            {
+                if (auto* lTask = mWorkers[inIndex]->mDeque.pop()) {
+                    return lTask;
+                }
+            }
+
+            if (mInjectedNumber.load(std::memory_order_seq_cst) > 0)
+            {
+                std::lock_guard<std::mutex> lLock(mInjectionMutex);
+                if (!mInjectionQueue.empty())
+                {
+                    auto* lTask = mInjectionQueue.front();
+                    mInjectionQueue.pop_front();
+                    mInjectedNumber.fetch_sub(1, std::memory_order_seq_cst);
+
+                    return lTask;
+                }
+            }
+
+            const auto lWorkerNumber = mWorkers.size();
+            for (std::size_t i = 1; i <= lWorkerNumber; ++i)
+            {
+                const auto lVictim = (inIndex + i) % lWorkerNumber;
+                if (inIsWorker && (lVictim == inIndex)) {
+                    continue;
+                }
+
+                if (auto* lTask = mWorkers[lVictim]->mDeque.steal()) {
+                    return lTask;
+                }
+            }
+
+            return nullptr;
+        }
+
+        void execute(Task* inTask)
+        {
+            auto& lJob = *(inTask->mJob);
+            auto lBegin = inTask->mBegin;
+            auto lEnd   = inTask->mEnd;
+            delete inTask;
+
+            if (!lJob.mIsFailed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    while ((lEnd - lBegin) > lJob.mGrainSize)
+                    {
+                        const auto lMiddle = lBegin + (lEnd - lBegin) / 2;
+                        auto lRight = std::make_unique<Task>(Task{ &lJob, lMiddle, lEnd, nullptr });
+
+                        lJob.mPendingNumber.fetch_add(1, std::memory_order_relaxed);
+                        try {
+                            push(lRight.get());
+                        }
+                        catch (...) {
+                            lJob.mPendingNumber.fetch_sub(1, std::memory_order_relaxed);
+                            throw;
+                        }
+
+                        lRight.release();
+                        lEnd = lMiddle;
+                    }
+
+                    if (lBegin != lEnd) {
+                        lJob.mInvoker(lJob.mFunc, lBegin, lEnd);
+                    }
+                }
+                catch (...)
+                {
+                    bool lExpected = false;
+                    if (lJob.mIsFailed.compare_exchange_strong(lExpected, true)) {
+                        lJob.mException = std::current_exception();
+                    }
+                }
+            }
+
+            if (lJob.mPendingNumber.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::lock_guard<std::mutex> lLock(lJob.mMutex);
+                lJob.mIsDone = true;
+                lJob.mCondition.notify_all();
+            }
+        }
+
+        void submitAndWait(Job& inJob, Task* inRoot)
+        {
+            push(inRoot);
+            wait(inJob);
+        }
+
+        void wait(Job& inJob)
+        {
+            if (currentPool() == this)
+            {
+                // nested call from a worker; help to process tasks instead of blocking.
+                const auto lIndex = currentIndex();
+                while (inJob.mPendingNumber.load(std::memory_order_acquire) > 0)
+                {
+                    if (auto* lTask = findTask(lIndex, true)) {
+                        execute(lTask);
+                    }
+                    else {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            std::unique_lock<std::mutex> lLock(inJob.mMutex);
+            inJob.mCondition.wait(lLock, [&inJob]() { return inJob.mIsDone; });
+        }
+
+        void runWorker(std::size_t inIndex)
+        {
+            currentPool()  = this;
+            currentIndex() = inIndex;
+
+            if (mIsPinned) {
+                pinCurrentThread(inIndex);
+            }
+
+            for (;;)
+            {
+                const auto lEpoch = mEpoch.load(std::memory_order_seq_cst);
+
+                if (auto* lTask = findTask(inIndex, true))
+                {
+                    execute(lTask);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lLock(mSleepMutex);
+                mSleepingNumber.fetch_add(1, std::memory_order_seq_cst);
+                mSleepCondition.wait(lLock, [this, lEpoch]() {
+                    return mIsStopped.load() || (mEpoch.load(std::memory_order_seq_cst) != lEpoch);
+                });
+                mSleepingNumber.fetch_sub(1, std::memory_order_seq_cst);
+
+                if (mIsStopped.load()) {
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+        bool mIsPinned;
+        std::atomic<bool> mIsStopped;
+
+        std::atomic<std::uint64_t> mEpoch;
+        std::atomic<std::size_t> mSleepingNumber;
+        std::mutex mSleepMutex;
+        std::condition_variable mSleepCondition;
+
+        std::mutex mInjectionMutex;
+        std::deque<Task*> mInjectionQueue;
+        std::atomic<std::size_t> mInjectedNumber;
+    };
+
+    /**
+    * @brief ThreadPool::parallelFor on the global instance ThreadPool::getInstance().
+    */
+    template<class F>
+    void parallel_for(std::size_t inBegin, std::size_t inEnd, std::size_t inGrainSize, const F& inFunc)
+    {
+        ThreadPool::getInstance().parallelFor(inBegin, inEnd, inGrainSize, inFunc);
+    }
+
+    /**
+    * @brief ThreadPool::parallelReduce on the global instance ThreadPool::getInstance().
+    */
+    template<class T, class M, class R>
+    T parallel_reduce(
+        std::size_t inBegin,
+        std::size_t inEnd,
+        std::size_t inGrainSize,
+        T inInit,
+        const M& inMap,
+        const R& inReduce)
+    {
+        return ThreadPool::getInstance().parallelReduce(inBegin, inEnd, inGrainSize, std::move(inInit), inMap, inReduce);
+    }
+
+} // pml
+
+#endif
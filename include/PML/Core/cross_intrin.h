@@ -13,6 +13,21 @@
 #include <x86intrin.h>
 #endif
 
+#include <cstdint>
+
+/**
+* @def
+* Attributes enabling instruction sets in one function, which must be called only after the run-time check by CPUDispatcher.
+* GCC and Clang require them to use intrinsics not enabled by compiler options, while MSVC always accepts intrinsics.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+#define PML_TARGET_AVX2_PCLMUL     __attribute__((target("avx2,pclmul")))
+#define PML_TARGET_AVX512BW_PCLMUL __attribute__((target("avx512f,avx512bw,pclmul")))
+#else
+#define PML_TARGET_AVX2_PCLMUL
+#define PML_TARGET_AVX512BW_PCLMUL
+#endif
+
 namespace pml {
 
     /**
@@ -53,6 +68,27 @@ namespace pml {
 
         return yn;
     }
+
+    /**
+    * @brief The number of trailing zero bits of inX, which must not be zero.
+    */
+    inline int count_trailing_zeros(std::uint64_t inX)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long lIndex;
+        _BitScanForward64(&lIndex, inX);
+        return static_cast<int>(lIndex);
+#elif defined(_MSC_VER)
+        unsigned long lIndex;
+        if (_BitScanForward(&lIndex, static_cast<unsigned long>(inX))) {
+            return static_cast<int>(lIndex);
+        }
+        _BitScanForward(&lIndex, static_cast<unsigned long>(inX >> 32));
+        return static_cast<int>(lIndex) + 32;
+#else
+        return __builtin_ctzll(inX);
+#endif
+    }
 } // pml
 
 #endif
\ No newline at end of file
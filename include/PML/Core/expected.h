@@ -0,0 +1,283 @@
+#ifndef CORE_EXPECTED_H
+#define CORE_EXPECTED_H
+
+/**
+* @file public header provided by PML.
+*
+* @brief
+* Result type of the non-throwing APIs, which is a value or a compact error.
+*/
+
+#include <PML/Core/exception_handler.h>
+
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/**
+* @def
+* Macro to make pml::error(CODE, REASON, CONTEXT) with info. of __FILE__ and __LINE__.
+* REASON must be a string literal or another static string, and nothing is formatted until error::message() is called.
+*/
+#define PML_MAKE_ERROR(CODE, REASON, CONTEXT) \
+pml::error(CODE, REASON, CONTEXT, __FILE__, __LINE__)
+
+/**
+* @def
+* Macro to finish a try-brock which returns pml::error converted from the caught exception with MESSAGE.
+* This macro should be used with PML_CATCH_BEGIN in functions returning pml::expected.
+*/
+#define PML_CATCH_END_AND_RETURN_ERROR(MESSAGE) } catch (...) { return pml::error::fromCurrentException(MESSAGE, __FILE__, __LINE__); }
+
+namespace pml {
+
+    /**
+    * @brief Error codes of pml::error.
+    */
+    enum class errc : std::uint8_t
+    {
+        not_open,         // target file or string is not opened.
+        malformed_record, // CSV record violates the grammar.
+        out_of_range,     // index or offset is out of the data.
+        logic_error,      // std::logic_error, e.g. an operation unsupported by the input type.
+        runtime_error,    // std::runtime_error, e.g. a failure of I/O.
+        out_of_memory,    // std::bad_alloc.
+        unknown           // other exceptions.
+    };
+
+    /**
+    * @class error
+    *
+    * @brief
+    * Error of pml::expected, which is copied without allocations.
+    * It holds a code, a static reason, an integral context such as a record number and the place where it is made,
+    * and message() formats them only when it is called.
+    * An error converted from an exception keeps the exception, whose messages are appended by message().
+    */
+    class error final
+    {
+    public:
+        error(errc inCode, const char* inReason, std::uint64_t inContext, const char* inFileName, std::uint32_t inLine) noexcept
+            : mCode(inCode), mLine(inLine), mContext(inContext), mReason(inReason), mFileName(inFileName), mException()
+        {}
+
+        error(const error&)            = default;
+        error(error&&)                 = default;
+        error& operator=(const error&) = default;
+        error& operator=(error&&)      = default;
+
+        errc code() const noexcept
+        {
+            return mCode;
+        }
+
+        /**
+        * @brief Static description of the error.
+        */
+        const char* reason() const noexcept
+        {
+            return mReason;
+        }
+
+        /**
+        * @brief Integral context of the error, e.g. 1-based number of the malformed record, or zero if none.
+        */
+        std::uint64_t context() const noexcept
+        {
+            return mContext;
+        }
+
+        /**
+        * @brief The exception from which this error is converted, or nullptr.
+        */
+        const std::exception_ptr& exception() const noexcept
+        {
+            return mException;
+        }
+
+        /**
+        * @brief Message in the same format as PML_THROW_WITH_NESTED, followed by the messages of the converted exception.
+        */
+        std::string message() const
+        {
+            std::ostringstream lStream;
+            lStream << "l." << mLine << " in " << mFileName << ": " << mReason;
+
+            if (mContext > 0) {
+                lStream << " (" << mContext << ")";
+            }
+
+            if (mException)
+            {
+                lStream << std::endl;
+
+                try {
+                    std::rethrow_exception(mException);
+                }
+                catch (...) {
+                    pml::detail::output_exceptions(lStream);
+                }
+            }
+
+            return lStream.str();
+        }
+
+        /**
+        * @brief Error of the exception being handled, which must be called in a catch-block.
+        */
+        static error fromCurrentException(const char* inReason, const char* inFileName, std::uint32_t inLine) noexcept
+        {
+            error lError(errc::unknown, inReason, 0, inFileName, inLine);
+            lError.mException = std::current_exception();
+
+            try {
+                throw;
+            }
+            catch (const std::bad_alloc&)     { lError.mCode = errc::out_of_memory; }
+            catch (const std::out_of_range&)  { lError.mCode = errc::out_of_range; }
+            catch (const std::logic_error&)   { lError.mCode = errc::logic_error; }
+            catch (const std::runtime_error&) { lError.mCode = errc::runtime_error; }
+            catch (...)                       {}
+
+            return lError;
+        }
+
+    private:
+        errc mCode;
+        std::uint32_t mLine;
+        std::uint64_t mContext;
+        const char* mReason;
+        const char* mFileName;
+        std::exception_ptr mException;
+    };
+
+    /**
+    * @class expected
+    *
+    * @brief
+    * A value of T or pml::error returned by the non-throwing APIs of PML, such as CSVParser::tryReadNextOneRecordView.
+    * Checking has_value() costs a branch, while the throwing APIs pay for formatting messages and unwinding on errors.
+    * value() throws std::runtime_error with error().message() if no value is held, as the throwing APIs do.
+    *
+    * @code
+    * const auto lRecords = pml::CSVParser::tryReadAllRecords("data.csv");
+    * if (!lRecords) {
+    *     std::cerr << lRecords.error().message();
+    * }
+    * @endcode
+    */
+    template<class T>
+    class expected final
+    {
+        static_assert(!std::is_reference_v<T> && !std::is_same_v<std::decay_t<T>, pml::error>, "T must be a value type other than pml::error.");
+
+    public:
+        using value_type = T;
+        using error_type = pml::error;
+
+        expected(const T& inValue)
+            : mData(std::in_place_index<0>, inValue)
+        {}
+
+        expected(T&& inValue) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : mData(std::in_place_index<0>, std::move(inValue))
+        {}
+
+        expected(const pml::error& inError) noexcept
+            : mData(std::in_place_index<1>, inError)
+        {}
+
+        expected(const expected&)            = default;
+        expected(expected&&)                 = default;
+        expected& operator=(const expected&) = default;
+        expected& operator=(expected&&)      = default;
+
+        bool has_value() const noexcept
+        {
+            return (mData.index() == 0);
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return has_value();
+        }
+
+        T& value() &
+        {
+            check();
+            return *std::get_if<0>(&mData);
+        }
+
+        const T& value() const &
+        {
+            check();
+            return *std::get_if<0>(&mData);
+        }
+
+        T&& value() &&
+        {
+            check();
+            return std::move(*std::get_if<0>(&mData));
+        }
+
+        /**
+        * @brief The held value, or inDefault if an error is held.
+        */
+        template<class U>
+        T value_or(U&& inDefault) const &
+        {
+            return has_value() ? *std::get_if<0>(&mData) : static_cast<T>(std::forward<U>(inDefault));
+        }
+
+        /**
+        * @brief The held value, which must exist.
+        */
+        T& operator*() & noexcept
+        {
+            return *std::get_if<0>(&mData);
+        }
+
+        const T& operator*() const & noexcept
+        {
+            return *std::get_if<0>(&mData);
+        }
+
+        T* operator->() noexcept
+        {
+            return std::get_if<0>(&mData);
+        }
+
+        const T* operator->() const noexcept
+        {
+            return std::get_if<0>(&mData);
+        }
+
+        /**
+        * @brief The held error, which must exist.
+        */
+        const pml::error& error() const noexcept
+        {
+            return *std::get_if<1>(&mData);
+        }
+
+    private:
+
+        void check() const
+        {
+            if (!has_value()) {
+                PML_THROW_WITH_NESTED(std::runtime_error, error().message());
+            }
+        }
+
+        std::variant<T, pml::error> mData;
+    };
+
+} // pml
+
+#endif
@@ -9,17 +9,36 @@
 * numeric manipulation implemented by SIMD operations.
 */
 
+#include <PML/Core/AlignedAllocator.h>
 #include <PML/Core/CPUDispatcher.h>
+#include <PML/Core/Profiler.h>
+#include <PML/Core/ThreadPool.h>
 
 #include <type_traits>
 #include <numeric>
+#include <vector>
 
 namespace pml {
 
+    namespace detail {
+
+        /**
+        * @brief Whether data() of Container is always aligned for _mm256_load_pd.
+        */
+        template<class Container>
+        struct is_AVX_aligned : std::false_type
+        {};
+
+        template<std::size_t Alignment>
+        struct is_AVX_aligned<std::vector<double, aligned_allocator<double, Alignment>>> : std::bool_constant<(Alignment % 32 == 0)>
+        {};
+
+    } // detail
+
     /**
     * @brief
     * Accelerated version of std::accumulate by SIMD.
-    * If Allocator is quants::aligned_allocator, _mm256_load_pd is applied in data loading.
+    * If Allocator is pml::aligned_allocator, _mm256_load_pd is applied in data loading.
     * If not, then _mm256_loadu_pd is applied in data loading.
     *
     * @param[in] inA
@@ -34,11 +53,22 @@ namespace pml {
     template<class Container>
     double accumulate_SIMD(const Container& inA, double inVal)
     {
+        PML_PROFILE_SCOPE("pml::accumulate_SIMD");
+
         if (CPUDispatcher::isAVX())
         {
-            return inVal + detail::accumulate_AVX_Impl(
+            if constexpr (detail::is_AVX_aligned<Container>::value)
+            {
+                return inVal + detail::accumulate_AVX_Impl(
+                    inA.data(), inA.size(),
+                    [](auto* inArray) { return _mm256_load_pd(inArray); });
+            }
+            else
+            {
+                return inVal + detail::accumulate_AVX_Impl(
                     inA.data(), inA.size(),
                     [](auto* inArray) { return _mm256_loadu_pd(inArray); });
+            }
         }
 
         return std::accumulate(inA.cbegin(), inA.cend(), inVal);
@@ -47,6 +77,7 @@ namespace pml {
     /**
     * @brief
     * Accelerated version of std::inner_product by automatically selected optimal SIMD.
+    * As accumulate_SIMD, _mm256_load_pd is applied if Allocator is pml::aligned_allocator.
     *
     * @param[in] inA
     * 1st array as std::vector.
@@ -63,11 +94,22 @@ namespace pml {
         const Container& inB,
         double inVal)
     {
+        PML_PROFILE_SCOPE("pml::inner_product_SIMD");
+
         if (CPUDispatcher::isAVX())
         {
-            return inVal + detail::inner_product_AVX_Impl(
-                inA.data(), inB.data(), inA.size(),
-                [](auto* inArray) { return _mm256_loadu_pd(inArray); });
+            if constexpr (detail::is_AVX_aligned<Container>::value)
+            {
+                return inVal + detail::inner_product_AVX_Impl(
+                    inA.data(), inB.data(), inA.size(),
+                    [](auto* inArray) { return _mm256_load_pd(inArray); });
+            }
+            else
+            {
+                return inVal + detail::inner_product_AVX_Impl(
+                    inA.data(), inB.data(), inA.size(),
+                    [](auto* inArray) { return _mm256_loadu_pd(inArray); });
+            }
         }
 
         return std::inner_product(inA.cbegin(), inA.cend(), inB.cbegin(), inVal);
@@ -159,6 +201,53 @@ namespace pml {
         }
 
     } // detail
+
+    /**
+    * @brief
+    * Parallel version of accumulate_SIMD.
+    * The array is divided into the blocks of ThreadPool::parallelForStatic,
+    * so the elements allocated by pml::numa_allocator with NUMAPlacement::FirstTouch on the same pool are read from the local NUMA node.
+    * Partial sums of the blocks are added in the block order.
+    *
+    * @param[in] inA
+    * Array of std::vector to sum.
+    *
+    * @param[in] inVal
+    * Initial value of the sum.
+    *
+    * @param[in] inPool
+    * Thread pool which processes the blocks.
+    *
+    * @return
+    * Sum of the all elements of the input array.
+    */
+    template<class Container>
+    double accumulate_SIMD_parallel(const Container& inA, double inVal, ThreadPool& inPool = ThreadPool::getInstance())
+    {
+        PML_PROFILE_SCOPE("pml::accumulate_SIMD_parallel");
+
+        const auto lBlockNumber = inPool.getThreadNumber();
+        std::vector<double> lPartialSums(lBlockNumber, 0.0);
+
+        inPool.parallelForStatic(0, inA.size(), [&](std::size_t inBlock, std::size_t inFirst, std::size_t inLast)
+        {
+            if (CPUDispatcher::isAVX())
+            {
+                lPartialSums[inBlock] = detail::accumulate_AVX_Impl(
+                    inA.data() + inFirst, inLast - inFirst,
+                    [](auto* inArray) { return _mm256_loadu_pd(inArray); });
+            }
+            else {
+                lPartialSums[inBlock] = std::accumulate(inA.data() + inFirst, inA.data() + inLast, 0.0);
+            }
+        });
+
+        for (const auto sum_i : lPartialSums) {
+            inVal += sum_i;
+        }
+
+        return inVal;
+    }
 } // pml
 
 #endif
\ No newline at end of file
@@ -0,0 +1,354 @@
+#ifndef UTILITY_CSV_COLUMNAR_TABLE_H
+#define UTILITY_CSV_COLUMNAR_TABLE_H
+
+/**
+* @file
+* public header provided by PML.
+*
+* @brief
+* Typed columnar loading of CSV data.
+*/
+
+#include <PML/Core/AlignedAllocator.h>
+#include <PML/Core/exception_handler.h>
+#include <PML/Core/Profiler.h>
+#include <PML/Utility/CSVParser.h>
+
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace pml {
+
+    /**
+    * @brief Value types of columns of CSVColumnarTable.
+    */
+    enum class CSVColumnType
+    {
+        Double, // double.
+        Int64,  // std::int64_t.
+        String, // std::string.
+        Date,   // std::int32_t of days since 1970-01-01, given as YYYY-MM-DD.
+    };
+
+    /**
+    * @class CSVColumnarTable
+    *
+    * @brief
+    * CSV data converted column by column into typed vectors by a schema.
+    * Fields are read as views of the input by CSVParser::readNextOneRecordView and converted in place by std::from_chars,
+    * so that no std::string is created for numeric fields.
+    * Numeric columns are pml::aligned_vector, which can be passed to accumulate_SIMD and inner_product_SIMD directly.
+    * Spaces and tabs around numeric fields are ignored, and an empty Double field is NaN.
+    * Blank lines are skipped, except in a schema of one column, where a blank line is an empty field of a record.
+    */
+    class CSVColumnarTable final
+    {
+    public:
+
+        using DoubleColumn = aligned_vector<double>;
+        using Int64Column  = aligned_vector<std::int64_t>;
+        using StringColumn = std::vector<std::string>;
+        using DateColumn   = aligned_vector<std::int32_t>;
+
+        /**
+        * @brief Read a CSV file mapped by CSVParser::InputType::MMAP.
+        *
+        * @param[in] inFilePath
+        * The path to the target CSV file.
+        *
+        * @param[in] inSchema
+        * Type of each column. Every record must have the same number of fields.
+        *
+        * @param[in] inHasHeader
+        * Whether the first record is column names or not.
+        */
+        CSVColumnarTable(const std::string& inFilePath, const std::vector<CSVColumnType>& inSchema, bool inHasHeader)
+            : mSchema(inSchema)
+        {
+            PML_CATCH_BEGIN
+
+            CSVParser lParser(CSVParser::InputType::MMAP, inFilePath);
+            if (!lParser.isOpen()) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "File " + inFilePath + " cannot be opened.");
+            }
+
+            load(lParser, inHasHeader);
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVColumnarTable construction failed.")
+        }
+
+        /**
+        * @brief Read the remaining records of inoutParser.
+        */
+        CSVColumnarTable(CSVParser& inoutParser, const std::vector<CSVColumnType>& inSchema, bool inHasHeader)
+            : mSchema(inSchema)
+        {
+            PML_CATCH_BEGIN
+
+            load(inoutParser, inHasHeader);
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVColumnarTable construction failed.")
+        }
+
+        CSVColumnarTable(const CSVColumnarTable&)            = delete;
+        CSVColumnarTable(CSVColumnarTable&&)                 = default;
+        CSVColumnarTable& operator=(const CSVColumnarTable&) = delete;
+        CSVColumnarTable& operator=(CSVColumnarTable&&)      = default;
+
+        std::size_t getRowNumber() const noexcept
+        {
+            return mRowNumber;
+        }
+
+        std::size_t getColumnNumber() const noexcept
+        {
+            return mSchema.size();
+        }
+
+        CSVColumnType getType(std::size_t inColumn) const
+        {
+            return mSchema.at(inColumn);
+        }
+
+        /**
+        * @brief Column names given by the header, or empty if there is no header.
+        */
+        const std::vector<std::string>& getNames() const noexcept
+        {
+            return mNames;
+        }
+
+        /**
+        * @brief The column named inName in the header.
+        */
+        std::size_t getColumnIndex(const std::string& inName) const
+        {
+            for (std::size_t i = 0; i < mNames.size(); ++i)
+            {
+                if (mNames[i] == inName) {
+                    return i;
+                }
+            }
+
+            PML_THROW_WITH_NESTED(std::logic_error, "Column " + inName + " does not exist.");
+        }
+
+        const DoubleColumn& getDoubles(std::size_t inColumn) const
+        {
+            return getColumn<DoubleColumn>(inColumn, CSVColumnType::Double);
+        }
+
+        const Int64Column& getInt64s(std::size_t inColumn) const
+        {
+            return getColumn<Int64Column>(inColumn, CSVColumnType::Int64);
+        }
+
+        const StringColumn& getStrings(std::size_t inColumn) const
+        {
+            return getColumn<StringColumn>(inColumn, CSVColumnType::String);
+        }
+
+        const DateColumn& getDates(std::size_t inColumn) const
+        {
+            return getColumn<DateColumn>(inColumn, CSVColumnType::Date);
+        }
+
+        /**
+        * @brief Days since 1970-01-01 of the proleptic Gregorian calendar.
+        */
+        static constexpr std::int32_t getDays(std::int32_t inYear, unsigned inMonth, unsigned inDay) noexcept
+        {
+            // H. Hinnant, days_from_civil.
+            const auto lYear  = inYear - ((inMonth <= 2) ? 1 : 0);
+            const auto lEra   = ((lYear >= 0) ? lYear : lYear - 399) / 400;
+            const auto lYoE   = static_cast<unsigned>(lYear - lEra * 400);
+            const auto lDoY   = (153 * ((inMonth > 2) ? (inMonth - 3) : (inMonth + 9)) + 2) / 5 + inDay - 1;
+            const auto lDoE   = lYoE * 365 + lYoE / 4 - lYoE / 100 + lDoY;
+
+            return lEra * 146097 + static_cast<std::int32_t>(lDoE) - 719468;
+        }
+
+    private:
+
+        using Column = std::variant<DoubleColumn, Int64Column, StringColumn, DateColumn>;
+
+        template<class C>
+        const C& getColumn(std::size_t inColumn, CSVColumnType inType) const
+        {
+            if (getType(inColumn) != inType) {
+                PML_THROW_WITH_NESTED(std::logic_error, "Column " + std::to_string(inColumn) + " has another type.");
+            }
+
+            return std::get<C>(mColumns[inColumn]);
+        }
+
+        void load(CSVParser& inoutParser, bool inHasHeader)
+        {
+            PML_PROFILE_SCOPE("pml::CSVColumnarTable::load");
+
+            for (const auto type_i : mSchema)
+            {
+                switch (type_i)
+                {
+                case CSVColumnType::Double:
+                    mColumns.emplace_back(DoubleColumn());
+                    break;
+                case CSVColumnType::Int64:
+                    mColumns.emplace_back(Int64Column());
+                    break;
+                case CSVColumnType::String:
+                    mColumns.emplace_back(StringColumn());
+                    break;
+                case CSVColumnType::Date:
+                    mColumns.emplace_back(DateColumn());
+                    break;
+                default:
+                    PML_THROW_WITH_NESTED(std::logic_error, "Undefined type is specified.");
+                }
+            }
+
+            std::vector<std::string_view> lFields;
+
+            if (inHasHeader && inoutParser.readNextOneRecordView(lFields)) {
+                mNames.assign(lFields.cbegin(), lFields.cend());
+            }
+
+            while (inoutParser.readNextOneRecordView(lFields))
+            {
+                // a blank line cannot be a record of several columns.
+                if ((lFields.size() == 1) && lFields.front().empty() && (mSchema.size() > 1)) {
+                    continue;
+                }
+
+                if (lFields.size() != mSchema.size())
+                {
+                    PML_THROW_WITH_NESTED(std::runtime_error,
+                        "Record " + std::to_string(inoutParser.getLineNumber()) + " has " + std::to_string(lFields.size())
+                        + " fields, but the schema has " + std::to_string(mSchema.size()) + ".");
+                }
+
+                for (std::size_t i = 0; i < lFields.size(); ++i)
+                {
+                    if (!append(mColumns[i], lFields[i]))
+                    {
+                        PML_THROW_WITH_NESTED(std::runtime_error,
+                            "Field \"" + std::string(lFields[i]) + "\" of column " + std::to_string(i)
+                            + " in record " + std::to_string(inoutParser.getLineNumber()) + " cannot be converted.");
+                    }
+                }
+
+                ++mRowNumber;
+            }
+        }
+
+        static std::string_view trim(std::string_view inField) noexcept
+        {
+            while (!inField.empty() && ((inField.front() == ' ') || (inField.front() == '\t'))) {
+                inField.remove_prefix(1);
+            }
+
+            while (!inField.empty() && ((inField.back() == ' ') || (inField.back() == '\t'))) {
+                inField.remove_suffix(1);
+            }
+
+            // std::from_chars does not accept the plus sign, which must be followed by the number itself.
+            if ((inField.size() > 1) && (inField.front() == '+') && ((inField[1] == '.') || ((inField[1] >= '0') && (inField[1] <= '9')))) {
+                inField.remove_prefix(1);
+            }
+
+            return inField;
+        }
+
+        /**
+        * @brief Convert the whole of inField into outValue.
+        */
+        template<class T>
+        static bool convert(std::string_view inField, T& outValue) noexcept
+        {
+            const auto lLast = inField.data() + inField.size();
+            const auto lResult = std::from_chars(inField.data(), lLast, outValue);
+
+            return (lResult.ec == std::errc()) && (lResult.ptr == lLast);
+        }
+
+        static bool convertDate(std::string_view inField, std::int32_t& outDays) noexcept
+        {
+            std::int32_t lYear = 0;
+            unsigned lMonth = 0;
+            unsigned lDay = 0;
+
+            if ((inField.size() != 10) || (inField[4] != '-') || (inField[7] != '-')
+                || !convert(inField.substr(0, 4), lYear) || !convert(inField.substr(5, 2), lMonth) || !convert(inField.substr(8, 2), lDay)) {
+                return false;
+            }
+
+            constexpr unsigned lLastDays[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+            if ((lMonth < 1) || (lMonth > 12) || (lDay < 1) || (lDay > lLastDays[lMonth - 1])) {
+                return false;
+            }
+
+            const auto lIsLeap = ((lYear % 4 == 0) && (lYear % 100 != 0)) || (lYear % 400 == 0);
+            if ((lMonth == 2) && (lDay == 29) && !lIsLeap) {
+                return false;
+            }
+
+            outDays = getDays(lYear, lMonth, lDay);
+
+            return true;
+        }
+
+        static bool append(Column& inoutColumn, std::string_view inField)
+        {
+            switch (inoutColumn.index())
+            {
+            case 0:
+            {
+                const auto lField = trim(inField);
+                auto lValue = std::numeric_limits<double>::quiet_NaN();
+                if (!lField.empty() && !convert(lField, lValue)) {
+                    return false;
+                }
+
+                std::get<DoubleColumn>(inoutColumn).push_back(lValue);
+                return true;
+            }
+            case 1:
+            {
+                std::int64_t lValue = 0;
+                if (!convert(trim(inField), lValue)) {
+                    return false;
+                }
+
+                std::get<Int64Column>(inoutColumn).push_back(lValue);
+                return true;
+            }
+            case 2:
+                std::get<StringColumn>(inoutColumn).emplace_back(inField);
+                return true;
+            default:
+            {
+                std::int32_t lValue = 0;
+                if (!convertDate(trim(inField), lValue)) {
+                    return false;
+                }
+
+                std::get<DateColumn>(inoutColumn).push_back(lValue);
+                return true;
+            }
+            }
+        }
+
+        std::vector<CSVColumnType> mSchema;
+        std::vector<Column> mColumns;
+        std::vector<std::string> mNames;
+        std::size_t mRowNumber = 0;
+    };
+
+} // pml
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef UTILITY_CSV_DECOMPRESSOR_H
+#define UTILITY_CSV_DECOMPRESSOR_H
+
+/**
+* @file
+* public header provided by PML.
+*
+* @brief
+* Streaming decompressors of compressed CSV files.
+* gzip is available if PML_ENABLE_ZLIB is defined, and zstd if PML_ENABLE_ZSTD is defined,
+* which are set by the CMake options of the same names.
+*/
+
+#include <PML/Core/exception_handler.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef PML_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef PML_ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace pml {
+    namespace detail {
+
+        /**
+        * @class CSVDecompressor
+        *
+        * @brief
+        * Decompressor reading compressed data from a file and writing the decompressed bytes to given buffers.
+        * The file is owned by the caller.
+        */
+        class CSVDecompressor
+        {
+        public:
+            CSVDecompressor() = default;
+
+            CSVDecompressor(const CSVDecompressor&)            = delete;
+            CSVDecompressor(CSVDecompressor&&)                 = delete;
+            CSVDecompressor& operator=(const CSVDecompressor&) = delete;
+            CSVDecompressor& operator=(CSVDecompressor&&)      = delete;
+
+            virtual ~CSVDecompressor() = default;
+
+            /**
+            * @brief
+            * Decompress at most inSize bytes into outData.
+            * Less than inSize bytes are written only at the end of the data.
+            *
+            * @return The number of written bytes, which is zero at the end of the data.
+            */
+            virtual std::size_t read(char* outData, std::size_t inSize) = 0;
+
+            /**
+            * @brief
+            * Decompressor of inFile chosen by its magic number, or nullptr if inFile is not compressed.
+            * inFile is rewound to its beginning.
+            *
+            * @param[in] inInputSize
+            * Bytes of each read of compressed data.
+            */
+            static std::unique_ptr<CSVDecompressor> create(std::FILE* inFile, std::size_t inInputSize);
+        };
+
+#ifdef PML_ENABLE_ZLIB
+
+        /**
+        * @brief Decompressor of gzip files, which may consist of several concatenated members.
+        */
+        class GzipDecompressor final : public CSVDecompressor
+        {
+        public:
+            GzipDecompressor(std::FILE* inFile, std::size_t inInputSize)
+                : mFile(inFile), mInput(inInputSize), mStream(), mIsInMember(false), mIsEnd(false)
+            {
+                // 32 detects the gzip or zlib header automatically.
+                if (inflateInit2(&mStream, 15 + 32) != Z_OK) {
+                    PML_THROW_WITH_NESTED(std::runtime_error, "zlib cannot be initialized.");
+                }
+            }
+
+            virtual ~GzipDecompressor() override
+            {
+                inflateEnd(&mStream);
+            }
+
+            virtual std::size_t read(char* outData, std::size_t inSize) override
+            {
+                mStream.next_out  = reinterpret_cast<Bytef*>(outData);
+                mStream.avail_out = static_cast<uInt>(inSize);
+
+                while ((mStream.avail_out > 0) && !mIsEnd)
+                {
+                    if (mStream.avail_in == 0)
+                    {
+                        const auto lSize = std::fread(mInput.data(), 1, mInput.size(), mFile);
+                        if (lSize == 0)
+                        {
+                            if (std::ferror(mFile) != 0) {
+                                PML_THROW_WITH_NESTED(std::runtime_error, "File cannot be read.");
+                            }
+
+                            if (mIsInMember) {
+                                PML_THROW_WITH_NESTED(std::runtime_error, "gzip data is truncated.");
+                            }
+
+                            mIsEnd = true;
+                            break;
+                        }
+
+                        mStream.next_in  = reinterpret_cast<Bytef*>(mInput.data());
+                        mStream.avail_in = static_cast<uInt>(lSize);
+                    }
+
+                    mIsInMember = true;
+
+                    const auto lResult = inflate(&mStream, Z_NO_FLUSH);
+                    if (lResult == Z_STREAM_END)
+                    {
+                        // the next member may follow.
+                        mIsInMember = false;
+                        inflateReset(&mStream);
+                    }
+                    else if (lResult != Z_OK) {
+                        PML_THROW_WITH_NESTED(std::runtime_error, std::string("gzip data is broken: ") + (mStream.msg ? mStream.msg : "unknown error") + ".");
+                    }
+                }
+
+                return inSize - mStream.avail_out;
+            }
+
+        private:
+            std::FILE* mFile;
+            std::vector<char> mInput;
+            z_stream mStream;
+            bool mIsInMember;
+            bool mIsEnd;
+        };
+
+#endif
+
+#ifdef PML_ENABLE_ZSTD
+
+        /**
+        * @brief Decompressor of zstd files, which may consist of several concatenated frames.
+        */
+        class ZstdDecompressor final : public CSVDecompressor
+        {
+        public:
+            ZstdDecompressor(std::FILE* inFile, std::size_t inInputSize)
+                : mFile(inFile), mInput(std::max(inInputSize, ZSTD_DStreamInSize())), mInBuffer{ nullptr, 0, 0 },
+                mStream(ZSTD_createDStream()), mLastResult(0), mIsInputEnd(false)
+            {
+                if (!mStream || ZSTD_isError(ZSTD_initDStream(mStream))) {
+                    ZSTD_freeDStream(mStream);
+                    PML_THROW_WITH_NESTED(std::runtime_error, "zstd cannot be initialized.");
+                }
+
+                mInBuffer.src = mInput.data();
+            }
+
+            virtual ~ZstdDecompressor() override
+            {
+                ZSTD_freeDStream(mStream);
+            }
+
+            virtual std::size_t read(char* outData, std::size_t inSize) override
+            {
+                ZSTD_outBuffer lOutBuffer{ outData, inSize, 0 };
+
+                while (lOutBuffer.pos < lOutBuffer.size)
+                {
+                    if ((mInBuffer.pos == mInBuffer.size) && !mIsInputEnd)
+                    {
+                        const auto lSize = std::fread(mInput.data(), 1, mInput.size(), mFile);
+                        if (lSize == 0)
+                        {
+                            if (std::ferror(mFile) != 0) {
+                                PML_THROW_WITH_NESTED(std::runtime_error, "File cannot be read.");
+                            }
+
+                            mIsInputEnd = true;
+                        }
+                        else
+                        {
+                            mInBuffer.size = lSize;
+                            mInBuffer.pos  = 0;
+                        }
+                    }
+
+                    // after the end of the file, decoded bytes held in the stream are flushed by empty inputs.
+                    const auto lPosition = lOutBuffer.pos;
+                    const auto lResult = ZSTD_decompressStream(mStream, &lOutBuffer, &mInBuffer);
+                    if (ZSTD_isError(lResult)) {
+                        PML_THROW_WITH_NESTED(std::runtime_error, std::string("zstd data is broken: ") + ZSTD_getErrorName(lResult) + ".");
+                    }
+
+                    if (mIsInputEnd && (lOutBuffer.pos == lPosition))
+                    {
+                        // a non-zero hint of the last progress means that the present frame is not finished.
+                        // The hint without progress is the header size of a next frame and is ignored.
+                        if (mLastResult != 0) {
+                            PML_THROW_WITH_NESTED(std::runtime_error, "zstd data is truncated.");
+                        }
+
+                        break;
+                    }
+
+                    mLastResult = lResult;
+                }
+
+                return lOutBuffer.pos;
+            }
+
+        private:
+            std::FILE* mFile;
+            std::vector<char> mInput;
+            ZSTD_inBuffer mInBuffer;
+            ZSTD_DStream* mStream;
+            std::size_t mLastResult;
+            bool mIsInputEnd;
+        };
+
+#endif
+
+        inline std::unique_ptr<CSVDecompressor> CSVDecompressor::create(std::FILE* inFile, std::size_t inInputSize)
+        {
+            unsigned char lMagic[4] = { 0, 0, 0, 0 };
+            const auto lSize = std::fread(lMagic, 1, sizeof(lMagic), inFile);
+
+            if (std::fseek(inFile, 0, SEEK_SET) != 0) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "File cannot be rewound.");
+            }
+
+            if ((lSize >= 2) && (lMagic[0] == 0x1F) && (lMagic[1] == 0x8B))
+            {
+#ifdef PML_ENABLE_ZLIB
+                return std::make_unique<GzipDecompressor>(inFile, inInputSize);
+#else
+                PML_THROW_WITH_NESTED(std::runtime_error, "gzip input requires PML_ENABLE_ZLIB.");
+#endif
+            }
+
+            if ((lSize == 4) && (lMagic[0] == 0x28) && (lMagic[1] == 0xB5) && (lMagic[2] == 0x2F) && (lMagic[3] == 0xFD))
+            {
+#ifdef PML_ENABLE_ZSTD
+                return std::make_unique<ZstdDecompressor>(inFile, inInputSize);
+#else
+                PML_THROW_WITH_NESTED(std::runtime_error, "zstd input requires PML_ENABLE_ZSTD.");
+#endif
+            }
+
+            static_cast<void>(inInputSize);
+            return nullptr;
+        }
+
+    } // detail
+} // pml
+
+#endif
@@ -10,10 +10,33 @@
 */
 
 #include <PML/Core/exception_handler.h>
-
+#include <PML/Core/expected.h>
+#include <PML/Core/MappedFile.h>
+#include <PML/Core/Profiler.h>
+#include <PML/Core/SPSCRing.h>
+#include <PML/Core/ThreadPool.h>
+#include <PML/Utility/CSVDecompressor.h>
+#include <PML/Utility/CSVRecord.h>
+#include <PML/Utility/CSVRecordIndex.h>
+#include <PML/Utility/CSVStructuralIndex.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <thread>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 
@@ -21,8 +44,73 @@
 #include <locale>
 #endif
 
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
 namespace pml{
 
+    /**
+    * @brief Malformed record skipped by CSVParser in the error-tolerant mode.
+    */
+    struct CSVParseError final
+    {
+        std::size_t mLineNumber; // 1-based number of the record, which is getLineNumber() just after it.
+        std::size_t mColumn;     // 0-based index of the field where the error is found.
+        const char* mReason;     // static description of the error.
+    };
+
+    /**
+    * @brief
+    * Dialect of CSV data given to the constructor of CSVParser, which specializes the parser at compile time.
+    * Delimiter separates fields, and fields enclosed by Quote may contain it, Quote escaped as two Quote and newlines.
+    * If IsTrimmed is true, spaces and tabs outside quotations are ignored unless they are the delimiter.
+    * If CommentPrefix is not the null character, records beginning with it are skipped without being counted by getLineNumber.
+    * A comment line is not quoted, and Quote in it is an ordinary character also for ASYNC_FILE and FOLLOW_FILE,
+    * which find the boundaries of records by scanning quotations and comment lines.
+    * If HasHeader is true, the first record is read by the constructor, see CSVParser::getHeader.
+    *
+    * @code
+    * using SemicolonDialect = pml::BasicCSVDialect<';', '\'', true, '#'>;
+    * pml::CSVParser lParser(pml::CSVParser::InputType::MMAP, "data.csv", 0, SemicolonDialect());
+    * @endcode
+    */
+    template<char Delimiter, char Quote = '\"', bool IsTrimmed = true, char CommentPrefix = '\0', bool HasHeader = false>
+    struct BasicCSVDialect final
+    {
+        static_assert((Delimiter != Quote), "Delimiter and quotation must be different.");
+        static_assert((Delimiter != '\0') && (Delimiter != '\r') && (Delimiter != '\n'), "Delimiter must not be null nor a newline.");
+        static_assert((Quote != '\0') && (Quote != '\r') && (Quote != '\n'), "Quotation must not be null nor a newline.");
+        static_assert((CommentPrefix != Quote) && (CommentPrefix != '\r') && (CommentPrefix != '\n'), "Comment prefix must not be a quotation nor a newline.");
+
+        static constexpr char DELIMITER      = Delimiter;
+        static constexpr char QUOTE          = Quote;
+        static constexpr bool IS_TRIMMED     = IsTrimmed;
+        static constexpr char COMMENT_PREFIX = CommentPrefix;
+        static constexpr bool HAS_HEADER     = HasHeader;
+    };
+
+    /**
+    * @brief The default dialect of CSVParser described in its documentation.
+    */
+    using CSVDialect = BasicCSVDialect<','>;
+
+    /**
+    * @brief Tab-separated values, where tabs are never trimmed.
+    */
+    using TSVDialect = BasicCSVDialect<'\t'>;
+
+    /**
+    * @brief Pipe-separated values.
+    */
+    using PSVDialect = BasicCSVDialect<'|'>;
+
     /**
     * @class CSVParser
     *
@@ -39,13 +127,16 @@ namespace pml{
     *     If the field is not enclosed by double quotations, then it is not permitted that the filed contains double quotations " itself.
     *     If the field is enclosed by double quotations, then it is permitted by escaping with one further double quotation as "".
     *  5. Spaces and tubs outside double quotations are ignored when the field is enclosed by them.
+    * Other dialects such as TSV, comment lines and headers are selected by the constructor, see BasicCSVDialect.
     */
     class CSVParser final
     {
     public:
 
         /**
-        * @brief Read CSV file.
+        * @brief
+        * Read CSV file.
+        * A non-empty regular file is parsed by MMAP, and the others such as pipes and files of procfs are read by FILE.
         *
         * @param[in] inFilePath
         * The path to the target CSV file.
@@ -58,9 +149,11 @@ namespace pml{
         {
             PML_CATCH_BEGIN
 
+            PML_PROFILE_SCOPE("pml::CSVParser::readAllRecords");
+
             std::vector<std::vector<std::string>> lOutBuffer;
 
-            CSVParser lParser(CSVParser::InputType::FILE, inFilePath);
+            CSVParser lParser(getFileInputType(inFilePath), inFilePath);
 
             while (!lParser.isEnd())
             {
@@ -75,6 +168,237 @@ namespace pml{
             PML_CATCH_END_AND_THROW(std::runtime_error, "CSVParser::readAllRecords failed.")
         }
 
+        /**
+        * @brief
+        * Non-throwing readAllRecords.
+        * A file which cannot be opened is errc::not_open, and the first malformed record is errc::malformed_record.
+        */
+        static expected<std::vector<std::vector<std::string>>> tryReadAllRecords(const std::string& inFilePath) noexcept
+        {
+            PML_CATCH_BEGIN
+
+            PML_PROFILE_SCOPE("pml::CSVParser::tryReadAllRecords");
+
+            CSVParser lParser(getFileInputType(inFilePath), inFilePath);
+            if (!lParser.isOpen()) {
+                return PML_MAKE_ERROR(errc::not_open, "File cannot be opened.", 0);
+            }
+
+            CSVParseError lFailure{ 0, 0, nullptr };
+            const FailureScope lScope(*lParser.mParser, lFailure);
+
+            std::vector<std::vector<std::string>> lOutBuffer;
+
+            while (!lParser.isEnd())
+            {
+                auto lRecord = lParser.readNextOneRecord();
+                if (lFailure.mReason) {
+                    return PML_MAKE_ERROR(errc::malformed_record, lFailure.mReason, lFailure.mLineNumber);
+                }
+
+                lRecord.shrink_to_fit();
+                lOutBuffer.push_back(std::move(lRecord));
+            }
+
+            return lOutBuffer;
+
+            PML_CATCH_END_AND_RETURN_ERROR("CSVParser::tryReadAllRecords failed.")
+        }
+
+        /**
+        * @brief
+        * Read CSV file in parallel. The result is same as readAllRecords.
+        * The mapped file is divided into chunks and the quotation state at the beginning of each chunk
+        * is resolved by the parity of double quotations in the preceding chunks.
+        * Each chunk is then shifted to the first record boundary and parsed by inPool,
+        * and the records are concatenated in the original order.
+        * If a record is invalid, the first one in the file is reported with its record number.
+        *
+        * @param[in] inFilePath
+        * The path to the target CSV file.
+        *
+        * @param[in] inPool
+        * Thread pool parsing chunks.
+        *
+        * @param[in] inChunkSize
+        * Bytes of each chunk. If this is zero, several chunks per worker and at least 1 MiB each are used.
+        *
+        * @return
+        * All fields of the PML data.
+        * outBuffer[i][j] contains j-th field in i-th record.
+        */
+        static std::vector<std::vector<std::string>> readAllRecordsParallel(
+            const std::string& inFilePath,
+            ThreadPool& inPool = ThreadPool::getInstance(),
+            std::size_t inChunkSize = 0)
+        {
+            PML_CATCH_BEGIN
+
+            PML_PROFILE_SCOPE("pml::CSVParser::readAllRecordsParallel");
+
+            // files which cannot be mapped are not opened twice, so that pipes are read only once.
+            if (getFileInputType(inFilePath) != InputType::MMAP) {
+                return readAllRecords(inFilePath);
+            }
+
+            const MappedFile lFile(inFilePath, MappedFile::AccessHint::Sequential);
+
+            const auto lChunkSize = (inChunkSize > 0)
+                ? inChunkSize
+                : std::max<std::size_t>(std::size_t(1) << 20, lFile.size() / (4 * inPool.getThreadNumber()) + 1);
+            const auto lChunkNumber = (lFile.size() + lChunkSize - 1) / lChunkSize;
+
+            if (lChunkNumber <= 1) {
+                return readAllRecords(inFilePath);
+            }
+
+            const auto lChunkBegin = [&](std::size_t inChunk)
+            {
+                return lFile.begin() + std::min(inChunk * lChunkSize, lFile.size());
+            };
+
+            // 1st pass: parity of double quotations in each chunk.
+            std::vector<unsigned char> lIsInQuotes(lChunkNumber + 1, 0);
+            inPool.parallelFor(0, lChunkNumber, 1, [&](std::size_t inFirst, std::size_t inLast)
+            {
+                for (auto i = inFirst; i < inLast; ++i) {
+                    lIsInQuotes[i + 1] = static_cast<unsigned char>(std::count(lChunkBegin(i), lChunkBegin(i + 1), '\"') & 1);
+                }
+            });
+
+            for (std::size_t i = 1; i <= lChunkNumber; ++i) {
+                lIsInQuotes[i] ^= lIsInQuotes[i - 1];
+            }
+
+            // 2nd pass: parse records starting in each chunk.
+            std::vector<Chunk> lChunks(lChunkNumber);
+            inPool.parallelFor(0, lChunkNumber, 1, [&](std::size_t inFirst, std::size_t inLast)
+            {
+                for (auto i = inFirst; i < inLast; ++i)
+                {
+                    const auto lFirst = (i == 0) ? lFile.begin() : findRecordBoundary(lChunkBegin(i), lFile.end(), lIsInQuotes[i] != 0);
+                    const auto lLast  = findRecordBoundary(lChunkBegin(i + 1), lFile.end(), lIsInQuotes[i + 1] != 0);
+
+                    parseChunk(lFirst, lLast, lChunks[i]);
+                }
+            });
+
+            std::size_t lRecordNumber = 0;
+            for (auto& chunk_i : lChunks)
+            {
+                if (chunk_i.mException)
+                {
+                    try {
+                        std::rethrow_exception(chunk_i.mException);
+                    }
+                    catch (...) {
+                        PML_THROW_WITH_NESTED(
+                            std::runtime_error, "Record " + std::to_string(lRecordNumber + chunk_i.mRecords.size() + 1) + " is invalid.");
+                    }
+                }
+
+                lRecordNumber += chunk_i.mRecords.size();
+            }
+
+            std::vector<std::vector<std::string>> lOutBuffer;
+            lOutBuffer.reserve(lRecordNumber);
+
+            for (auto& chunk_i : lChunks) {
+                std::move(chunk_i.mRecords.begin(), chunk_i.mRecords.end(), std::back_inserter(lOutBuffer));
+            }
+
+            return lOutBuffer;
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVParser::readAllRecordsParallel failed.")
+        }
+
+        /**
+        * @brief
+        * Read the records [inFirst, inLast) of CSV file in parallel by the offsets of inIndex.
+        * The records are divided evenly into chunks at the indexed boundaries,
+        * so that neither the quotation state nor the record boundaries are searched again.
+        *
+        * @param[in] inFilePath
+        * The path to the target CSV file.
+        *
+        * @param[in] inIndex
+        * Index of the present contents of inFilePath.
+        *
+        * @param[in] inFirst
+        * The first record to be read.
+        *
+        * @param[in] inLast
+        * The next of the last record to be read, which must not exceed inIndex.size().
+        *
+        * @param[in] inPool
+        * Thread pool parsing chunks.
+        *
+        * @return
+        * outBuffer[i][j] contains j-th field in (inFirst + i)-th record.
+        */
+        static std::vector<std::vector<std::string>> readRecordsParallel(
+            const std::string& inFilePath,
+            const CSVRecordIndex& inIndex,
+            std::size_t inFirst,
+            std::size_t inLast,
+            ThreadPool& inPool = ThreadPool::getInstance())
+        {
+            PML_CATCH_BEGIN
+
+            PML_PROFILE_SCOPE("pml::CSVParser::readRecordsParallel");
+
+            if ((inFirst > inLast) || (inLast > inIndex.size())) {
+                PML_THROW_WITH_NESTED(std::out_of_range, "Records are out of the index.");
+            }
+
+            const MappedFile lFile(inFilePath, MappedFile::AccessHint::Random);
+            if (!lFile.isOpen() || (lFile.size() != inIndex.getDataSize())) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "File " + inFilePath + " cannot be opened or is not the indexed data.");
+            }
+
+            const auto lRecordNumber = inLast - inFirst;
+            const auto lChunkNumber = std::max<std::size_t>(1, std::min(lRecordNumber, 4 * inPool.getThreadNumber()));
+            const auto lChunkBegin = [&](std::size_t inChunk)
+            {
+                return inFirst + lRecordNumber * inChunk / lChunkNumber;
+            };
+
+            std::vector<Chunk> lChunks(lChunkNumber);
+            inPool.parallelFor(0, lChunkNumber, 1, [&](std::size_t inChunkFirst, std::size_t inChunkLast)
+            {
+                for (auto i = inChunkFirst; i < inChunkLast; ++i)
+                {
+                    parseChunk(
+                        lFile.begin() + inIndex.getOffset(lChunkBegin(i)),
+                        lFile.begin() + inIndex.getOffset(lChunkBegin(i + 1)),
+                        lChunks[i]);
+                }
+            });
+
+            std::vector<std::vector<std::string>> lOutBuffer;
+            lOutBuffer.reserve(lRecordNumber);
+
+            for (std::size_t i = 0; i < lChunkNumber; ++i)
+            {
+                if (lChunks[i].mException)
+                {
+                    try {
+                        std::rethrow_exception(lChunks[i].mException);
+                    }
+                    catch (...) {
+                        PML_THROW_WITH_NESTED(
+                            std::runtime_error, "Record " + std::to_string(lChunkBegin(i) + lChunks[i].mRecords.size() + 1) + " is invalid.");
+                    }
+                }
+
+                std::move(lChunks[i].mRecords.begin(), lChunks[i].mRecords.end(), std::back_inserter(lOutBuffer));
+            }
+
+            return lOutBuffer;
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVParser::readRecordsParallel failed.")
+        }
+
         /**
         * @brief
         * Read table in CSV format.
@@ -102,56 +426,85 @@ namespace pml{
         {
             PML_CATCH_BEGIN
 
-            Map<std::string, std::vector<std::string>> lTable;
+            PML_PROFILE_SCOPE("pml::CSVParser::readTable");
 
-            CSVParser lParser(CSVParser::InputType::FILE, inFilePath);
+            CSVParser lParser(getFileInputType(inFilePath), inFilePath);
+
+            return readTable<Map>(lParser, inIsColumnKey);
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVParser::readTable failed.")
+        }
+
+        /**
+        * @brief
+        * Read table in CSV format only with the columns inColumns, see setProjection.
+        * Unselected fields are skipped without copies.
+        * If inIsColumnKey is true, the first column is always read as keys and inColumns selects the values,
+        * so that inColumns must not contain 0.
+        * If inIsColumnKey is false, inColumns selects the keys in the first row and their values.
+        *
+        * @param[in] inColumns
+        * Zero-based indices of the columns in the resulted order.
+        */
+        template<template <class...> class Map = std::unordered_map>
+        static Map<std::string, std::vector<std::string>> readTable(
+            const std::string& inFilePath,
+            bool inIsColumnKey,
+            const std::vector<std::size_t>& inColumns)
+        {
+            PML_CATCH_BEGIN
+
+            PML_PROFILE_SCOPE("pml::CSVParser::readTable");
+
+            CSVParser lParser(getFileInputType(inFilePath), inFilePath);
 
             if (inIsColumnKey)
             {
-                while (!lParser.isEnd())
-                {
-                    auto lRecord = lParser.readNextOneRecord();
+                std::vector<std::size_t> lColumns = { 0 };
+                lColumns.insert(lColumns.cend(), inColumns.cbegin(), inColumns.cend());
+                lParser.setProjection(lColumns);
+            }
+            else {
+                lParser.setProjection(inColumns);
+            }
 
-                    if (lRecord.empty()) {
-                        continue;
-                    }
+            return readTable<Map>(lParser, inIsColumnKey);
 
-                    auto lKey = std::move(lRecord[0]);
-                    lRecord.erase(lRecord.cbegin());
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVParser::readTable failed.")
+        }
 
-                    lTable.emplace(std::move(lKey), std::move(lRecord));
-                }
-            }
-            else
-            {
-                auto lKeys = lParser.readNextOneRecord();
-                std::vector<std::vector<std::string>> lVals(lKeys.size());
+        /**
+        * @brief
+        * Read table in CSV format only with the columns whose fields in the first record are inNames.
+        * The first record is also a part of the table as the other overloads.
+        */
+        template<template <class...> class Map = std::unordered_map>
+        static Map<std::string, std::vector<std::string>> readTable(
+            const std::string& inFilePath,
+            bool inIsColumnKey,
+            const std::vector<std::string>& inNames)
+        {
+            PML_CATCH_BEGIN
 
-                for (;;)
-                {
-                    if (lParser.isEnd()) {
-                        break;
-                    }
+            PML_PROFILE_SCOPE("pml::CSVParser::readTable");
 
-                    auto lRecord = lParser.readNextOneRecord();
+            // the file is read once, so that the first record already read is projected here.
+            CSVParser lParser(getFileInputType(inFilePath), inFilePath);
+            const auto lFirstRecord = lParser.readNextOneRecord();
 
-                    if (lRecord.size() != lKeys.size()) {
-                        PML_THROW_WITH_NESTED(std::runtime_error, "Record size is unmatched with the key size.");
-                    }
+            auto lColumns = findColumns(lFirstRecord, inNames);
+            if (inIsColumnKey) {
+                lColumns.insert(lColumns.cbegin(), 0);
+            }
 
-                    for (std::size_t i = 0; i < lRecord.size(); ++i) {
-                        lVals[i].push_back(std::move(lRecord[i]));
-                    }
-                }
+            lParser.setProjection(lColumns);
 
-                for (std::size_t i = 0; i < lKeys.size(); ++i)
-                {
-                    lVals[i].shrink_to_fit();
-                    lTable.emplace(std::move(lKeys[i]), std::move(lVals[i]));
-                }
+            std::vector<std::string> lProjected;
+            for (const auto column_i : lColumns) {
+                lProjected.push_back((column_i < lFirstRecord.size()) ? lFirstRecord[column_i] : std::string());
             }
 
-            return lTable;
+            return readTable<Map>(lParser, inIsColumnKey, &lProjected);
 
             PML_CATCH_END_AND_THROW(std::runtime_error, "CSVParser::readTable failed.")
         }
@@ -164,35 +517,77 @@ namespace pml{
             FILE,
             STRING_REF,
             STRING_COPY,
+            MMAP,
+            ASYNC_FILE,
+            FOLLOW_FILE,
+            COMPRESSED_FILE,
         };
 
         /**
         * @brief Unique constructor of this class.
         *
         * @param[in] inType
-        * Target CSV data type. Following three types are possible;
-        * CSVParser::InputType::FILE, STRING_REF, or STRING_COPY.
+        * Target CSV data type. Following seven types are possible;
+        * CSVParser::InputType::FILE, STRING_REF, STRING_COPY, MMAP, ASYNC_FILE, FOLLOW_FILE or COMPRESSED_FILE.
+        * MMAP maps the file read-only and parses it directly from the mapping without stream buffers,
+        * which is much faster than FILE for large files.
+        * ASYNC_FILE reads the file by a dedicated thread into large buffers passed to the parser through a lock-free ring,
+        * so that disk reads overlap parsing where the file is not in the page cache.
+        * FOLLOW_FILE reads a file growing by appends, see follow.
+        * COMPRESSED_FILE is ASYNC_FILE whose thread also decompresses the file, so that decompression overlaps parsing.
+        * The format is detected by the magic number: gzip needs the CMake option PML_ENABLE_ZLIB and zstd needs PML_ENABLE_ZSTD,
+        * otherwise std::runtime_error is thrown. Uncompressed files are read as ASYNC_FILE.
         *
         * @param[in] inString
-        * If the argument inType is CSVParser::InputType::FILE, inString is interpreted as the path to the target CSV file.
+        * If the argument inType is CSVParser::InputType::FILE, MMAP, ASYNC_FILE, FOLLOW_FILE or COMPRESSED_FILE, inString is interpreted as the path to the target CSV file.
         * If inType is CSVParser::InputType::STRING_REF or STRING_COPY, inString is interpreted as CSV data itself.
+        *
+        * @param[in] inBufferSize
+        * Bytes of each buffer of ASYNC_FILE and COMPRESSED_FILE, or of each read of FOLLOW_FILE. If this is zero, 1 MiB is used. Other types ignore this.
+        *
+        * @param[in] inDialect
+        * Tag of the dialect, see BasicCSVDialect. The parser is instantiated for it, so that it costs nothing at run time.
         */
-        CSVParser(InputType inType, const std::string& inString)
+        template<class Dialect = CSVDialect>
+        CSVParser(InputType inType, const std::string& inString, std::size_t inBufferSize = 0, Dialect inDialect = Dialect())
+            : mHasHeader(Dialect::HAS_HEADER)
         {
+            static_cast<void>(inDialect);
+
             switch (inType)
             {
             case InputType::FILE:
-                mParser = std::make_unique<FileParser>(inString);
+                mParser = std::make_unique<FileParser<Dialect>>(inString);
                 break;
             case InputType::STRING_REF:
-                mParser = std::make_unique<StringParserRef>(inString);
+                mParser = std::make_unique<StringParserRef<Dialect>>(inString);
                 break;
             case InputType::STRING_COPY:
-                mParser = std::make_unique<StringParserCopy>(inString);
+                mParser = std::make_unique<StringParserCopy<Dialect>>(inString);
+                break;
+            case InputType::MMAP:
+                mParser = std::make_unique<MMapParser<Dialect>>(inString);
+                break;
+            case InputType::ASYNC_FILE:
+                mParser = std::make_unique<AsyncFileParser<Dialect>>(inString, (inBufferSize > 0) ? inBufferSize : (std::size_t(1) << 20));
+                break;
+            case InputType::FOLLOW_FILE:
+                mParser = std::make_unique<FollowParser<Dialect>>(inString, (inBufferSize > 0) ? inBufferSize : (std::size_t(1) << 20));
+                break;
+            case InputType::COMPRESSED_FILE:
+                mParser = std::make_unique<AsyncFileParser<Dialect>>(inString, (inBufferSize > 0) ? inBufferSize : (std::size_t(1) << 20), true);
                 break;
             default:
                 PML_THROW_WITH_NESTED(std::logic_error, "Undefined type is specified.");
             }
+
+            if constexpr (Dialect::COMMENT_PREFIX != '\0') {
+                mParser->skipComments();
+            }
+
+            if (mHasHeader && mParser->isOpen() && !mParser->isEnd()) {
+                mHeader = mParser->readNextOneRecord();
+            }
         }
 
         CSVParser(const CSVParser&)              = delete;
@@ -201,7 +596,7 @@ namespace pml{
         CSVParser & operator =(CSVParser&&)      = delete;
 
         /**
-        * @brief Destructor. If the CSV data type is CSVParser::InputType::FILE, the target file is closed here.
+        * @brief Destructor. If the CSV data type is CSVParser::InputType::FILE, MMAP, ASYNC_FILE, FOLLOW_FILE or COMPRESSED_FILE, the target file is closed here.
         */
         ~CSVParser() = default;
 
@@ -220,310 +615,2886 @@ namespace pml{
         }
 
         /**
-        * @brief Target file or string is correctly set or not.
+        * @brief
+        * Read the next one record of CSV data into memory of inResource.
+        * Fields and their temporaries are allocated from inResource instead of the global heap.
+        * For instance, with pml::ArenaResource all memory of a record or a batch of records can be reused as
         *
-        * @return True if target is correctly set.
+        *   auto& lArena = pml::ArenaResource::getThreadLocal();
+        *   while (!lParser.isEnd()) {
+        *       pml::ArenaScope lScope(lArena);
+        *       const auto lRecord = lParser.readNextOneRecord(&lArena);
+        *       ...
+        *   }
+        *
+        * @param[in] inResource
+        * Memory resource of the resulted record.
+        *
+        * @return All Fields of the target one record.
         */
-        bool isOpen() const
+        std::pmr::vector<std::pmr::string> readNextOneRecord(std::pmr::memory_resource* inResource)
         {
-            return mParser->isOpen();
+            return mParser->readNextOneRecord(inResource);
         }
 
         /**
-        * @brief Whether all records are read or not.
+        * @brief
+        * Read the next one record of CSV data into outRecord, whose buffers are reused.
+        * All fields are copied into one character buffer of outRecord instead of a string per field,
+        * so that reading records into the same outRecord allocates nothing in steady state,
+        * and the fields stay valid until outRecord is modified, independently of this parser.
         *
-        * @return True if the next charater is EOF or the tarmination character.
+        * @param[out] outRecord
+        * All Fields of the target one record. outRecord is cleared at the begining of this function.
+        *
+        * @return False if and only if data has already finished, otherwise true.
         */
-        bool isEnd() const
+        bool readNextOneRecord(CSVRecord& outRecord)
         {
-            return mParser->isEnd();
+            return mParser->readNextOneRecord(outRecord);
         }
 
         /**
-        * @brief The number of already read records.
+        * @brief
+        * Read the next one record of CSV data as views without allocations per field.
+        * For STRING_REF, STRING_COPY and MMAP, each view refers to the input buffer directly,
+        * and stays valid while the referenced string (STRING_REF) or this parser (STRING_COPY and MMAP) lives.
+        * Only fields containing escaped double quotations "" are copied into storage owned by this parser,
+        * and such views, as well as all views of FILE, ASYNC_FILE and FOLLOW_FILE, are valid until the next call of this function.
         *
-        * @return The number of already read records.
+        * @param[out] outFields
+        * All Fields of the target one record. outFields is cleared at the begining of this function.
+        *
+        * @return False if and only if data has already finished, otherwise true.
         */
-        std::size_t getLineNumber() const
+        bool readNextOneRecordView(std::vector<std::string_view>& outFields)
         {
-            return mParser->getLineNumber();
+            return mParser->readNextOneRecordView(outFields);
         }
 
-    private:
-
         /**
-        * @brief Pure virtual base class for implementation of the class CSVParser by composit pattern.
+        * @brief
+        * Non-throwing readNextOneRecordView for loops checking errors per record.
+        * A malformed record is returned as errc::malformed_record whose context is its 1-based record number,
+        * without formatting a message nor unwinding, and the next call reads the following record.
+        * In the error-tolerant mode, malformed records are skipped as readNextOneRecordView does.
+        * Other failures such as I/O errors are returned as the errors converted from their exceptions.
+        *
+        * @code
+        * std::vector<std::string_view> lFields;
+        * for (auto lResult = lParser.tryReadNextOneRecordView(lFields); !lResult || *lResult; lResult = lParser.tryReadNextOneRecordView(lFields))
+        * {
+        *     if (!lResult) {
+        *         continue; // lResult.error() is the malformed record.
+        *     }
+        *     ...
+        * }
+        * @endcode
+        *
+        * @return False if and only if data has already finished, true if a record is read, otherwise an error.
         */
-        class ParserBase
+        expected<bool> tryReadNextOneRecordView(std::vector<std::string_view>& outFields) noexcept
         {
-        public:
-            virtual ~ParserBase() = default;
-
-            virtual std::vector<std::string> readNextOneRecord() = 0;
+            return tryRead([&]() { return mParser->readNextOneRecordView(outFields); });
+        }
 
-            virtual bool isEnd() const = 0;
+        /**
+        * @brief Non-throwing readNextOneRecord(CSVRecord&), whose errors are the same as tryReadNextOneRecordView.
+        */
+        expected<bool> tryReadNextOneRecord(CSVRecord& outRecord) noexcept
+        {
+            return tryRead([&]() { return mParser->readNextOneRecord(outRecord); });
+        }
 
-            virtual bool isOpen() const = 0;
+        /**
+        * @brief
+        * Move to the beginning of the inRecord-th record (0-based) by inIndex built from the same data,
+        * after which getLineNumber() returns inRecord.
+        * This is available for STRING_REF, STRING_COPY, MMAP and FOLLOW_FILE, and throws std::logic_error for FILE and ASYNC_FILE.
+        *
+        * @param[in] inIndex
+        * Index of the data of this parser.
+        *
+        * @param[in] inRecord
+        * The record to be read next. inIndex.size() moves to the end.
+        */
+        void seekToRecord(const CSVRecordIndex& inIndex, std::size_t inRecord)
+        {
+            mParser->seek(inIndex.getOffset(inRecord), inRecord);
+            mParser->skipComments();
+        }
+
+        /**
+        * @brief
+        * Move to the byte offset inOffset, which must be the beginning of a record such as a result of getOffset,
+        * after which getLineNumber() returns inLineNumber.
+        * This is available for the same types as seekToRecord.
+        */
+        void seekToOffset(std::uint64_t inOffset, std::size_t inLineNumber = 0)
+        {
+            mParser->seek(inOffset, inLineNumber);
+            mParser->skipComments();
+        }
+
+        /**
+        * @brief
+        * The byte offset of the next record from the beginning of the data.
+        * For FOLLOW_FILE, parsing can be resumed from here by another parser with seekToOffset.
+        * This throws std::logic_error for FILE and ASYNC_FILE.
+        */
+        std::uint64_t getOffset() const
+        {
+            return mParser->getOffset();
+        }
+
+        /**
+        * @brief
+        * Read the bytes appended to the file of FOLLOW_FILE, waiting at most inTimeout until a complete record is appended.
+        * FOLLOW_FILE returns only complete records, which are terminated by newlines outside double quotations,
+        * and keeps the rest of the file as a partial record until its newline is appended.
+        * isEnd() is true while no complete record is available, and reads after this then return the new records.
+        * The file is watched by inotify on Linux, and its size is polled otherwise.
+        * If the file shrinks, it is regarded as rewritten and followed from the beginning with the line number reset.
+        * A file truncated in place keeps its device and inode, so that this is detected only by the size:
+        * if the file grows beyond the read offset again before the next read, the bytes after the offset are read as appended ones.
+        * Such files should be rotated by rename, or truncated only while they are not followed.
+        * If the path comes to refer to another file, e.g. by log rotation with rename and create,
+        * the old file is read to its end and then the new file is followed from the beginning with the line number reset,
+        * where a partial record at the end of the old file is discarded. Windows does not rename open files, so this is POSIX only.
+        *
+        * @code
+        * pml::CSVParser lParser(pml::CSVParser::InputType::FOLLOW_FILE, "feed.csv");
+        * std::vector<std::string_view> lFields;
+        * for (;;) {
+        *     while (lParser.readNextOneRecordView(lFields)) {
+        *         ...
+        *     }
+        *     lParser.follow(std::chrono::seconds(1));
+        * }
+        * @endcode
+        *
+        * @return Whether a record is available or not, where appended comment lines are not records. For the other types, this is !isEnd().
+        */
+        bool follow(std::chrono::milliseconds inTimeout = std::chrono::milliseconds(0))
+        {
+            if (!mParser->follow(inTimeout)) {
+                return false;
+            }
+
+            mParser->skipComments();
+
+            return !mParser->isEnd();
+        }
+
+        /**
+        * @brief
+        * Call inVisitor for each of the remaining records, passing the fields as views as readNextOneRecordView.
+        * One buffer of views is reused over all records, so that no memory is allocated per record in steady state,
+        * and the views are valid only during the call.
+        * If inVisitor returns bool, false stops the iteration after the present record.
+        *
+        * @code
+        * double lSum = 0.0;
+        * lParser.forEachRecord([&](const std::vector<std::string_view>& inFields) {
+        *     lSum += std::stod(std::string(inFields[1]));
+        * });
+        * @endcode
+        *
+        * @param[in] inVisitor
+        * Callable as inVisitor(const std::vector<std::string_view>&), returning void or bool.
+        *
+        * @return The number of visited records.
+        */
+        template<class Visitor>
+        std::size_t forEachRecord(Visitor&& inVisitor)
+        {
+            PML_PROFILE_SCOPE("pml::CSVParser::forEachRecord");
+
+            std::vector<std::string_view> lFields;
+            std::size_t lRecordNumber = 0;
+
+            while (readNextOneRecordView(lFields))
+            {
+                ++lRecordNumber;
+
+                if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, const std::vector<std::string_view>&>, bool>)
+                {
+                    if (!inVisitor(static_cast<const std::vector<std::string_view>&>(lFields))) {
+                        break;
+                    }
+                }
+                else {
+                    inVisitor(static_cast<const std::vector<std::string_view>&>(lFields));
+                }
+            }
+
+            return lRecordNumber;
+        }
+
+        /**
+        * @brief
+        * Select the columns returned by the following reads of records.
+        * Each record then consists of the fields of inColumns in this order,
+        * and fields missing in short records are empty.
+        * Unselected fields are only scanned for the next separator, and neither copied nor unescaped.
+        *
+        * @param[in] inColumns
+        * Zero-based indices of the columns, which must be distinct.
+        */
+        void setProjection(const std::vector<std::size_t>& inColumns)
+        {
+            mParser->setProjection(inColumns);
+        }
+
+        /**
+        * @brief
+        * Select the columns named inNames, see setProjection.
+        * The names are looked up in getHeader() for dialects with headers, and otherwise in the next record read as the header.
+        */
+        void setProjection(const std::vector<std::string>& inNames)
+        {
+            resetProjection();
+            setProjection(findColumns(mHasHeader ? mHeader : readNextOneRecord(), inNames));
+        }
+
+        /**
+        * @brief The first record read by the constructor for dialects with headers, otherwise empty.
+        */
+        const std::vector<std::string>& getHeader() const noexcept
+        {
+            return mHeader;
+        }
+
+        /**
+        * @brief Read all fields again.
+        */
+        void resetProjection()
+        {
+            mParser->resetProjection();
+        }
+
+        /**
+        * @brief Target file or string is correctly set or not.
+        *
+        * @return True if target is correctly set.
+        */
+        bool isOpen() const
+        {
+            return mParser->isOpen();
+        }
+
+        /**
+        * @brief Whether all records are read or not.
+        *
+        * @return True if the next charater is EOF or the tarmination character.
+        */
+        bool isEnd() const
+        {
+            return mParser->isEnd();
+        }
+
+        /**
+        * @brief The number of already read records.
+        *
+        * @return The number of already read records.
+        */
+        std::size_t getLineNumber() const
+        {
+            return mParser->getLineNumber();
+        }
+
+        /**
+        * @brief
+        * Switch the error-tolerant mode. By default, a malformed record throws std::runtime_error after being skipped.
+        * In the error-tolerant mode, malformed records are skipped silently and recorded in getErrors(),
+        * and the reads of records return the next valid one.
+        * Records are resynchronized at the first newline of the field where the error is found,
+        * except that FILE cannot go back and skips a field not closed by a double quotation to the end of data.
+        *
+        * @param[in] inMaxErrorNumber
+        * The number of tolerated errors. The next one throws std::runtime_error.
+        */
+        void setErrorTolerant(bool inIsTolerant, std::size_t inMaxErrorNumber = std::numeric_limits<std::size_t>::max())
+        {
+            mParser->setErrorTolerant(inIsTolerant, inMaxErrorNumber);
+        }
+
+        /**
+        * @brief Malformed records skipped in the error-tolerant mode, in the order of the data.
+        */
+        const std::vector<CSVParseError>& getErrors() const
+        {
+            return mParser->getErrors();
+        }
+
+        void clearErrors()
+        {
+            mParser->clearErrors();
+        }
+
+    private:
+
+        class ParserBase;
+
+        /**
+        * @brief RAII helper making inoutParser return malformed records to outFailure while it lives.
+        */
+        class FailureScope final
+        {
+        public:
+            FailureScope(ParserBase& inoutParser, CSVParseError& outFailure) noexcept
+                : mParser(inoutParser)
+            {
+                mParser.setFailure(&outFailure);
+            }
+
+            FailureScope(const FailureScope&)            = delete;
+            FailureScope(FailureScope&&)                 = delete;
+            FailureScope& operator=(const FailureScope&) = delete;
+            FailureScope& operator=(FailureScope&&)      = delete;
+
+            ~FailureScope()
+            {
+                mParser.setFailure(nullptr);
+            }
+
+        private:
+            ParserBase& mParser;
+        };
+
+        /**
+        * @brief Run inReader() returning bool with malformed records and exceptions returned as errors.
+        */
+        template<class Reader>
+        expected<bool> tryRead(Reader&& inReader) noexcept
+        {
+            PML_CATCH_BEGIN
+
+            if (!isOpen()) {
+                return PML_MAKE_ERROR(errc::not_open, "Target is not opened.", 0);
+            }
+
+            CSVParseError lFailure{ 0, 0, nullptr };
+            const FailureScope lScope(*mParser, lFailure);
+
+            const auto lIsRead = inReader();
+            if (lFailure.mReason) {
+                return PML_MAKE_ERROR(errc::malformed_record, lFailure.mReason, lFailure.mLineNumber);
+            }
+
+            return lIsRead;
+
+            PML_CATCH_END_AND_RETURN_ERROR("CSVParser::tryRead failed.")
+        }
+
+        /**
+        * @brief Table of the records of inoutParser, which are preceded by *inFirstRecord if it is not nullptr.
+        */
+        template<template <class...> class Map>
+        static Map<std::string, std::vector<std::string>> readTable(
+            CSVParser& inoutParser,
+            bool inIsColumnKey,
+            std::vector<std::string>* inFirstRecord = nullptr)
+        {
+            Map<std::string, std::vector<std::string>> lTable;
+
+            if (inIsColumnKey)
+            {
+                while (inFirstRecord || !inoutParser.isEnd())
+                {
+                    auto lRecord = inFirstRecord ? std::move(*inFirstRecord) : inoutParser.readNextOneRecord();
+                    inFirstRecord = nullptr;
+
+                    if (lRecord.empty()) {
+                        continue;
+                    }
+
+                    auto lKey = std::move(lRecord[0]);
+                    lRecord.erase(lRecord.cbegin());
+
+                    lTable.emplace(std::move(lKey), std::move(lRecord));
+                }
+            }
+            else
+            {
+                auto lKeys = inFirstRecord ? std::move(*inFirstRecord) : inoutParser.readNextOneRecord();
+                std::vector<std::vector<std::string>> lVals(lKeys.size());
+
+                for (;;)
+                {
+                    if (inoutParser.isEnd()) {
+                        break;
+                    }
+
+                    auto lRecord = inoutParser.readNextOneRecord();
+
+                    if (lRecord.size() != lKeys.size()) {
+                        PML_THROW_WITH_NESTED(std::runtime_error, "Record size is unmatched with the key size.");
+                    }
+
+                    for (std::size_t i = 0; i < lRecord.size(); ++i) {
+                        lVals[i].push_back(std::move(lRecord[i]));
+                    }
+                }
+
+                for (std::size_t i = 0; i < lKeys.size(); ++i)
+                {
+                    lVals[i].shrink_to_fit();
+                    lTable.emplace(std::move(lKeys[i]), std::move(lVals[i]));
+                }
+            }
+
+            return lTable;
+        }
+
+        /**
+        * @brief
+        * MMAP if inFilePath is a non-empty regular file, otherwise FILE.
+        * MappedFile does not map pipes and devices, and files of procfs are empty for stat even if they have contents.
+        * The file is not opened here, so that a pipe is not consumed.
+        */
+        static InputType getFileInputType(const std::string& inFilePath)
+        {
+            std::error_code lError;
+            if (!std::filesystem::is_regular_file(inFilePath, lError) || lError) {
+                return InputType::FILE;
+            }
+
+            const auto lSize = std::filesystem::file_size(inFilePath, lError);
+
+            return (!lError && (lSize > 0)) ? InputType::MMAP : InputType::FILE;
+        }
+
+        /**
+        * @brief Indices of inNames in inHeader.
+        */
+        static std::vector<std::size_t> findColumns(const std::vector<std::string>& inHeader, const std::vector<std::string>& inNames)
+        {
+            std::vector<std::size_t> lColumns;
+
+            for (const auto& name_i : inNames)
+            {
+                const auto lIt = std::find(inHeader.cbegin(), inHeader.cend(), name_i);
+                if (lIt == inHeader.cend()) {
+                    PML_THROW_WITH_NESTED(std::runtime_error, "Column " + name_i + " does not exist in the header.");
+                }
+
+                lColumns.push_back(static_cast<std::size_t>(lIt - inHeader.cbegin()));
+            }
+
+            return lColumns;
+        }
+
+        /**
+        * @brief Records of one chunk of readAllRecordsParallel, or the exception thrown after them.
+        */
+        struct Chunk final
+        {
+            std::vector<std::vector<std::string>> mRecords;
+            std::exception_ptr mException;
+        };
+
+        /**
+        * @brief
+        * The beginning of the first record after inFirst, that is, the next character of the first newline outside double quotations.
+        * A newline character just at inFirst terminates the record before inFirst.
+        *
+        * @param[in] inIsInQuotes
+        * Whether inFirst is inside double quotations.
+        */
+        static const char* findRecordBoundary(const char* inFirst, const char* inLast, bool inIsInQuotes)
+        {
+            for (auto lit = inFirst; lit != inLast; ++lit)
+            {
+                if (*lit == '\"') {
+                    inIsInQuotes = !inIsInQuotes;
+                }
+                else if (!inIsInQuotes && ((*lit == '\r') || (*lit == '\n')))
+                {
+                    // CRLF is a single newline character.
+                    if ((*lit == '\r') && ((lit + 1) != inLast) && (*(lit + 1) == '\n')) {
+                        ++lit;
+                    }
+
+                    return lit + 1;
+                }
+            }
+
+            return inLast;
+        }
+
+        static void parseChunk(const char* inFirst, const char* inLast, Chunk& outChunk)
+        {
+            try
+            {
+                RangeParser<CSVDialect> lParser(inFirst, inLast);
+
+                while (!lParser.isEnd())
+                {
+                    auto lRecord = lParser.readNextOneRecord();
+
+                    lRecord.shrink_to_fit();
+                    outChunk.mRecords.push_back(std::move(lRecord));
+                }
+            }
+            catch (...) {
+                outChunk.mException = std::current_exception();
+            }
+        }
+
+        /**
+        * @brief Pure virtual base class for implementation of the class CSVParser by composit pattern.
+        */
+        class ParserBase
+        {
+        public:
+            virtual ~ParserBase() = default;
+
+            virtual std::vector<std::string> readNextOneRecord() = 0;
+
+            virtual std::pmr::vector<std::pmr::string> readNextOneRecord(std::pmr::memory_resource* inResource) = 0;
+
+            virtual bool readNextOneRecord(CSVRecord& outRecord) = 0;
+
+            virtual bool readNextOneRecordView(std::vector<std::string_view>& outFields) = 0;
+
+            virtual bool isEnd() const = 0;
+
+            virtual bool isOpen() const = 0;
 
             virtual std::size_t getLineNumber() const = 0;
+
+            virtual void setProjection(const std::vector<std::size_t>& inColumns) = 0;
+
+            virtual void resetProjection() = 0;
+
+            virtual void seek(std::uint64_t inOffset, std::size_t inLineNumber) = 0;
+
+            virtual std::uint64_t getOffset() const = 0;
+
+            virtual bool follow(std::chrono::milliseconds inTimeout) = 0;
+
+            virtual void skipComments() = 0;
+
+            virtual void setErrorTolerant(bool inIsTolerant, std::size_t inMaxErrorNumber) = 0;
+
+            virtual const std::vector<CSVParseError>& getErrors() const = 0;
+
+            virtual void clearErrors() = 0;
+
+            virtual void setFailure(CSVParseError* outFailure) = 0;
+        };
+
+        template<class Iterator, class Dialect>
+        class ParserBaseImpl : public ParserBase
+        {
+        protected:
+            using iterator_type = Iterator;
+
+            // characters of the dialect, see BasicCSVDialect.
+            static constexpr char DELIMITER = Dialect::DELIMITER;
+            static constexpr char QUOTE     = Dialect::QUOTE;
+
+            /**
+            * @brief Whether inChar is a space or a tab ignored outside quotations.
+            */
+            static constexpr bool isTrimmable(char inChar) noexcept
+            {
+                return Dialect::IS_TRIMMED && (inChar != DELIMITER) && ((inChar == ' ') || (inChar == '\t'));
+            }
+
+            Iterator mOrigin;
+            Iterator mStart;
+            Iterator mEnd;
+            std::size_t mLineNumber;
+            bool mIsOpen;
+
+            // storage of readNextOneRecordView, reused over records.
+            std::vector<std::string> mOwnedRecord;
+            std::string mOwnedUnQuoted;
+            std::deque<std::string> mOwnedFields;
+
+            // selected columns in ascending order, and swaps arranging them into the order of setProjection.
+            bool mIsProjected = false;
+            std::vector<std::size_t> mProjectedColumns;
+            std::vector<std::pair<std::size_t, std::size_t>> mProjectedSwaps;
+
+            // structural index of contiguous sources, see parseRecordIndexed.
+            using Indexer = detail::CSVStructuralIndexer;
+            Indexer::Kernel mKernel;
+            std::vector<const char*> mStructurals;
+            std::size_t mStructuralCursor;
+            const char* mIndexedEnd;
+            bool mIsIndexedEndInQuotes;
+            bool mIsIndexValid;
+
+            // no double quotation exists in [mQuoteFreeFrom, mEnd) of contiguous sources if this is not nullptr.
+            const char* mQuoteFreeFrom = nullptr;
+
+            // malformed records of the error-tolerant mode.
+            bool mIsErrorTolerant = false;
+            std::size_t mMaxErrorNumber = std::numeric_limits<std::size_t>::max();
+            std::vector<CSVParseError> mErrors;
+
+            // malformed record returned by the non-throwing reads instead of an exception, see setFailure.
+            CSVParseError* mFailure = nullptr;
+
+        public:
+
+            ParserBaseImpl()
+                : mOrigin(), mStart(), mEnd(), mLineNumber(0), mIsOpen(false),
+                mKernel(Indexer::getOptimalKernel()), mStructuralCursor(0), mIndexedEnd(nullptr), mIsIndexedEndInQuotes(false), mIsIndexValid(false)
+            {}
+
+            ParserBaseImpl(Iterator inStart, Iterator inEnd)
+                : mOrigin(inStart), mStart(inStart), mEnd(inEnd), mLineNumber(0), mIsOpen(false),
+                mKernel(Indexer::getOptimalKernel()), mStructuralCursor(0), mIndexedEnd(nullptr), mIsIndexedEndInQuotes(false), mIsIndexValid(false)
+            {}
+
+            virtual ~ParserBaseImpl() override = default;
+
+            virtual std::vector<std::string> readNextOneRecord() override
+            {
+                std::vector<std::string> outBuffer;
+                readRecord(outBuffer);
+
+                return outBuffer;
+            }
+
+            virtual std::pmr::vector<std::pmr::string> readNextOneRecord(std::pmr::memory_resource* inResource) override
+            {
+                std::pmr::vector<std::pmr::string> outBuffer(inResource);
+                readRecord(outBuffer);
+
+                return outBuffer;
+            }
+
+            virtual bool readNextOneRecord(CSVRecord& outRecord) override
+            {
+                outRecord.clear();
+
+                if (isOpen() && isEnd()) {
+                    return false;
+                }
+
+                RecordBuilder lBuilder(outRecord, mOwnedUnQuoted);
+                if (!parseValid(lBuilder)) {
+                    return false;
+                }
+
+                arrangeProjected(outRecord.mFields);
+
+                return true;
+            }
+
+            virtual bool readNextOneRecordView(std::vector<std::string_view>& outFields) override
+            {
+                outFields.clear();
+
+                if (isOpen() && isEnd()) {
+                    return false;
+                }
+
+                if constexpr (std::is_same_v<Iterator, const char*>)
+                {
+                    ViewBuilder lBuilder(outFields, mOwnedFields);
+                    if (!parseValid(lBuilder)) {
+                        return false;
+                    }
+                }
+                else
+                {
+                    // the source is not contiguous, so fields are copied once into reused storage.
+                    std::size_t lFieldNumber = 0;
+                    OwnedBuilder lBuilder(mOwnedRecord, mOwnedUnQuoted, lFieldNumber);
+                    if (!parseValid(lBuilder)) {
+                        return false;
+                    }
+
+                    for (std::size_t i = 0; i < lFieldNumber; ++i) {
+                        outFields.emplace_back(mOwnedRecord[i]);
+                    }
+                }
+
+                arrangeProjected(outFields);
+
+                return true;
+            }
+
+            virtual bool isEnd() const override
+            {
+                return (mStart == mEnd);
+            }
+
+            virtual bool isOpen() const override
+            {
+                return mIsOpen;
+            }
+
+            virtual std::size_t getLineNumber() const override
+            {
+                return mLineNumber;
+            }
+
+            virtual void setProjection(const std::vector<std::size_t>& inColumns) override
+            {
+                auto lColumns = inColumns;
+                std::sort(lColumns.begin(), lColumns.end());
+
+                if (std::adjacent_find(lColumns.cbegin(), lColumns.cend()) != lColumns.cend()) {
+                    PML_THROW_WITH_NESTED(std::logic_error, "Projected columns must be distinct.");
+                }
+
+                // fields are parsed in ascending order, and swapped into the order of inColumns.
+                std::vector<std::size_t> lArranged = lColumns;
+                mProjectedSwaps.clear();
+
+                for (std::size_t i = 0; i < inColumns.size(); ++i)
+                {
+                    const auto lIt = std::find(lArranged.begin() + static_cast<std::ptrdiff_t>(i), lArranged.end(), inColumns[i]);
+                    const auto lPosition = static_cast<std::size_t>(lIt - lArranged.begin());
+
+                    if (lPosition != i)
+                    {
+                        std::swap(lArranged[i], lArranged[lPosition]);
+                        mProjectedSwaps.emplace_back(i, lPosition);
+                    }
+                }
+
+                mProjectedColumns = std::move(lColumns);
+                mIsProjected = true;
+            }
+
+            virtual void resetProjection() override
+            {
+                mIsProjected = false;
+                mProjectedColumns.clear();
+                mProjectedSwaps.clear();
+            }
+
+            virtual void seek(std::uint64_t inOffset, std::size_t inLineNumber) override
+            {
+                if constexpr (std::is_same_v<Iterator, const char*>)
+                {
+                    if (inOffset > static_cast<std::uint64_t>(mEnd - mOrigin)) {
+                        PML_THROW_WITH_NESTED(std::out_of_range, "Offset " + std::to_string(inOffset) + " is out of the data.");
+                    }
+
+                    mStart = mOrigin + inOffset;
+                    mLineNumber = inLineNumber;
+
+                    // the structural index is rebuilt from the new position.
+                    mIsIndexValid = false;
+                }
+                else {
+                    PML_THROW_WITH_NESTED(std::logic_error, "Seeking is not supported by the input type.");
+                }
+            }
+
+            virtual std::uint64_t getOffset() const override
+            {
+                if constexpr (std::is_same_v<Iterator, const char*>) {
+                    return static_cast<std::uint64_t>(mStart - mOrigin);
+                }
+                else {
+                    PML_THROW_WITH_NESTED(std::logic_error, "Offsets are not supported by the input type.");
+                }
+            }
+
+            virtual bool follow(std::chrono::milliseconds) override
+            {
+                return !isEnd();
+            }
+
+            /**
+            * @brief Make the next data available and skip the comment lines at the present position.
+            */
+            virtual void skipComments() override
+            {
+                prepare();
+
+                if constexpr (Dialect::COMMENT_PREFIX != '\0')
+                {
+                    while (skipCommentLines()) {
+                        prepare();
+                    }
+                }
+            }
+
+            virtual void setErrorTolerant(bool inIsTolerant, std::size_t inMaxErrorNumber) override
+            {
+                mIsErrorTolerant = inIsTolerant;
+                mMaxErrorNumber = inMaxErrorNumber;
+            }
+
+            virtual const std::vector<CSVParseError>& getErrors() const override
+            {
+                return mErrors;
+            }
+
+            virtual void clearErrors() override
+            {
+                mErrors.clear();
+            }
+
+            /**
+            * @brief
+            * Write a malformed record to outFailure and stop reading, instead of throwing std::runtime_error,
+            * until this is called with nullptr. The error-tolerant mode has priority over this.
+            */
+            virtual void setFailure(CSVParseError* outFailure) override
+            {
+                mFailure = outFailure;
+            }
+
+        protected:
+
+            /**
+            * @brief Make the next data available if the present one is finished. Sources read piece by piece override this.
+            */
+            virtual void prepare()
+            {}
+
+            /**
+            * @brief
+            * Skip the comment lines at the present position within the present data.
+            * The data is not switched, so that views of the last record stay valid.
+            *
+            * @return Whether the end of the present data is reached by a comment line, that is, more may follow.
+            */
+            bool skipCommentLines()
+            {
+                bool lIsSkipped = false;
+
+                while (!isEnd() && (*mStart == Dialect::COMMENT_PREFIX))
+                {
+                    auto lit = mStart;
+                    while ((lit != mEnd) && (*lit != '\r') && (*lit != '\n')) {
+                        ++lit;
+                    }
+
+                    if (lit != mEnd)
+                    {
+                        const char lc = *lit;
+                        ++lit;
+
+                        if ((lit != mEnd) && (lc == '\r') && (*lit == '\n')) {
+                            ++lit;
+                        }
+                    }
+
+                    mStart = lit;
+                    lIsSkipped = true;
+                }
+
+                if (lIsSkipped) {
+                    // the structural index is rebuilt from the next record.
+                    mIsIndexValid = false;
+                }
+
+                return lIsSkipped && isEnd();
+            }
+
+            /**
+            * @brief Skip the comment lines at the present position, and return whether only they are in the present data.
+            */
+            bool isOnlyComments()
+            {
+                if constexpr (Dialect::COMMENT_PREFIX != '\0')
+                {
+                    skipCommentLines();
+                    return isEnd();
+                }
+                else {
+                    return false;
+                }
+            }
+
+            /**
+            * @brief Parse [inFirst, inLast) next, rebuilding the structural index for it.
+            */
+            void setRange(Iterator inFirst, Iterator inLast)
+            {
+                mStart = inFirst;
+                mEnd   = inLast;
+
+                mIsIndexValid = false;
+                mQuoteFreeFrom = nullptr;
+            }
+
+        private:
+
+            /**
+            * @brief
+            * Builder of parseRecord which pushes back fields to a vector of strings, outBuffer.
+            * Temporaries are allocated by the allocator of outBuffer.
+            */
+            template<class Buffer>
+            class StringBuilder final
+            {
+                using string_type = typename Buffer::value_type;
+
+                Buffer& mBuffer;
+                string_type mQuotedString;
+                string_type mUnQuotedString;
+
+            public:
+                explicit StringBuilder(Buffer& outBuffer)
+                    : mBuffer(outBuffer),
+                    mQuotedString(outBuffer.get_allocator()),
+                    mUnQuotedString(outBuffer.get_allocator())
+                {}
+
+                void beginField(Iterator)
+                {}
+
+                void pushUnQuoted(Iterator inIt)
+                {
+                    mUnQuotedString.push_back(*inIt);
+                }
+
+                void pushQuoted(Iterator inIt)
+                {
+                    mQuotedString.push_back(*inIt);
+                }
+
+                void pushEscapedQuote(Iterator)
+                {
+                    mQuotedString.push_back(QUOTE);
+                }
+
+                bool isQuotedEmpty() const
+                {
+                    return mQuotedString.empty();
+                }
+
+                std::string getQuoted() const
+                {
+                    return std::string(mQuotedString.cbegin(), mQuotedString.cend());
+                }
+
+                void endField(bool inIsRight, Iterator)
+                {
+                    mBuffer.push_back(std::move(inIsRight ? mQuotedString : mUnQuotedString));
+                    mQuotedString  .clear();
+                    mUnQuotedString.clear();
+                }
+
+                void beginRecord()
+                {
+                    mRecordBegin = mBuffer.size();
+                }
+
+                void rewindRecord()
+                {
+                    mBuffer.erase(mBuffer.begin() + static_cast<std::ptrdiff_t>(mRecordBegin), mBuffer.end());
+                    mQuotedString  .clear();
+                    mUnQuotedString.clear();
+                }
+
+                void addField(const char* inFirst, const char* inLast)
+                {
+                    mBuffer.emplace_back(inFirst, inLast);
+                }
+
+                void addEscapedField(const char* inFirst, const char* inLast)
+                {
+                    mBuffer.emplace_back();
+                    unescape(inFirst, inLast, mBuffer.back());
+                }
+
+            private:
+                std::size_t mRecordBegin = 0;
+            };
+
+            /**
+            * @brief
+            * Builder of CSVRecord appending the characters of fields to its buffer.
+            * Characters inside double quotations are appended directly, and those outside are kept in inoutUnQuoted
+            * until the field turns out to be unquoted. The indexed parse appends each field at once.
+            */
+            class RecordBuilder final
+            {
+                std::string& mCharacters;
+                std::vector<CSVRecord::Field>& mFields;
+                std::string& mUnQuotedString;
+                std::size_t mFieldBegin;
+
+            public:
+                RecordBuilder(CSVRecord& outRecord, std::string& inoutUnQuoted)
+                    : mCharacters(outRecord.mCharacters), mFields(outRecord.mFields), mUnQuotedString(inoutUnQuoted), mFieldBegin(0)
+                {}
+
+                void beginField(Iterator)
+                {
+                    mFieldBegin = mCharacters.size();
+                    mUnQuotedString.clear();
+                }
+
+                void pushUnQuoted(Iterator inIt)
+                {
+                    mUnQuotedString.push_back(*inIt);
+                }
+
+                void pushQuoted(Iterator inIt)
+                {
+                    mCharacters.push_back(*inIt);
+                }
+
+                void pushEscapedQuote(Iterator)
+                {
+                    mCharacters.push_back(QUOTE);
+                }
+
+                bool isQuotedEmpty() const
+                {
+                    return (mCharacters.size() == mFieldBegin);
+                }
+
+                std::string getQuoted() const
+                {
+                    return mCharacters.substr(mFieldBegin);
+                }
+
+                void endField(bool inIsRight, Iterator)
+                {
+                    if (!inIsRight)
+                    {
+                        mCharacters.resize(mFieldBegin);
+                        mCharacters += mUnQuotedString;
+                    }
+
+                    mFields.push_back(CSVRecord::Field{ mFieldBegin, mCharacters.size() - mFieldBegin });
+                }
+
+                void beginRecord()
+                {
+                    mRecordBegin = mFields.size();
+                    mCharacterBegin = mCharacters.size();
+                }
+
+                void rewindRecord()
+                {
+                    mFields.resize(mRecordBegin);
+                    mCharacters.resize(mCharacterBegin);
+                }
+
+                void addField(const char* inFirst, const char* inLast)
+                {
+                    mFields.push_back(CSVRecord::Field{ mCharacters.size(), static_cast<std::size_t>(inLast - inFirst) });
+                    mCharacters.append(inFirst, inLast);
+                }
+
+                void addEscapedField(const char* inFirst, const char* inLast)
+                {
+                    const auto lBegin = mCharacters.size();
+                    unescape(inFirst, inLast, mCharacters);
+                    mFields.push_back(CSVRecord::Field{ lBegin, mCharacters.size() - lBegin });
+                }
+
+            private:
+                std::size_t mRecordBegin = 0;
+                std::size_t mCharacterBegin = 0;
+            };
+
+            /**
+            * @brief
+            * Builder of parseRecord for non-contiguous sources which overwrites the strings of inoutRecord from the front.
+            * The strings are cleared instead of destroyed, so that their capacities are reused by the following records.
+            */
+            class OwnedBuilder final
+            {
+                std::vector<std::string>& mRecord;
+                std::string& mUnQuotedString;
+                std::size_t& mFieldNumber;
+
+            public:
+                OwnedBuilder(std::vector<std::string>& inoutRecord, std::string& inoutUnQuoted, std::size_t& outFieldNumber)
+                    : mRecord(inoutRecord), mUnQuotedString(inoutUnQuoted), mFieldNumber(outFieldNumber)
+                {}
+
+                void beginField(Iterator)
+                {
+                    if (mFieldNumber == mRecord.size()) {
+                        mRecord.emplace_back();
+                    }
+
+                    mRecord[mFieldNumber].clear();
+                    mUnQuotedString.clear();
+                }
+
+                void pushUnQuoted(Iterator inIt)
+                {
+                    mUnQuotedString.push_back(*inIt);
+                }
+
+                void pushQuoted(Iterator inIt)
+                {
+                    mRecord[mFieldNumber].push_back(*inIt);
+                }
+
+                void pushEscapedQuote(Iterator)
+                {
+                    mRecord[mFieldNumber].push_back(QUOTE);
+                }
+
+                bool isQuotedEmpty() const
+                {
+                    return mRecord[mFieldNumber].empty();
+                }
+
+                std::string getQuoted() const
+                {
+                    return mRecord[mFieldNumber];
+                }
+
+                void endField(bool inIsRight, Iterator)
+                {
+                    if (!inIsRight) {
+                        mRecord[mFieldNumber].swap(mUnQuotedString);
+                    }
+
+                    ++mFieldNumber;
+                }
+
+                void beginRecord()
+                {
+                    mRecordBegin = mFieldNumber;
+                }
+
+                void rewindRecord()
+                {
+                    mFieldNumber = mRecordBegin;
+                }
+
+            private:
+                std::size_t mRecordBegin = 0;
+            };
+
+            /**
+            * @brief Append [inFirst, inLast) to outString resolving escaped "" to ".
+            */
+            template<class String>
+            static void unescape(const char* inFirst, const char* inLast, String& outString)
+            {
+                outString.reserve(outString.size() + static_cast<std::size_t>(inLast - inFirst));
+
+                for (auto lit = inFirst; lit != inLast; ++lit)
+                {
+                    outString.push_back(*lit);
+                    if (*lit == QUOTE) {
+                        ++lit;
+                    }
+                }
+            }
+
+            /**
+            * @brief
+            * Builder of parseRecord for contiguous sources which pushes back views of the input buffer.
+            * Characters outside double quotations of an unquoted field are always contiguous,
+            * and so are those inside double quotations until an escaped "" appears.
+            * Only in the latter case the field is copied into inoutOwned.
+            */
+            class ViewBuilder final
+            {
+                std::vector<std::string_view>& mFields;
+                std::deque<std::string>& mOwned;
+                std::size_t mOwnedNumber;
+
+                const char* mFieldBegin;
+                const char* mQuotedBegin;
+                const char* mQuotedEnd;
+                std::string* mQuotedOwned;
+
+            public:
+                ViewBuilder(std::vector<std::string_view>& outFields, std::deque<std::string>& inoutOwned)
+                    : mFields(outFields), mOwned(inoutOwned), mOwnedNumber(0),
+                    mFieldBegin(nullptr), mQuotedBegin(nullptr), mQuotedEnd(nullptr), mQuotedOwned(nullptr)
+                {}
+
+                void beginField(const char* inIt)
+                {
+                    mFieldBegin  = inIt;
+                    mQuotedBegin = nullptr;
+                    mQuotedEnd   = nullptr;
+                    mQuotedOwned = nullptr;
+                }
+
+                void pushUnQuoted(const char*)
+                {}
+
+                void pushQuoted(const char* inIt)
+                {
+                    if (mQuotedOwned) {
+                        mQuotedOwned->push_back(*inIt);
+                    }
+                    else
+                    {
+                        if (!mQuotedBegin) {
+                            mQuotedBegin = inIt;
+                        }
+                        mQuotedEnd = inIt + 1;
+                    }
+                }
+
+                void pushEscapedQuote(const char*)
+                {
+                    if (!mQuotedOwned)
+                    {
+                        // deque never moves its elements, so that previous views of owned fields stay valid.
+                        if (mOwnedNumber == mOwned.size()) {
+                            mOwned.emplace_back();
+                        }
+
+                        mQuotedOwned = &mOwned[mOwnedNumber++];
+                        mQuotedOwned->assign(mQuotedBegin, mQuotedEnd);
+                    }
+
+                    mQuotedOwned->push_back(QUOTE);
+                }
+
+                bool isQuotedEmpty() const
+                {
+                    return mQuotedOwned ? mQuotedOwned->empty() : (mQuotedBegin == mQuotedEnd);
+                }
+
+                std::string getQuoted() const
+                {
+                    return mQuotedOwned ? *mQuotedOwned : std::string(mQuotedBegin, mQuotedEnd);
+                }
+
+                void endField(bool inIsRight, const char* inIt)
+                {
+                    if (!inIsRight) {
+                        mFields.emplace_back(mFieldBegin, static_cast<std::size_t>(inIt - mFieldBegin));
+                    }
+                    else if (mQuotedOwned) {
+                        mFields.emplace_back(*mQuotedOwned);
+                    }
+                    else {
+                        mFields.emplace_back(mQuotedBegin, static_cast<std::size_t>(mQuotedEnd - mQuotedBegin));
+                    }
+                }
+
+                void beginRecord()
+                {
+                    mRecordBegin = mFields.size();
+                    mOwnedRecordBegin = mOwnedNumber;
+                }
+
+                void rewindRecord()
+                {
+                    mFields.resize(mRecordBegin);
+                    mOwnedNumber = mOwnedRecordBegin;
+                }
+
+                void addField(const char* inFirst, const char* inLast)
+                {
+                    mFields.emplace_back(inFirst, static_cast<std::size_t>(inLast - inFirst));
+                }
+
+                void addEscapedField(const char* inFirst, const char* inLast)
+                {
+                    if (mOwnedNumber == mOwned.size()) {
+                        mOwned.emplace_back();
+                    }
+
+                    auto& lOwned = mOwned[mOwnedNumber++];
+                    lOwned.clear();
+                    unescape(inFirst, inLast, lOwned);
+
+                    mFields.emplace_back(lOwned);
+                }
+
+            private:
+                std::size_t mRecordBegin = 0;
+                std::size_t mOwnedRecordBegin = 0;
+            };
+
+            /**
+            * @brief
+            * Parse the next one record and push back its fields to outBuffer.
+            * Buffer is a vector of strings, and temporaries are allocated by the allocator of outBuffer.
+            */
+            template<class Buffer>
+            void readRecord(Buffer& outBuffer)
+            {
+                StringBuilder<Buffer> lBuilder(outBuffer);
+                parseValid(lBuilder);
+                arrangeProjected(outBuffer);
+            }
+
+            /**
+            * @brief
+            * Parse records until a valid one is found, skipping malformed ones in the error-tolerant mode.
+            *
+            * @return False if no valid record remains.
+            */
+            template<class Builder>
+            bool parseValid(Builder& inoutBuilder)
+            {
+                if constexpr (Dialect::COMMENT_PREFIX != '\0')
+                {
+                    skipComments();
+
+                    if (isEnd()) {
+                        return false;
+                    }
+                }
+
+                while (!parseProjected(inoutBuilder))
+                {
+                    // the malformed record is returned to the non-throwing reads.
+                    if (!mIsErrorTolerant) {
+                        return false;
+                    }
+
+                    skipComments();
+
+                    if (isEnd()) {
+                        return false;
+                    }
+                }
+
+                // isEnd() is true if only comment lines remain in the present data.
+                if constexpr (Dialect::COMMENT_PREFIX != '\0') {
+                    skipCommentLines();
+                }
+
+                return true;
+            }
+
+            /**
+            * @brief
+            * Wrapper of builders passing only the fields of projected columns.
+            * The other fields are parsed without any operation of the wrapped builder.
+            */
+            template<class Builder>
+            class ProjectedBuilder final
+            {
+                Builder& mBuilder;
+                const std::vector<std::size_t>& mColumns;
+                std::size_t mColumn;        // column of the present field
+                std::size_t mSelectedNumber; // number of passed fields
+                bool mIsSelected;
+                bool mIsQuotedEmpty;
+
+                bool select()
+                {
+                    mIsSelected = (mSelectedNumber < mColumns.size()) && (mColumns[mSelectedNumber] == mColumn);
+                    return mIsSelected;
+                }
+
+                void next()
+                {
+                    if (mIsSelected) {
+                        ++mSelectedNumber;
+                    }
+
+                    ++mColumn;
+                }
+
+            public:
+                ProjectedBuilder(Builder& inoutBuilder, const std::vector<std::size_t>& inColumns)
+                    : mBuilder(inoutBuilder), mColumns(inColumns), mColumn(0), mSelectedNumber(0), mIsSelected(false), mIsQuotedEmpty(true)
+                {}
+
+                void beginField(Iterator inIt)
+                {
+                    mIsQuotedEmpty = true;
+                    if (select()) {
+                        mBuilder.beginField(inIt);
+                    }
+                }
+
+                void pushUnQuoted(Iterator inIt)
+                {
+                    if (mIsSelected) {
+                        mBuilder.pushUnQuoted(inIt);
+                    }
+                }
+
+                void pushQuoted(Iterator inIt)
+                {
+                    mIsQuotedEmpty = false;
+                    if (mIsSelected) {
+                        mBuilder.pushQuoted(inIt);
+                    }
+                }
+
+                void pushEscapedQuote(Iterator inIt)
+                {
+                    mIsQuotedEmpty = false;
+                    if (mIsSelected) {
+                        mBuilder.pushEscapedQuote(inIt);
+                    }
+                }
+
+                bool isQuotedEmpty() const
+                {
+                    return mIsQuotedEmpty;
+                }
+
+                std::string getQuoted() const
+                {
+                    return mIsSelected ? mBuilder.getQuoted() : std::string();
+                }
+
+                void endField(bool inIsRight, Iterator inIt)
+                {
+                    if (mIsSelected) {
+                        mBuilder.endField(inIsRight, inIt);
+                    }
+
+                    next();
+                }
+
+                void beginRecord()
+                {
+                    mColumn = 0;
+                    mSelectedNumber = 0;
+                    mBuilder.beginRecord();
+                }
+
+                void rewindRecord()
+                {
+                    mColumn = 0;
+                    mSelectedNumber = 0;
+                    mBuilder.rewindRecord();
+                }
+
+                void addField(const char* inFirst, const char* inLast)
+                {
+                    if (select()) {
+                        mBuilder.addField(inFirst, inLast);
+                    }
+
+                    next();
+                }
+
+                void addEscapedField(const char* inFirst, const char* inLast)
+                {
+                    if (select()) {
+                        mBuilder.addEscapedField(inFirst, inLast);
+                    }
+
+                    next();
+                }
+
+                /**
+                * @brief Pass empty fields for the projected columns missing in the record.
+                */
+                void finish(Iterator inIt)
+                {
+                    for (; mSelectedNumber < mColumns.size(); ++mSelectedNumber)
+                    {
+                        mBuilder.beginField(inIt);
+                        mBuilder.endField(false, inIt);
+                    }
+                }
+            };
+
+            template<class Builder>
+            bool parseProjected(Builder& inoutBuilder)
+            {
+                if (!mIsProjected) {
+                    return parse(inoutBuilder);
+                }
+
+                const auto lIsEnd = isOpen() && isEnd();
+
+                ProjectedBuilder<Builder> lBuilder(inoutBuilder, mProjectedColumns);
+                if (!parse(lBuilder)) {
+                    return false;
+                }
+
+                if (!lIsEnd) {
+                    lBuilder.finish(mStart);
+                }
+
+                return true;
+            }
+
+            template<class Container>
+            void arrangeProjected(Container& inoutFields) const
+            {
+                if (!mIsProjected || (inoutFields.size() != mProjectedColumns.size())) {
+                    return;
+                }
+
+                for (const auto& swap_i : mProjectedSwaps) {
+                    std::swap(inoutFields[swap_i.first], inoutFields[swap_i.second]);
+                }
+            }
+
+            /**
+            * @brief
+            * Parse the next one record by the structural index if the source is contiguous and SIMD is available,
+            * otherwise or if the index cannot resolve the record, by the character-wise parseRecord.
+            *
+            * @return False if the record is malformed and skipped in the error-tolerant mode.
+            */
+            template<class Builder>
+            bool parse(Builder& inoutBuilder)
+            {
+                PML_PROFILE_SCOPE("pml::CSVParser::readNextOneRecord");
+
+                if constexpr (std::is_same_v<Iterator, const char*>)
+                {
+                    if ((mKernel != Indexer::Kernel::Scalar) && isOpen() && !isEnd())
+                    {
+                        if (!mIsIndexValid) {
+                            resetIndex();
+                        }
+
+                        inoutBuilder.beginRecord();
+                        if (parseRecordIndexed(inoutBuilder)) {
+                            return true;
+                        }
+                        inoutBuilder.rewindRecord();
+
+                        // the index is kept only if the record is parsed successfully.
+                        mIsIndexValid = false;
+                        if (!parseRecord(inoutBuilder)) {
+                            return false;
+                        }
+
+                        // valid records contain even number of double quotations,
+                        // so that the quotation state of the index is correct at the next record.
+                        for (auto lStructural = getStructural(mStructuralCursor);
+                            lStructural && (lStructural < mStart);
+                            lStructural = getStructural(++mStructuralCursor))
+                        {}
+
+                        mIsIndexValid = true;
+                        return true;
+                    }
+                }
+
+                return parseRecord(inoutBuilder);
+            }
+
+            void resetIndex()
+            {
+                mStructurals.clear();
+                mStructuralCursor = 0;
+                mIndexedEnd = mStart;
+                mIsIndexedEndInQuotes = false;
+                mIsIndexValid = true;
+            }
+
+            /**
+            * @brief The inCursor-th structural character, indexing the following data if necessary, or nullptr if no more exists.
+            */
+            const char* getStructural(std::size_t inCursor)
+            {
+                constexpr std::ptrdiff_t lChunkSize = 16 * 1024;
+
+                while (inCursor >= mStructurals.size())
+                {
+                    if (mIndexedEnd == mEnd) {
+                        return nullptr;
+                    }
+
+                    const auto lLast = ((mEnd - mIndexedEnd) > lChunkSize) ? (mIndexedEnd + lChunkSize) : mEnd;
+                    mIsIndexedEndInQuotes = Indexer::template index<DELIMITER, QUOTE>(mKernel, mIndexedEnd, lLast, mIsIndexedEndInQuotes, mStructurals);
+                    mIndexedEnd = lLast;
+                }
+
+                return mStructurals[inCursor];
+            }
+
+            /**
+            * @brief Finish a record parsed by the index at inNext.
+            */
+            void commitIndexedRecord(std::size_t inCursor, const char* inNext)
+            {
+                mStructuralCursor = inCursor;
+                mStart = inNext;
+                ++mLineNumber;
+
+                // drop structural characters of finished records.
+                if ((mStructuralCursor >= 4096) && (2 * mStructuralCursor >= mStructurals.size()))
+                {
+                    mStructurals.erase(mStructurals.begin(), mStructurals.begin() + static_cast<std::ptrdiff_t>(mStructuralCursor));
+                    mStructuralCursor = 0;
+                }
+            }
+
+            static bool isBlank(const char* inFirst, const char* inLast)
+            {
+                for (auto lit = inFirst; lit != inLast; ++lit)
+                {
+                    if (!isTrimmable(*lit)) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+            * @brief
+            * Parse the next one record by walking the structural index instead of branching on each character.
+            * An unquoted field is the range between two separators as is, and a quoted field is resolved by its double quotations.
+            * Nothing is committed and false is returned for records the character-wise grammar would treat differently,
+            * such as errors, which are then parsed by parseRecord.
+            */
+            template<class Builder>
+            bool parseRecordIndexed(Builder& inoutBuilder)
+            {
+                const char* lFieldBegin = mStart;
+                auto lCursor = mStructuralCursor;
+
+                while (true)
+                {
+                    auto lStructural = getStructural(lCursor);
+
+                    if (lStructural && (*lStructural == QUOTE))
+                    {
+                        // only spaces and tabs are permitted before the left double quotation.
+                        if (!isBlank(lFieldBegin, lStructural)) {
+                            return false;
+                        }
+
+                        const char* lContentBegin = lStructural + 1;
+                        const char* lClose = nullptr;
+                        bool lIsEscaped = false;
+
+                        for (++lCursor; ; )
+                        {
+                            const auto lQuote = getStructural(lCursor);
+                            if (!lQuote || (*lQuote != QUOTE)) {
+                                return false;
+                            }
+
+                            const auto lNext = getStructural(lCursor + 1);
+                            if ((lNext == lQuote + 1) && (*lNext == QUOTE))
+                            {
+                                lIsEscaped = true;
+                                lCursor += 2;
+                                continue;
+                            }
+
+                            lClose = lQuote;
+                            ++lCursor;
+                            break;
+                        }
+
+                        // only spaces and tabs are permitted after the right double quotation.
+                        lStructural = getStructural(lCursor);
+                        if ((lStructural && (*lStructural == QUOTE)) || !isBlank(lClose + 1, lStructural ? lStructural : mEnd)) {
+                            return false;
+                        }
+
+                        if (lIsEscaped) {
+                            inoutBuilder.addEscapedField(lContentBegin, lClose);
+                        }
+                        else {
+                            inoutBuilder.addField(lContentBegin, lClose);
+                        }
+                    }
+                    else {
+                        inoutBuilder.addField(lFieldBegin, lStructural ? lStructural : mEnd);
+                    }
+
+                    if (!lStructural)
+                    {
+                        // finished without a newline character
+                        commitIndexedRecord(lCursor, mEnd);
+                        return true;
+                    }
+
+                    ++lCursor;
+
+                    if (*lStructural == DELIMITER)
+                    {
+                        lFieldBegin = lStructural + 1;
+                        continue;
+                    }
+
+                    // end of the record
+                    auto lNext = lStructural + 1;
+                    if ((*lStructural == '\r') && (lNext != mEnd) && (*lNext == '\n'))
+                    {
+                        // LF is the next structural character.
+                        getStructural(lCursor);
+                        ++lCursor;
+                        ++lNext;
+                    }
+
+                    commitIndexedRecord(lCursor, lNext);
+                    return true;
+                }
+            }
+
+            /**
+            * @brief
+            * Parse the next one record by the CSV grammar, passing characters of fields to inoutBuilder.
+            *
+            * @return False if the record is malformed and skipped in the error-tolerant mode.
+            */
+            template<class Builder>
+            bool parseRecord(Builder& inoutBuilder)
+            {
+                if (!isOpen()) {
+                    PML_THROW_WITH_NESTED(std::runtime_error, "Taregt is not opened.");
+                }
+
+                if (isEnd()) {
+                    return true;
+                }
+
+                bool lIsQuoted   = true;  // Is field enclosed by double quotations.
+                bool lIsInQuotes = false; // Is the analyzed character in double quotations.
+                bool lIsRight    = false; // Is the analyzed character in right side of the double quotations.
+
+                Iterator lit(mStart); // analyzed character
+                std::size_t lColumn = 0;
+
+                inoutBuilder.beginRecord();
+                inoutBuilder.beginField(lit);
+
+                while (lit != mEnd)
+                {
+                    while (!lIsInQuotes && (lit != mEnd) && isTrimmable(*lit))
+                    {
+                        inoutBuilder.pushUnQuoted(lit);
+                        ++lit;
+                    }
+
+                    if (lit == mEnd) {
+                        break;
+                    }
+
+                    if (lIsInQuotes)
+                    {
+                        const auto lSearchBegin = lit;
+                        const auto lSearchEnd = getQuoteSearchEnd(lit);
+
+                        while ((lit != lSearchEnd) && (*lit != QUOTE))
+                        {
+                            inoutBuilder.pushQuoted(lit);
+                            ++lit;
+                        }
+
+                        if (lit == lSearchEnd)
+                        {
+                            // no double quotation exists after lSearchBegin.
+                            if constexpr (std::is_same_v<Iterator, const char*>)
+                            {
+                                if (!mQuoteFreeFrom || (lSearchBegin < mQuoteFreeFrom)) {
+                                    mQuoteFreeFrom = lSearchBegin;
+                                }
+                            }
+
+                            SkipToNextLine(lit);
+
+                            if (!mIsErrorTolerant && !mFailure) {
+                                PML_THROW_WITH_NESTED(
+                                    std::runtime_error, "Field is not closed by right side double quotation.");
+                            }
+
+                            return reject(inoutBuilder, lColumn, "Field is not closed by right side double quotation.");
+                        }
+
+                        ++lit;
+
+                        if ((lit != mEnd) && (*lit == QUOTE))
+                        {
+                            // encountered 2 continuous double quotes in a string and resolve them to 1 double quote
+                            inoutBuilder.pushEscapedQuote(lit);
+                            ++lit;
+                        }
+                        else
+                        {
+                            // end quoted char
+                            lIsInQuotes = false;
+                            lIsRight = true;
+                        }
+                    }
+                    else
+                    {
+                        char lc = *lit;
+
+                        if (lc == QUOTE)
+                        {
+                            if (inoutBuilder.isQuotedEmpty() && lIsQuoted)
+                            {
+                                // begin quoted string
+                                lIsInQuotes = true;
+                                ++lit;
+                            }
+                            else
+                            {
+                                // error; e.g. \"abc\"(spaces)\"
+                                SkipToNextLine(lit);
+
+                                if (!mIsErrorTolerant && !mFailure) {
+                                    PML_THROW_WITH_NESTED(
+                                        std::runtime_error, "Double quotation as an element of fields must be escaped by itself.");
+                                }
+
+                                return reject(inoutBuilder, lColumn, "Double quotation as an element of fields must be escaped by itself.");
+                            }
+                        }
+                        else if (lc == DELIMITER)
+                        {
+                            // end of the field
+                            inoutBuilder.endField(lIsRight, lit);
+
+                            lIsQuoted = true;
+                            lIsRight = false;
+                            ++lit;
+                            mStart = lit;
+                            ++lColumn;
+
+                            inoutBuilder.beginField(lit);
+                        }
+                        else if ((lc == '\r') || (lc == '\n'))
+                        {
+                            // end of the record
+                            inoutBuilder.endField(lIsRight, lit);
+
+                            ++lit;
+                            if ((lit != mEnd) && (lc == '\r') && (*lit == '\n')) {
+                                ++lit;
+                            }
+
+                            mStart = lit;
+                            ++mLineNumber;
+
+                            return true;
+                        }
+                        else if (lIsRight)
+                        {
+                            // erroe; e.g. \"abc\"d
+                            SkipToNextLine(lit);
+
+                            if (!mIsErrorTolerant && !mFailure) {
+                                PML_THROW_WITH_NESTED(
+                                    std::runtime_error, "Character exist in the field " + inoutBuilder.getQuoted() + " outside of double quotations.");
+                            }
+
+                            return reject(inoutBuilder, lColumn, "Character exist in the field outside of double quotations.");
+                        }
+                        else
+                        {
+                            lIsQuoted = false;
+                            inoutBuilder.pushUnQuoted(lit);
+
+                            ++lit;
+                        }
+                    }
+                }
+
+                // finished without a newline character
+                inoutBuilder.endField(lIsRight, lit);
+                ++mLineNumber;
+
+                mStart = mEnd;
+
+                return true;
+            }
+
+            /**
+            * @brief
+            * The end of the search for a right double quotation from inIt.
+            * For contiguous sources, no double quotation exists after mQuoteFreeFrom found by a failed search,
+            * so that repeated searches of unclosed fields never scan the same characters again.
+            */
+            Iterator getQuoteSearchEnd(Iterator inIt) const
+            {
+                if constexpr (std::is_same_v<Iterator, const char*>)
+                {
+                    if (mQuoteFreeFrom) {
+                        return (inIt < mQuoteFreeFrom) ? mQuoteFreeFrom : inIt;
+                    }
+                }
+
+                return mEnd;
+            }
+
+            /**
+            * @brief
+            * Resynchronize at the next record of a malformed one, where inIt is the analyzed character.
+            * Contiguous sources are skipped from the beginning of the present field at mStart to its first newline character,
+            * so that records swallowed by an unclosed double quotation are parsed again.
+            * Streams cannot go back and are skipped from inIt.
+            */
+            void SkipToNextLine(Iterator inIt)
+            {
+                auto lit = inIt;
+                if constexpr (std::is_same_v<Iterator, const char*>) {
+                    lit = mStart;
+                }
+
+                while ((lit != mEnd) && (*lit != '\r') && (*lit != '\n')) {
+                    ++lit;
+                }
+
+                if (lit != mEnd)
+                {
+                    const char lc = *lit;
+                    ++lit;
+
+                    if ((lit != mEnd) && (lc == '\r') && (*lit == '\n')) {
+                        ++lit;
+                    }
+                }
+
+                mStart = lit;
+                ++mLineNumber;
+            }
+
+            /**
+            * @brief
+            * Discard the malformed record and append it to mErrors in the error-tolerant mode,
+            * or write it to mFailure for the non-throwing reads.
+            */
+            template<class Builder>
+            bool reject(Builder& inoutBuilder, std::size_t inColumn, const char* inReason)
+            {
+                inoutBuilder.rewindRecord();
+
+                // the quotation state of the structural index may be broken by the record.
+                mIsIndexValid = false;
+
+                if (!mIsErrorTolerant)
+                {
+                    *mFailure = CSVParseError{ mLineNumber, inColumn, inReason };
+                    return false;
+                }
+
+                if (mErrors.size() >= mMaxErrorNumber) {
+                    PML_THROW_WITH_NESTED(std::runtime_error, "Errors exceed " + std::to_string(mMaxErrorNumber) + " at record " + std::to_string(mLineNumber) + ".");
+                }
+
+                mErrors.push_back(CSVParseError{ mLineNumber, inColumn, inReason });
+
+                return false;
+            }
+        };
+
+        template<class Dialect>
+        class FileParser final : public ParserBaseImpl<std::istreambuf_iterator<char>, Dialect>
+        {
+            using Base = ParserBaseImpl<std::istreambuf_iterator<char>, Dialect>;
+            using Base::mStart;
+            using Base::mEnd;
+            using Base::mIsOpen;
+
+        public:
+            explicit FileParser(const std::string& inFileName)
+                : mBuffer(std::size_t(1) << 18)
+            {
+                // read the file in large blocks instead of the default buffer of a few kilobytes.
+                mFile.rdbuf()->pubsetbuf(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+
+#ifdef _WIN32
+                std::locale lLC_DEF;
+                std::locale::global(std::locale(""));
+                mFile.open(inFileName.c_str(), std::ios::in);
+                std::locale::global(std::locale(lLC_DEF));
+#else
+                mFile.open(inFileName.c_str(), std::ios::in);
+#endif
+
+                mIsOpen = !(mFile.fail());
+
+                mStart = typename Base::iterator_type(mFile);
+                mEnd   = typename Base::iterator_type();
+            }
+
+        private:
+            std::vector<char> mBuffer;
+            std::ifstream mFile;
+        };
+
+        /**
+        * @brief
+        * Forward scanner of record boundaries, which are newlines outside double quotations, starting at the beginning of a record.
+        * A comment line begins with Dialect::COMMENT_PREFIX at the beginning of a record and ends at the next newline,
+        * and Quote in it is not counted.
+        */
+        template<class Dialect>
+        struct BoundaryScanner final
+        {
+            bool mIsInQuotes  = false;
+            bool mIsInComment = false;
+            bool mIsLineStart = true;
+
+            /**
+            * @brief Update the state by inChar, and return whether inChar is a newline ending a record or a comment line.
+            */
+            bool step(char inChar) noexcept
+            {
+                if constexpr (Dialect::COMMENT_PREFIX != '\0')
+                {
+                    if (mIsInComment)
+                    {
+                        mIsInComment = (inChar != '\r') && (inChar != '\n');
+                        mIsLineStart = !mIsInComment;
+                        return mIsLineStart;
+                    }
+
+                    if (mIsLineStart && (inChar == Dialect::COMMENT_PREFIX))
+                    {
+                        mIsInComment = true;
+                        mIsLineStart = false;
+                        return false;
+                    }
+                }
+
+                if (inChar == Dialect::QUOTE) {
+                    mIsInQuotes = !mIsInQuotes;
+                }
+
+                mIsLineStart = !mIsInQuotes && ((inChar == '\r') || (inChar == '\n'));
+                return mIsLineStart;
+            }
+
+            /**
+            * @brief
+            * The next of the first boundary in [inFirst, inLast), or nullptr if not found, scanning the state up to it.
+            * CR at inLast - 1 is not a boundary since LF of CRLF may follow in the next data.
+            */
+            const char* findFirstBoundary(const char* inFirst, const char* inLast) noexcept
+            {
+                for (auto lit = inFirst; lit != inLast; ++lit)
+                {
+                    if (!step(*lit)) {
+                        continue;
+                    }
+
+                    if (*lit == '\r')
+                    {
+                        if ((lit + 1) == inLast) {
+                            return nullptr;
+                        }
+
+                        // LF of CRLF is the boundary.
+                        if (*(lit + 1) == '\n') {
+                            continue;
+                        }
+                    }
+
+                    return lit + 1;
+                }
+
+                return nullptr;
+            }
+        };
+
+        /**
+        * @brief
+        * Parser of ASYNC_FILE. A reader thread fills buffers by unbuffered std::fread and passes them through mFilledRing,
+        * and the parser returns them through mFreeRing after use, so that the buffers are allocated only once.
+        * Each buffer is parsed in place up to its last record boundary, found by the parity of double quotations.
+        * The rest of the buffer is carried over into a spill buffer together with the head of the next buffer up to its first boundary,
+        * so that only records spanning buffers are copied.
+        * The next range is prepared just after a range is finished, and the buffers of the last record are released at the next preparation,
+        * so that views of readNextOneRecordView stay valid until the next call.
+        */
+        template<class Dialect>
+        class AsyncFileParser final : public ParserBaseImpl<const char*, Dialect>
+        {
+            using Base = ParserBaseImpl<const char*, Dialect>;
+            using Base::mStart;
+            using Base::mEnd;
+            using Base::mIsOpen;
+            using Base::isOnlyComments;
+            using Base::setRange;
+
+            using Scanner = BoundaryScanner<Dialect>;
+
+        public:
+            /**
+            * @param[in] inIsCompressed
+            * Whether the file may be compressed, see detail::CSVDecompressor::create.
+            */
+            AsyncFileParser(const std::string& inFileName, std::size_t inBufferSize, bool inIsCompressed = false)
+                : mFilledRing(BUFFER_NUMBER), mFreeRing(BUFFER_NUMBER), mIsStopped(false), mIsFailed(false), mFile(nullptr),
+                mSpillIndex(0), mBodyFirst(nullptr), mBodyLast(nullptr), mIsFinished(false)
+            {
+                mFile = std::fopen(inFileName.c_str(), "rb");
+                mIsOpen = (mFile != nullptr);
+                if (!mIsOpen) {
+                    return;
+                }
+
+                // the buffers are read directly by the OS without the buffer of stdio.
+                std::setvbuf(mFile, nullptr, _IONBF, 0);
+
+                for (std::size_t i = 0; i < BUFFER_NUMBER; ++i)
+                {
+                    auto lBuffer = std::make_unique<Buffer>();
+                    lBuffer->mData.resize(inBufferSize);
+                    mFreeRing.tryPush(std::move(lBuffer));
+                }
+
+                try
+                {
+                    if (inIsCompressed) {
+                        mDecompressor = detail::CSVDecompressor::create(mFile, inBufferSize);
+                    }
+
+                    mReader = std::thread([this]() { read(); });
+
+                    prepare();
+                }
+                catch (...)
+                {
+                    stop();
+                    throw;
+                }
+            }
+
+            AsyncFileParser(const AsyncFileParser&)            = delete;
+            AsyncFileParser(AsyncFileParser&&)                 = delete;
+            AsyncFileParser& operator=(const AsyncFileParser&) = delete;
+            AsyncFileParser& operator=(AsyncFileParser&&)      = delete;
+
+            virtual ~AsyncFileParser() override
+            {
+                stop();
+            }
+
+            virtual std::vector<std::string> readNextOneRecord() override
+            {
+                auto lRecord = Base::readNextOneRecord();
+                prepare();
+
+                return lRecord;
+            }
+
+            virtual std::pmr::vector<std::pmr::string> readNextOneRecord(std::pmr::memory_resource* inResource) override
+            {
+                auto lRecord = Base::readNextOneRecord(inResource);
+                prepare();
+
+                return lRecord;
+            }
+
+            virtual bool readNextOneRecord(CSVRecord& outRecord) override
+            {
+                const auto lIsRead = Base::readNextOneRecord(outRecord);
+                prepare();
+
+                return lIsRead;
+            }
+
+            virtual bool readNextOneRecordView(std::vector<std::string_view>& outFields) override
+            {
+                const auto lIsRead = Base::readNextOneRecordView(outFields);
+                prepare();
+
+                return lIsRead;
+            }
+
+            virtual void seek(std::uint64_t, std::size_t) override
+            {
+                PML_THROW_WITH_NESTED(std::logic_error, "Seeking is not supported by the input type.");
+            }
+
+            virtual std::uint64_t getOffset() const override
+            {
+                PML_THROW_WITH_NESTED(std::logic_error, "Offsets are not supported by the input type.");
+            }
+
+        private:
+
+            static constexpr std::size_t BUFFER_NUMBER = 4;
+
+            struct Buffer final
+            {
+                std::vector<char> mData;
+                std::size_t mSize = 0;
+
+                const char* begin() const noexcept
+                {
+                    return mData.data();
+                }
+
+                const char* end() const noexcept
+                {
+                    return mData.data() + mSize;
+                }
+            };
+
+            using BufferPtr = std::unique_ptr<Buffer>;
+
+            /**
+            * @brief Body of the reader thread, which also decompresses the file if mDecompressor exists.
+            */
+            void read()
+            {
+                try
+                {
+                    BufferPtr lBuffer;
+                    while (!mIsStopped.load() && mFreeRing.pop(lBuffer))
+                    {
+                        lBuffer->mSize = mDecompressor
+                            ? mDecompressor->read(lBuffer->mData.data(), lBuffer->mData.size())
+                            : std::fread(lBuffer->mData.data(), 1, lBuffer->mData.size(), mFile);
+
+                        if (lBuffer->mSize == 0)
+                        {
+                            mIsFailed.store(std::ferror(mFile) != 0);
+                            break;
+                        }
+
+                        if (!mFilledRing.push(std::move(lBuffer))) {
+                            break;
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    // passed to the parsing thread by closing the ring below.
+                    mException = std::current_exception();
+                    mIsFailed.store(true);
+                }
+
+                mFilledRing.close();
+            }
+
+            void release(BufferPtr& inoutBuffer)
+            {
+                if (inoutBuffer) {
+                    mFreeRing.tryPush(std::move(inoutBuffer));
+                }
+            }
+
+            static bool hasOddQuotes(const char* inFirst, const char* inLast)
+            {
+                return (std::count(inFirst, inLast, Dialect::QUOTE) & 1) != 0;
+            }
+
+            /**
+            * @brief
+            * The next of the last boundary in [inFirst, inLast), or inFirst if not found, where inFirst is the beginning of a record.
+            * Without comments, the state at each position is the parity of the following quotations, so that only the tail is scanned.
+            */
+            static const char* findLastBoundary(const char* inFirst, const char* inLast)
+            {
+                if constexpr (Dialect::COMMENT_PREFIX != '\0')
+                {
+                    // Quote in comment lines is not counted, which is known only by the forward scan.
+                    Scanner lScanner;
+                    auto lLast = inFirst;
+                    for (auto lit = lScanner.findFirstBoundary(inFirst, inLast); lit; lit = lScanner.findFirstBoundary(lit, inLast)) {
+                        lLast = lit;
+                    }
+
+                    return lLast;
+                }
+
+                auto lIsInQuotes = hasOddQuotes(inFirst, inLast);
+
+                for (auto lit = inLast; lit != inFirst; )
+                {
+                    --lit;
+                    if (*lit == Dialect::QUOTE) {
+                        lIsInQuotes = !lIsInQuotes;
+                    }
+                    else if (!lIsInQuotes && ((*lit == '\n') || ((*lit == '\r') && ((lit + 1) != inLast)))) {
+                        return lit + 1;
+                    }
+                }
+
+                return inFirst;
+            }
+
+            /**
+            * @brief Set the next non-empty range to be parsed if the present one is finished.
+            */
+            virtual void prepare() override
+            {
+                if ((mStart != mEnd) || mIsFinished) {
+                    return;
+                }
+
+                if (mBodyFirst != mBodyLast)
+                {
+                    setRange(mBodyFirst, mBodyLast);
+                    mBodyFirst = mBodyLast;
+
+                    if (!isOnlyComments()) {
+                        return;
+                    }
+                }
+
+                // the last record may refer to mBuffer or the present spill buffer, which are kept until the next preparation.
+                release(mPreviousBuffer);
+                mPreviousBuffer = std::move(mBuffer);
+
+                mSpillIndex ^= 1;
+                auto& lSpill = mSpills[mSpillIndex];
+                lSpill.clear();
+
+                if (mPreviousBuffer) {
+                    lSpill.insert(lSpill.end(), mBodyLast, mPreviousBuffer->end());
+                }
+
+                // the spill buffer has no boundary, and only its state is scanned.
+                Scanner lScanner;
+                static_cast<void>(lScanner.findFirstBoundary(lSpill.data(), lSpill.data() + lSpill.size()));
+
+                for (;;)
+                {
+                    BufferPtr lBuffer;
+                    if (!mFilledRing.pop(lBuffer))
+                    {
+                        if (mIsFailed.load())
+                        {
+                            if (mException)
+                            {
+                                try {
+                                    std::rethrow_exception(mException);
+                                }
+                                catch (...) {
+                                    PML_THROW_WITH_NESTED(std::runtime_error, "File cannot be decompressed.");
+                                }
+                            }
+
+                            PML_THROW_WITH_NESTED(std::runtime_error, "File cannot be read.");
+                        }
+
+                        mIsFinished = true;
+                        setRange(lSpill.data(), lSpill.data() + lSpill.size());
+                        isOnlyComments();
+                        return;
+                    }
+
+                    const auto lFirst = lScanner.findFirstBoundary(lBuffer->begin(), lBuffer->end());
+                    if (!lFirst)
+                    {
+                        // a record longer than the buffer.
+                        lSpill.insert(lSpill.end(), lBuffer->begin(), lBuffer->end());
+                        release(lBuffer);
+                        continue;
+                    }
+
+                    // the spill buffer is not empty since it ends with the newline at least.
+                    lSpill.insert(lSpill.end(), lBuffer->begin(), lFirst);
+
+                    mBodyFirst = lFirst;
+                    mBodyLast  = findLastBoundary(lFirst, lBuffer->end());
+                    mBuffer    = std::move(lBuffer);
+
+                    setRange(lSpill.data(), lSpill.data() + lSpill.size());
+                    if (!isOnlyComments()) {
+                        return;
+                    }
+
+                    if (mBodyFirst != mBodyLast)
+                    {
+                        setRange(mBodyFirst, mBodyLast);
+                        mBodyFirst = mBodyLast;
+
+                        if (!isOnlyComments()) {
+                            return;
+                        }
+                    }
+
+                    // only comment lines are found, so that the rest is carried over in the same spill buffer
+                    // without releasing the buffers of the last record, which are mPreviousBuffer and the other spill buffer.
+                    lSpill.assign(mBodyLast, mBuffer->end());
+                    release(mBuffer);
+
+                    lScanner = Scanner();
+                    static_cast<void>(lScanner.findFirstBoundary(lSpill.data(), lSpill.data() + lSpill.size()));
+                }
+            }
+
+            void stop()
+            {
+                mIsStopped.store(true);
+                mFreeRing.close();
+                mFilledRing.close();
+
+                if (mReader.joinable()) {
+                    mReader.join();
+                }
+
+                if (mFile)
+                {
+                    std::fclose(mFile);
+                    mFile = nullptr;
+                }
+            }
+
+            SPSCRing<BufferPtr> mFilledRing;
+            SPSCRing<BufferPtr> mFreeRing;
+            std::atomic<bool> mIsStopped;
+            std::atomic<bool> mIsFailed;
+            std::FILE* mFile;
+            std::unique_ptr<detail::CSVDecompressor> mDecompressor;
+            std::exception_ptr mException;
+            std::thread mReader;
+
+            BufferPtr mBuffer;
+            BufferPtr mPreviousBuffer;
+            std::vector<char> mSpills[2];
+            std::size_t mSpillIndex;
+            const char* mBodyFirst;
+            const char* mBodyLast;
+            bool mIsFinished;
         };
 
-        template<class Iterator>
-        class ParserBaseImpl : public ParserBase
+        /**
+        * @brief
+        * Parser of FOLLOW_FILE. The file is read by unbuffered std::fread from the end of the previous read,
+        * and only the bytes up to the last newline outside double quotations are parsed.
+        * The quotation state and the last boundary are updated incrementally over the new bytes,
+        * and the partial record after the boundary is carried over to the other of two buffers when the parsed records are finished,
+        * so that views of readNextOneRecordView stay valid until the next call.
+        */
+        template<class Dialect>
+        class FollowParser final : public ParserBaseImpl<const char*, Dialect>
         {
-        protected:
-            using iterator_type = Iterator;
-            Iterator mStart;
-            Iterator mEnd;
-            std::size_t mLineNumber;
-            bool mIsOpen;
+            using Base = ParserBaseImpl<const char*, Dialect>;
+            using Base::mStart;
+            using Base::mEnd;
+            using Base::mLineNumber;
+            using Base::mIsOpen;
+            using Base::isEnd;
+            using Base::isOnlyComments;
+            using Base::setRange;
 
         public:
+            FollowParser(const std::string& inFileName, std::size_t inBufferSize)
+                : mFileName(inFileName), mFile(nullptr), mWatch(-1), mReadBuffer(inBufferSize),
+                mBufferIndex(0), mBufferOffset(0), mScanned(0), mScanner(), mBoundary(0)
+            {
+                mFile = std::fopen(inFileName.c_str(), "rb");
+                mIsOpen = (mFile != nullptr);
+                if (!mIsOpen) {
+                    return;
+                }
 
-            ParserBaseImpl() : mLineNumber(0), mIsOpen(false)
-            {}
+                std::setvbuf(mFile, nullptr, _IONBF, 0);
 
-            ParserBaseImpl(Iterator inStart, Iterator inEnd) : mStart(inStart), mEnd(inEnd), mLineNumber(0), mIsOpen(false)
-            {}
+#ifdef __linux__
+                // if inotify is not available, the size of the file is polled.
+                mWatch = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+                addWatch();
+#endif
 
-            virtual ~ParserBaseImpl() override = default;
+                try {
+                    prepare();
+                }
+                catch (...)
+                {
+                    close();
+                    throw;
+                }
+            }
+
+            FollowParser(const FollowParser&)            = delete;
+            FollowParser(FollowParser&&)                 = delete;
+            FollowParser& operator=(const FollowParser&) = delete;
+            FollowParser& operator=(FollowParser&&)      = delete;
+
+            virtual ~FollowParser() override
+            {
+                close();
+            }
 
             virtual std::vector<std::string> readNextOneRecord() override
             {
-                std::vector<std::string> outBuffer;
+                auto lRecord = Base::readNextOneRecord();
+                prepare();
 
-                if (!isOpen()) {
+                return lRecord;
+            }
+
+            virtual std::pmr::vector<std::pmr::string> readNextOneRecord(std::pmr::memory_resource* inResource) override
+            {
+                auto lRecord = Base::readNextOneRecord(inResource);
+                prepare();
+
+                return lRecord;
+            }
+
+            virtual bool readNextOneRecord(CSVRecord& outRecord) override
+            {
+                const auto lIsRead = Base::readNextOneRecord(outRecord);
+                prepare();
+
+                return lIsRead;
+            }
+
+            virtual bool readNextOneRecordView(std::vector<std::string_view>& outFields) override
+            {
+                const auto lIsRead = Base::readNextOneRecordView(outFields);
+                prepare();
+
+                return lIsRead;
+            }
+
+            virtual void seek(std::uint64_t inOffset, std::size_t inLineNumber) override
+            {
+                if (!mFile) {
                     PML_THROW_WITH_NESTED(std::runtime_error, "Taregt is not opened.");
                 }
 
-                if (isEnd()) {
-                    return outBuffer;
-                }
+                restart(inOffset);
+                mLineNumber = inLineNumber;
 
-                bool lIsQuoted   = true;  // Is field enclosed by double quotations.
-                bool lIsInQuotes = false; // Is the analyzed character in double quotations.
-                bool lIsRight    = false; // Is the analyzed character in right side of the double quotations.
+                prepare();
+            }
 
-                Iterator lit(mStart); // analyzed character
-                long lDistanceFromStart = 0;
+            virtual std::uint64_t getOffset() const override
+            {
+                return mBufferOffset + static_cast<std::uint64_t>(mStart - mBuffers[mBufferIndex].data());
+            }
+
+            virtual bool follow(std::chrono::milliseconds inTimeout) override
+            {
+                prepare();
+                if (!isEnd() || !mFile) {
+                    return !isEnd();
+                }
 
-                std::string lQuotedString;
-                std::string lUnQuotedString;
+                const auto lDeadline = std::chrono::steady_clock::now() + inTimeout;
 
-                while (lit != mEnd)
+                for (auto lNow = std::chrono::steady_clock::now(); lNow < lDeadline; lNow = std::chrono::steady_clock::now())
                 {
-                    while (!lIsInQuotes && (lit != mEnd) && (*lit == ' ' || *lit == '\t'))
-                    {
-                        lUnQuotedString.push_back(*lit);
-                        ++lit;
-                        ++lDistanceFromStart;
-                    }
+                    wait(std::chrono::duration_cast<std::chrono::milliseconds>(lDeadline - lNow) + std::chrono::milliseconds(1));
 
-                    if (lit == mEnd) {
-                        break;
+                    prepare();
+                    if (!isEnd()) {
+                        return true;
                     }
+                }
 
-                    if (lIsInQuotes)
-                    {
-                        for (; *lit != '\"';)
-                        {
-                            lQuotedString.push_back(*lit);
-                            ++lit;
-                            ++lDistanceFromStart;
+                return false;
+            }
 
-                            if (lit == mEnd)
-                            {
-                                std::advance(lit, -lDistanceFromStart);
-                                mStart = lit;
-                                SkipToNextLine();
+        private:
 
-                                PML_THROW_WITH_NESTED(
-                                    std::runtime_error, "Field is not closed by right side double quotation.");
-                            }
-                        }
+            static constexpr std::chrono::milliseconds POLL_INTERVAL = std::chrono::milliseconds(10);
 
-                        ++lit;
-                        ++lDistanceFromStart;
+            /**
+            * @brief Set the next complete records to be parsed if the present ones are finished.
+            */
+            virtual void prepare() override
+            {
+                if ((mStart != mEnd) || !mFile) {
+                    return;
+                }
 
-                        if ((lit != mEnd) && (*lit == '\"'))
-                        {
-                            // encountered 2 continuous double quotes in a string and resolve them to 1 double quote
-                            lQuotedString.push_back('\"');
-                            ++lit;
-                            ++lDistanceFromStart;
-                        }
-                        else
-                        {
-                            // end quoted char
-                            lIsInQuotes = false;
-                            lIsRight = true;
-                        }
-                    }
-                    else
+                if (mBoundary > 0)
+                {
+                    // the finished records may be referred by views, so that the partial record is moved to the other buffer.
+                    auto& lBuffer = mBuffers[mBufferIndex];
+                    auto& lNext = mBuffers[mBufferIndex ^ 1];
+                    lNext.assign(lBuffer.cbegin() + static_cast<std::ptrdiff_t>(mBoundary), lBuffer.cend());
+
+                    mBufferIndex ^= 1;
+                    mBufferOffset += mBoundary;
+                    mScanned -= mBoundary;
+                    mBoundary = 0;
+                }
+
+                std::uint64_t lSize = 0;
+                if (getFileSize(lSize) && (lSize < mBufferOffset + mBuffers[mBufferIndex].size()))
+                {
+                    // the file has been rewritten. A file which has grown back beyond the offset is not distinguished from appends, see CSVParser::follow.
+                    restart(0);
+                    mLineNumber = 0;
+                }
+
+                auto& lBuffer = mBuffers[mBufferIndex];
+
+                for (;;)
+                {
+                    while (mBoundary == 0)
                     {
-                        char lc = *lit;
+                        // read into the fixed buffer so that polls finding no bytes neither resize nor fill the buffer of records.
+                        const auto lReadSize = std::fread(mReadBuffer.data(), 1, mReadBuffer.size(), mFile);
+                        lBuffer.insert(lBuffer.cend(), mReadBuffer.cbegin(), mReadBuffer.cbegin() + static_cast<std::ptrdiff_t>(lReadSize));
 
-                        if (lc == '\"')
+                        if (lReadSize == 0)
                         {
-                            if (lQuotedString.empty() && lIsQuoted)
-                            {
-                                // begin quoted string
-                                lIsInQuotes = true;
-                                ++lit;
-                                ++lDistanceFromStart;
+                            if (std::ferror(mFile)) {
+                                PML_THROW_WITH_NESTED(std::runtime_error, "File cannot be read.");
                             }
-                            else
-                            {
-                                // error; e.g. \"abc\"(spaces)\"
-                                std::advance(lit, -lDistanceFromStart);
-                                mStart = lit;
-                                SkipToNextLine();
 
-                                PML_THROW_WITH_NESTED(
-                                    std::runtime_error, "Double quotation as an element of fields must be escaped by itself.");
+                            // the end of file is cleared so that the following appends are read.
+                            std::clearerr(mFile);
+
+                            // the old file has been read to its end, and the new file at the path is read from the beginning.
+                            if (!isPathOfFile() && reopen()) {
+                                continue;
                             }
-                        }
-                        else if (lc == ',')
-                        {
-                            // end of the field
-                            outBuffer.push_back(std::move(lIsRight ? lQuotedString : lUnQuotedString));
-                            lQuotedString  .clear();
-                            lUnQuotedString.clear();
 
-                            lIsQuoted = true;
-                            lIsRight = false;
-                            ++lit;
-                            mStart = lit;
-                            lDistanceFromStart = 0;
+                            break;
                         }
-                        else if ((lc == '\r') || (lc == '\n'))
-                        {
-                            // end of the record
-                            outBuffer.push_back(std::move(lIsRight ? lQuotedString : lUnQuotedString));
 
-                            ++lit;
-                            if ((lit != mEnd) && (lc == '\r') && (*lit == '\n')) {
-                                ++lit;
-                            }
+                        scan();
+                    }
 
-                            mStart = lit;
-                            ++mLineNumber;
+                    setRange(lBuffer.data(), lBuffer.data() + mBoundary);
+                    if ((mBoundary == 0) || !isOnlyComments()) {
+                        return;
+                    }
 
-                            return outBuffer;
-                        }
-                        else if (lIsRight)
-                        {
-                            // erroe; e.g. \"abc\"d
-                            std::advance(lit, -lDistanceFromStart);
-                            mStart = lit;
-                            SkipToNextLine();
+                    // complete records are only comment lines, which are dropped from this buffer not referred by the last record.
+                    lBuffer.erase(lBuffer.cbegin(), lBuffer.cbegin() + static_cast<std::ptrdiff_t>(mBoundary));
+                    mBufferOffset += mBoundary;
+                    mScanned -= mBoundary;
+                    mBoundary = 0;
+                }
+            }
 
-                            PML_THROW_WITH_NESTED(
-                                std::runtime_error, "Character exist in the field " + lQuotedString + " outside of double quotations.");
-                        }
-                        else
-                        {
-                            lIsQuoted = false;
-                            lUnQuotedString.push_back(lc);
+            /**
+            * @brief Update the scanned state and the last boundary over the bytes after mScanned.
+            */
+            void scan()
+            {
+                const auto& lBuffer = mBuffers[mBufferIndex];
+                const auto lSize = lBuffer.size();
 
-                            ++lit;
-                            ++lDistanceFromStart;
-                        }
+                auto i = mScanned;
+                for (; i < lSize; ++i)
+                {
+                    const char lc = lBuffer[i];
+
+                    // LF of CRLF may be appended later, so that CR at the end is scanned again.
+                    if ((lc == '\r') && ((i + 1) == lSize) && BoundaryScanner<Dialect>(mScanner).step(lc)) {
+                        break;
                     }
-                }
 
-                // finished without a newline character
-                outBuffer.push_back(std::move(lIsRight ? lQuotedString : lUnQuotedString));
-                ++mLineNumber;
+                    if (mScanner.step(lc)) {
+                        mBoundary = i + 1;
+                    }
+                }
 
-                mStart = mEnd;
-                return outBuffer;
+                mScanned = i;
             }
 
-            virtual bool isEnd() const override
+            /**
+            * @brief Discard all read bytes and read the file from inOffset next.
+            */
+            void restart(std::uint64_t inOffset)
             {
-                return (mStart == mEnd);
+#ifdef _WIN32
+                const auto lResult = ::_fseeki64(mFile, static_cast<__int64>(inOffset), SEEK_SET);
+#else
+                const auto lResult = ::fseeko(mFile, static_cast<off_t>(inOffset), SEEK_SET);
+#endif
+                if (lResult != 0) {
+                    PML_THROW_WITH_NESTED(std::runtime_error, "Offset " + std::to_string(inOffset) + " cannot be sought.");
+                }
+
+                mBuffers[mBufferIndex].clear();
+                mBufferOffset = inOffset;
+                mScanned = 0;
+                mScanner = BoundaryScanner<Dialect>();
+                mBoundary = 0;
+
+                setRange(mBuffers[mBufferIndex].data(), mBuffers[mBufferIndex].data());
             }
 
-            virtual bool isOpen() const override
+            /**
+            * @brief Size of the open file, which may differ from the file at the path after a rotation.
+            */
+            bool getFileSize(std::uint64_t& outSize) const
             {
-                return mIsOpen;
+#ifdef _WIN32
+                std::int64_t lTime = 0;
+                return MappedFile::getStatus(mFileName, outSize, lTime);
+#else
+                struct ::stat lStatus;
+                if (::fstat(::fileno(mFile), &lStatus) != 0) {
+                    return false;
+                }
+
+                outSize = static_cast<std::uint64_t>(lStatus.st_size);
+                return true;
+#endif
             }
 
-            virtual std::size_t getLineNumber() const override
+            /**
+            * @brief Does the path still refer to the open file ? It does not after the file is renamed or deleted.
+            */
+            bool isPathOfFile() const
             {
-                return mLineNumber;
+#ifdef _WIN32
+                return true;
+#else
+                struct ::stat lOpened;
+                struct ::stat lPath;
+                if (::fstat(::fileno(mFile), &lOpened) != 0) {
+                    return true;
+                }
+
+                if (::stat(mFileName.c_str(), &lPath) != 0) {
+                    return false;
+                }
+
+                return (lOpened.st_dev == lPath.st_dev) && (lOpened.st_ino == lPath.st_ino);
+#endif
             }
 
-        private:
+            /**
+            * @brief Replace the open file by the file at the path and read it from the beginning, or keep the open one if the path cannot be opened.
+            */
+            bool reopen()
+            {
+                auto lFile = std::fopen(mFileName.c_str(), "rb");
+                if (!lFile) {
+                    return false;
+                }
+
+                std::setvbuf(lFile, nullptr, _IONBF, 0);
+                std::fclose(mFile);
+                mFile = lFile;
 
-            void SkipToNextLine()
+#ifdef __linux__
+                // the watch of the old file is removed by the kernel when the file is deleted.
+                addWatch();
+#endif
+
+                restart(0);
+                mLineNumber = 0;
+
+                return true;
+            }
+
+#ifdef __linux__
+            /**
+            * @brief Watch the file at the path by inotify, or fall back to polling if this fails.
+            */
+            void addWatch()
             {
-                auto lit(mStart);
+                if ((mWatch >= 0) && (::inotify_add_watch(mWatch, mFileName.c_str(), IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF) < 0))
+                {
+                    ::close(mWatch);
+                    mWatch = -1;
+                }
+            }
+#endif
 
-                while ((*lit != '\r') && (*lit != '\n'))
+            /**
+            * @brief Wait at most inTimeout for a modification of the file.
+            */
+            void wait(std::chrono::milliseconds inTimeout)
+            {
+#ifdef __linux__
+                // after a rotation, the file to be created at the path is not watched yet, so that it is polled.
+                if ((mWatch >= 0) && isPathOfFile())
                 {
-                    if (lit == mEnd)
-                    {
-                        mStart = mEnd;
-                        return;
-                    }
+                    ::pollfd lPoll{ mWatch, POLLIN, 0 };
+                    ::poll(&lPoll, 1, static_cast<int>(std::min<std::chrono::milliseconds::rep>(inTimeout.count(), 1000 * 1000)));
+
+                    // events are only notifications, and the appended bytes are read after them.
+                    char lEvents[4096];
+                    while (::read(mWatch, lEvents, sizeof(lEvents)) > 0)
+                    {}
+
+                    return;
                 }
+#endif
 
-                char lc = *lit;
-                ++lit;
+                std::this_thread::sleep_for(std::min(inTimeout, POLL_INTERVAL));
+            }
 
-                if ((lit != mEnd) && (lc == '\r') && (*lit == '\n')) {
-                    ++lit;
+            void close()
+            {
+#ifdef __linux__
+                if (mWatch >= 0)
+                {
+                    ::close(mWatch);
+                    mWatch = -1;
                 }
+#endif
 
-                mStart = lit;
-                ++mLineNumber;
+                if (mFile)
+                {
+                    std::fclose(mFile);
+                    mFile = nullptr;
+                }
             }
+
+            std::string mFileName;
+            std::FILE* mFile;
+            int mWatch;
+            std::vector<char> mReadBuffer; // bytes of one std::fread
+
+            std::vector<char> mBuffers[2];
+            std::size_t mBufferIndex;
+            std::uint64_t mBufferOffset;   // offset of the present buffer in the file
+            std::size_t mScanned;          // bytes of the present buffer scanned for boundaries
+            BoundaryScanner<Dialect> mScanner; // state at mScanned
+            std::size_t mBoundary;         // end of the complete records in the present buffer
         };
 
-        class FileParser final : public ParserBaseImpl<std::istreambuf_iterator<char>>
+        template<class Dialect>
+        class MMapParser final : public ParserBaseImpl<const char*, Dialect>
         {
+            using Base = ParserBaseImpl<const char*, Dialect>;
+            using Base::mOrigin;
+            using Base::mStart;
+            using Base::mEnd;
+            using Base::mIsOpen;
+
         public:
-            explicit FileParser(const std::string& inFileName)
+            explicit MMapParser(const std::string& inFileName)
+                : mFile(inFileName, MappedFile::AccessHint::Sequential)
             {
-#ifdef _WIN32
-                std::locale lLC_DEF;
-                std::locale::global(std::locale(""));
-                mFile.open(inFileName.c_str(), std::ios::in);
-                std::locale::global(std::locale(lLC_DEF));
-#else
-                mFile.open(inFileName.c_str(), std::ios::in);
-#endif
+                mIsOpen = mFile.isOpen();
 
-                mIsOpen = !(mFile.fail());
-
-                mStart = FileParser::iterator_type(mFile);
-                mEnd   = FileParser::iterator_type();
+                mOrigin = mFile.begin();
+                mStart = mFile.begin();
+                mEnd   = mFile.end();
             }
 
         private:
-            std::ifstream mFile;
+            MappedFile mFile;
         };
 
-        class StringParserRef final : public ParserBaseImpl<std::string::const_iterator>
+        template<class Dialect>
+        class StringParserRef final : public ParserBaseImpl<const char*, Dialect>
         {
         public:
             StringParserRef(const std::string& inString)
-                : ParserBaseImpl<std::string::const_iterator>(inString.cbegin(), inString.cend())
+                : ParserBaseImpl<const char*, Dialect>(inString.data(), inString.data() + inString.size())
             {
-                mIsOpen = true;
+                this->mIsOpen = true;
             }
         };
 
-        class StringParserCopy final : public ParserBaseImpl<std::string::const_iterator>
+        template<class Dialect>
+        class RangeParser final : public ParserBaseImpl<const char*, Dialect>
         {
+        public:
+            RangeParser(const char* inFirst, const char* inLast)
+                : ParserBaseImpl<const char*, Dialect>(inFirst, inLast)
+            {
+                this->mIsOpen = true;
+            }
+        };
+
+        template<class Dialect>
+        class StringParserCopy final : public ParserBaseImpl<const char*, Dialect>
+        {
+            using Base = ParserBaseImpl<const char*, Dialect>;
+            using Base::mOrigin;
+            using Base::mStart;
+            using Base::mEnd;
+            using Base::mIsOpen;
+
         public:
             StringParserCopy(const std::string& inString)
                 : mString(inString)
             {
-                mStart = mString.cbegin();
-                mEnd   = mString.cend();
+                mOrigin = mString.data();
+                mStart = mString.data();
+                mEnd   = mString.data() + mString.size();
                 mIsOpen = true;
             }
 
@@ -535,6 +3506,10 @@ namespace pml{
         * @brief Composit member of implementation.
         */
         std::unique_ptr<ParserBase> mParser;
+
+        // the first record of dialects with headers.
+        std::vector<std::string> mHeader;
+        bool mHasHeader;
     };
 
 } // pml
@@ -0,0 +1,122 @@
+#ifndef UTILITY_CSV_RECORD_H
+#define UTILITY_CSV_RECORD_H
+
+/**
+* @file
+* public header provided by PML.
+*
+* @brief
+* One record of CSV data stored in a contiguous character buffer.
+*/
+
+#include <PML/Core/exception_handler.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pml {
+
+    class CSVParser;
+
+    /**
+    * @class CSVRecord
+    *
+    * @brief
+    * Fields of one record read by CSVParser::readNextOneRecord(CSVRecord&).
+    * The characters of all fields are appended to one buffer and each field is an offset and a size in it,
+    * so that no string is allocated per field.
+    * Both buffers keep their capacities when the record is read again,
+    * and reading records into the same object allocates nothing once they are as large as the longest record.
+    *
+    * @code
+    * pml::CSVRecord lRecord;
+    * while (lParser.readNextOneRecord(lRecord)) {
+    *     const std::string_view lName = lRecord[0];
+    * }
+    * @endcode
+    */
+    class CSVRecord final
+    {
+    public:
+        CSVRecord() = default;
+
+        CSVRecord(const CSVRecord&)            = default;
+        CSVRecord(CSVRecord&&)                 = default;
+        CSVRecord& operator=(const CSVRecord&) = default;
+        CSVRecord& operator=(CSVRecord&&)      = default;
+
+        /**
+        * @brief The number of fields.
+        */
+        std::size_t size() const noexcept
+        {
+            return mFields.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return mFields.empty();
+        }
+
+        /**
+        * @brief The inIndex-th field, which is valid until this record is modified.
+        */
+        std::string_view operator[](std::size_t inIndex) const noexcept
+        {
+            const auto& lField = mFields[inIndex];
+            return std::string_view(mCharacters.data() + lField.mOffset, lField.mSize);
+        }
+
+        /**
+        * @brief The inIndex-th field with the bounds checked.
+        */
+        std::string_view at(std::size_t inIndex) const
+        {
+            if (inIndex >= mFields.size()) {
+                PML_THROW_WITH_NESTED(std::out_of_range, "Field " + std::to_string(inIndex) + " is out of the record.");
+            }
+
+            return (*this)[inIndex];
+        }
+
+        /**
+        * @brief Remove all fields keeping the capacities.
+        */
+        void clear() noexcept
+        {
+            mCharacters.clear();
+            mFields.clear();
+        }
+
+        std::vector<std::string> toVector() const
+        {
+            std::vector<std::string> lFields;
+            lFields.reserve(mFields.size());
+
+            for (std::size_t i = 0; i < mFields.size(); ++i) {
+                lFields.emplace_back((*this)[i]);
+            }
+
+            return lFields;
+        }
+
+    private:
+
+        // CSVParser builds records directly in the buffers.
+        friend class CSVParser;
+
+        struct Field final
+        {
+            std::size_t mOffset;
+            std::size_t mSize;
+        };
+
+        std::string mCharacters;
+        std::vector<Field> mFields;
+    };
+
+} // pml
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef UTILITY_CSV_RECORD_INDEX_H
+#define UTILITY_CSV_RECORD_INDEX_H
+
+/**
+* @file
+* public header provided by PML.
+*
+* @brief
+* Byte offsets of records of CSV data for random access.
+*/
+
+#include <PML/Core/exception_handler.h>
+#include <PML/Core/MappedFile.h>
+#include <PML/Core/Profiler.h>
+#include <PML/Utility/CSVStructuralIndex.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace pml {
+
+    /**
+    * @class CSVRecordIndex
+    *
+    * @brief
+    * Byte offsets of the beginnings of all records of CSV data, built by one scan of detail::CSVStructuralIndexer,
+    * so that newlines inside double quotations do not split records.
+    * CRLF is a single newline, and a newline at the end of the data does not begin an empty record.
+    * With this index, CSVParser::seekToRecord moves to any record and
+    * CSVParser::readRecordsParallel splits the data exactly at record boundaries without scanning it again.
+    *
+    * The index can be saved to a sidecar file, which records the size and the modification time of the source file.
+    * The layout is, in the native byte order,
+    *   Header,
+    *   std::uint64_t offsets[record number + 1], where the last one is the size of the data.
+    *
+    * @code
+    * pml::CSVRecordIndex lIndex;
+    * if (!lIndex.load("data.csv.idx", "data.csv")) {
+    *     lIndex = pml::CSVRecordIndex("data.csv");
+    *     lIndex.save("data.csv.idx", "data.csv");
+    * }
+    * @endcode
+    */
+    class CSVRecordIndex final
+    {
+    public:
+
+        static constexpr std::uint32_t VERSION = 1;
+
+        /**
+        * @brief Empty index of no records.
+        */
+        CSVRecordIndex()
+            : mOffsets{ 0 }
+        {}
+
+        /**
+        * @brief Index the CSV file inFilePath mapped by MappedFile.
+        */
+        explicit CSVRecordIndex(const std::string& inFilePath)
+        {
+            PML_CATCH_BEGIN
+
+            const MappedFile lFile(inFilePath, MappedFile::AccessHint::Sequential);
+            if (!lFile.isOpen()) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "File " + inFilePath + " cannot be opened.");
+            }
+
+            build(lFile.begin(), lFile.end());
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVRecordIndex construction failed.")
+        }
+
+        /**
+        * @brief Index CSV data in [inFirst, inLast).
+        */
+        CSVRecordIndex(const char* inFirst, const char* inLast)
+        {
+            build(inFirst, inLast);
+        }
+
+        CSVRecordIndex(const CSVRecordIndex&)            = default;
+        CSVRecordIndex(CSVRecordIndex&&)                 = default;
+        CSVRecordIndex& operator=(const CSVRecordIndex&) = default;
+        CSVRecordIndex& operator=(CSVRecordIndex&&)      = default;
+
+        /**
+        * @brief The number of records.
+        */
+        std::size_t size() const noexcept
+        {
+            return mOffsets.size() - 1;
+        }
+
+        bool empty() const noexcept
+        {
+            return (size() == 0);
+        }
+
+        /**
+        * @brief
+        * The byte offset of the beginning of the inRecord-th record.
+        * inRecord == size() gives the size of the data.
+        */
+        std::uint64_t getOffset(std::size_t inRecord) const
+        {
+            if (inRecord > size()) {
+                PML_THROW_WITH_NESTED(std::out_of_range, "Record " + std::to_string(inRecord) + " is out of the index.");
+            }
+
+            return mOffsets[inRecord];
+        }
+
+        /**
+        * @brief The size of the indexed data in bytes.
+        */
+        std::uint64_t getDataSize() const noexcept
+        {
+            return mOffsets.back();
+        }
+
+        /**
+        * @brief
+        * Load the sidecar file inIndexPath written by save for inSourcePath.
+        * If the file does not exist, is broken or is stale, this index is not changed.
+        *
+        * @return Whether the index has been loaded or not.
+        */
+        bool load(const std::string& inIndexPath, const std::string& inSourcePath)
+        {
+            PML_PROFILE_SCOPE("pml::CSVRecordIndex::load");
+
+            std::uint64_t lSize = 0;
+            std::int64_t lTime = 0;
+            if (!MappedFile::getStatus(inSourcePath, lSize, lTime)) {
+                return false;
+            }
+
+            std::ifstream lFile(inIndexPath, std::ios::in | std::ios::binary);
+
+            Header lHeader{};
+            if (!lFile.read(reinterpret_cast<char*>(&lHeader), sizeof(Header))) {
+                return false;
+            }
+
+            if ((std::memcmp(lHeader.mMagic, MAGIC, sizeof(lHeader.mMagic)) != 0) || (lHeader.mVersion != VERSION)
+                || (lHeader.mSourceSize != lSize) || (lHeader.mSourceTime != lTime)) {
+                return false;
+            }
+
+            // the number is checked against the file size before allocation so that broken headers cannot exhaust memory.
+            std::error_code lError;
+            const auto lFileSize = std::filesystem::file_size(inIndexPath, lError);
+            if (lError || ((lFileSize - sizeof(Header)) / sizeof(std::uint64_t) != lHeader.mRecordNumber + 1)
+                || ((lFileSize - sizeof(Header)) % sizeof(std::uint64_t) != 0)) {
+                return false;
+            }
+
+            std::vector<std::uint64_t> lOffsets(static_cast<std::size_t>(lHeader.mRecordNumber + 1));
+            if (!lFile.read(reinterpret_cast<char*>(lOffsets.data()), static_cast<std::streamsize>(lOffsets.size() * sizeof(std::uint64_t)))) {
+                return false;
+            }
+
+            if ((lOffsets.front() != 0) || (lOffsets.back() != lSize) || !std::is_sorted(lOffsets.cbegin(), lOffsets.cend())) {
+                return false;
+            }
+
+            mOffsets = std::move(lOffsets);
+
+            return true;
+        }
+
+        /**
+        * @brief
+        * Write this index of inSourcePath into the sidecar file inIndexPath.
+        * The file is written to a temporary file and renamed, so that readers never load a partial file.
+        */
+        void save(const std::string& inIndexPath, const std::string& inSourcePath) const
+        {
+            PML_CATCH_BEGIN
+
+            PML_PROFILE_SCOPE("pml::CSVRecordIndex::save");
+
+            Header lHeader{};
+            std::memcpy(lHeader.mMagic, MAGIC, sizeof(lHeader.mMagic));
+            lHeader.mVersion = VERSION;
+            lHeader.mRecordNumber = size();
+
+            if (!MappedFile::getStatus(inSourcePath, lHeader.mSourceSize, lHeader.mSourceTime)) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "Source " + inSourcePath + " does not exist.");
+            }
+
+            if (lHeader.mSourceSize != getDataSize()) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "Source " + inSourcePath + " is not the indexed data.");
+            }
+
+            detail::replace_file(inIndexPath, {
+                std::string_view(reinterpret_cast<const char*>(&lHeader), sizeof(Header)),
+                std::string_view(reinterpret_cast<const char*>(mOffsets.data()), mOffsets.size() * sizeof(std::uint64_t)) });
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVRecordIndex::save failed.")
+        }
+
+    private:
+
+        static constexpr char MAGIC[8] = { 'P', 'M', 'L', 'C', 'S', 'V', 'R', 'I' };
+
+        struct Header final
+        {
+            char mMagic[8];
+            std::uint32_t mVersion;
+            std::uint32_t mReserved;
+            std::uint64_t mSourceSize;
+            std::int64_t mSourceTime;
+            std::uint64_t mRecordNumber;
+        };
+
+        void build(const char* inFirst, const char* inLast)
+        {
+            PML_PROFILE_SCOPE("pml::CSVRecordIndex::build");
+
+            using Indexer = detail::CSVStructuralIndexer;
+
+            // structural characters are flattened chunk by chunk so that their buffer stays small for large files.
+            constexpr std::ptrdiff_t lChunkSize = std::ptrdiff_t(1) << 20;
+
+            const auto lKernel = Indexer::getOptimalKernel();
+            std::vector<const char*> lStructurals;
+            bool lIsInQuotes = false;
+
+            mOffsets.assign(1, 0);
+
+            for (auto lChunk = inFirst; lChunk < inLast; )
+            {
+                const auto lChunkLast = ((inLast - lChunk) > lChunkSize) ? (lChunk + lChunkSize) : inLast;
+
+                lStructurals.clear();
+                lIsInQuotes = Indexer::index(lKernel, lChunk, lChunkLast, lIsInQuotes, lStructurals);
+
+                for (const auto* structural_i : lStructurals)
+                {
+                    // LF of CRLF is skipped, since a structural LF after CR means the CR is outside double quotations too.
+                    if ((*structural_i == '\n') && (structural_i != inFirst) && (*(structural_i - 1) == '\r')) {
+                        continue;
+                    }
+
+                    if ((*structural_i != '\r') && (*structural_i != '\n')) {
+                        continue;
+                    }
+
+                    auto lNext = structural_i + 1;
+                    if ((*structural_i == '\r') && (lNext != inLast) && (*lNext == '\n')) {
+                        ++lNext;
+                    }
+
+                    if (lNext != inLast) {
+                        mOffsets.push_back(static_cast<std::uint64_t>(lNext - inFirst));
+                    }
+                }
+
+                lChunk = lChunkLast;
+            }
+
+            if (inFirst == inLast) {
+                return;
+            }
+
+            mOffsets.push_back(static_cast<std::uint64_t>(inLast - inFirst));
+        }
+
+        std::vector<std::uint64_t> mOffsets;
+    };
+
+} // pml
+
+#endif
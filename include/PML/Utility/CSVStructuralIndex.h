@@ -0,0 +1,286 @@
+#ifndef UTILITY_CSV_STRUCTURAL_INDEX_H
+#define UTILITY_CSV_STRUCTURAL_INDEX_H
+
+/**
+* @file
+* public header provided by PML.
+*
+* @brief
+* SIMD scanner of structural characters of CSV data.
+*/
+
+#include <PML/Core/CPUDispatcher.h>
+#include <PML/Core/cross_intrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace pml {
+    namespace detail {
+
+        /**
+        * @brief Bit masks of one 64-byte block, where the i-th bit corresponds to the i-th byte.
+        */
+        struct CSVBlockMasks final
+        {
+            std::uint64_t mQuote;     // double quotations.
+            std::uint64_t mSeparator; // delimiters, CR and LF.
+        };
+
+        template<char Delimiter = ',', char Quote = '\"'>
+        inline CSVBlockMasks scan_block_scalar(const char* inBlock)
+        {
+            CSVBlockMasks lMasks{ 0, 0 };
+
+            for (std::size_t i = 0; i < 64; ++i)
+            {
+                const auto lc = inBlock[i];
+                lMasks.mQuote     |= static_cast<std::uint64_t>(lc == Quote) << i;
+                lMasks.mSeparator |= static_cast<std::uint64_t>((lc == Delimiter) || (lc == '\r') || (lc == '\n')) << i;
+            }
+
+            return lMasks;
+        }
+
+        /**
+        * @brief The i-th bit of the result is the XOR of the 0th,...,i-th bits of inX.
+        */
+        inline std::uint64_t prefix_xor_scalar(std::uint64_t inX)
+        {
+            inX ^= inX << 1;
+            inX ^= inX << 2;
+            inX ^= inX << 4;
+            inX ^= inX << 8;
+            inX ^= inX << 16;
+            inX ^= inX << 32;
+
+            return inX;
+        }
+
+        /**
+        * @brief prefix_xor_scalar by one carry-less multiplication with all ones.
+        */
+        PML_TARGET_AVX2_PCLMUL
+        inline std::uint64_t prefix_xor_CLMUL(std::uint64_t inX)
+        {
+            const __m128i lProduct = _mm_clmulepi64_si128(
+                _mm_set_epi64x(0, static_cast<long long>(inX)), _mm_set1_epi8(static_cast<char>(0xFF)), 0);
+
+            std::uint64_t lResult;
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&lResult), lProduct);
+
+            return lResult;
+        }
+
+        PML_TARGET_AVX2_PCLMUL
+        inline std::uint64_t cmpeq_mask_AVX2(__m256i inLow, __m256i inHigh, char inChar)
+        {
+            const __m256i lChar = _mm256_set1_epi8(inChar);
+            const auto lLow  = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(inLow,  lChar)));
+            const auto lHigh = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(inHigh, lChar)));
+
+            return static_cast<std::uint64_t>(lLow) | (static_cast<std::uint64_t>(lHigh) << 32);
+        }
+
+        template<char Delimiter = ',', char Quote = '\"'>
+        PML_TARGET_AVX2_PCLMUL
+        inline CSVBlockMasks scan_block_AVX2(const char* inBlock)
+        {
+            const __m256i lLow  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBlock));
+            const __m256i lHigh = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBlock + 32));
+
+            return CSVBlockMasks{
+                cmpeq_mask_AVX2(lLow, lHigh, Quote),
+                cmpeq_mask_AVX2(lLow, lHigh, Delimiter) | cmpeq_mask_AVX2(lLow, lHigh, '\r') | cmpeq_mask_AVX2(lLow, lHigh, '\n') };
+        }
+
+        template<char Delimiter = ',', char Quote = '\"'>
+        PML_TARGET_AVX512BW_PCLMUL
+        inline CSVBlockMasks scan_block_AVX512BW(const char* inBlock)
+        {
+            const __m512i lBlock = _mm512_loadu_si512(inBlock);
+
+            return CSVBlockMasks{
+                static_cast<std::uint64_t>(_mm512_cmpeq_epi8_mask(lBlock, _mm512_set1_epi8(Quote))),
+                static_cast<std::uint64_t>(
+                    _mm512_cmpeq_epi8_mask(lBlock, _mm512_set1_epi8(Delimiter)) |
+                    _mm512_cmpeq_epi8_mask(lBlock, _mm512_set1_epi8('\r')) |
+                    _mm512_cmpeq_epi8_mask(lBlock, _mm512_set1_epi8('\n'))) };
+        }
+
+        /**
+        * @class CSVStructuralIndexer
+        *
+        * @brief
+        * Scanner finding structural characters of CSV data 64 bytes at a time, in the style of simdjson/simdcsv.
+        * Structural characters are all double quotations and the commas, CR and LF outside double quotations.
+        * The regions inside double quotations are given by the prefix XOR of the quotation bits,
+        * computed by one carry-less multiplication, where escaped "" toggles the state twice and has no effect.
+        * The state at the end of each block is carried to the next one.
+        * The delimiter and the quotation character are template parameters of index, see CSVDialect,
+        * so that each dialect has its own kernels without branches on them.
+        */
+        class CSVStructuralIndexer final
+        {
+        public:
+
+            /**
+            * @brief Block scanners.
+            */
+            enum class Kernel
+            {
+                Scalar,
+                AVX2,
+                AVX512BW,
+            };
+
+            /**
+            * @brief
+            * The fastest kernel supported by the runtime CPU.
+            * CPUDispatcher::isAVX2 and isAVX512BW also require the OS to save the YMM or ZMM registers, checked by XGETBV.
+            */
+            static Kernel getOptimalKernel()
+            {
+                if (CPUDispatcher::isPCLMULQDQ())
+                {
+                    if (CPUDispatcher::isAVX512BW()) {
+                        return Kernel::AVX512BW;
+                    }
+
+                    if (CPUDispatcher::isAVX2()) {
+                        return Kernel::AVX2;
+                    }
+                }
+
+                return Kernel::Scalar;
+            }
+
+            /**
+            * @brief
+            * Append the positions of structural characters in [inFirst, inLast) to outStructurals in ascending order.
+            * Delimiter and Quote must be neither '\0', CR nor LF.
+            *
+            * @param[in] inIsInQuotes
+            * Whether inFirst is inside double quotations.
+            *
+            * @return
+            * Whether inLast is inside double quotations.
+            */
+            template<char Delimiter = ',', char Quote = '\"'>
+            static bool index(
+                Kernel inKernel,
+                const char* inFirst,
+                const char* inLast,
+                bool inIsInQuotes,
+                std::vector<const char*>& outStructurals)
+            {
+                switch (inKernel)
+                {
+                case Kernel::AVX512BW:
+                    return index_AVX512BW<Delimiter, Quote>(inFirst, inLast, inIsInQuotes, outStructurals);
+                case Kernel::AVX2:
+                    return index_AVX2<Delimiter, Quote>(inFirst, inLast, inIsInQuotes, outStructurals);
+                default:
+                    return index_scalar<Delimiter, Quote>(inFirst, inLast, inIsInQuotes, outStructurals);
+                }
+            }
+
+        private:
+
+            /**
+            * @brief Append structural positions of one block of inLength (<= 64) bytes and update the quotation state.
+            */
+            static void flatten(
+                const CSVBlockMasks& inMasks,
+                std::uint64_t inPrefixXor,
+                const char* inBlock,
+                std::size_t inLength,
+                std::uint64_t& inoutQuoteCarry,
+                std::vector<const char*>& outStructurals)
+            {
+                const auto lValid  = (inLength == 64) ? ~std::uint64_t(0) : ((std::uint64_t(1) << inLength) - 1);
+                const auto lInside = inPrefixXor ^ inoutQuoteCarry;
+
+                auto lBits = (inMasks.mQuote | (inMasks.mSeparator & ~lInside)) & lValid;
+
+                // all ones if the last byte is inside double quotations.
+                inoutQuoteCarry = static_cast<std::uint64_t>(0) - (lInside >> 63);
+
+                while (lBits != 0)
+                {
+                    outStructurals.push_back(inBlock + count_trailing_zeros(lBits));
+                    lBits &= (lBits - 1);
+                }
+            }
+
+            /**
+            * @brief Copy the last partial block into a zero-filled buffer of 64 bytes, which has no structural characters.
+            */
+            static const char* pad(const char* inFirst, std::size_t inLength, char* outBuffer)
+            {
+                std::memset(outBuffer, 0, 64);
+                std::memcpy(outBuffer, inFirst, inLength);
+
+                return outBuffer;
+            }
+
+            template<char Delimiter, char Quote>
+            static bool index_scalar(const char* inFirst, const char* inLast, bool inIsInQuotes, std::vector<const char*>& outStructurals)
+            {
+                std::uint64_t lCarry = inIsInQuotes ? ~std::uint64_t(0) : 0;
+                char lBuffer[64];
+
+                for (auto lBlock = inFirst; lBlock < inLast; lBlock += 64)
+                {
+                    const auto lLength = std::min<std::size_t>(64, static_cast<std::size_t>(inLast - lBlock));
+                    const auto lMasks  = scan_block_scalar<Delimiter, Quote>((lLength == 64) ? lBlock : pad(lBlock, lLength, lBuffer));
+
+                    flatten(lMasks, prefix_xor_scalar(lMasks.mQuote), lBlock, lLength, lCarry, outStructurals);
+                }
+
+                return (lCarry != 0);
+            }
+
+            template<char Delimiter, char Quote>
+            PML_TARGET_AVX2_PCLMUL
+            static bool index_AVX2(const char* inFirst, const char* inLast, bool inIsInQuotes, std::vector<const char*>& outStructurals)
+            {
+                std::uint64_t lCarry = inIsInQuotes ? ~std::uint64_t(0) : 0;
+                char lBuffer[64];
+
+                for (auto lBlock = inFirst; lBlock < inLast; lBlock += 64)
+                {
+                    const auto lLength = std::min<std::size_t>(64, static_cast<std::size_t>(inLast - lBlock));
+                    const auto lMasks  = scan_block_AVX2<Delimiter, Quote>((lLength == 64) ? lBlock : pad(lBlock, lLength, lBuffer));
+
+                    flatten(lMasks, prefix_xor_CLMUL(lMasks.mQuote), lBlock, lLength, lCarry, outStructurals);
+                }
+
+                return (lCarry != 0);
+            }
+
+            template<char Delimiter, char Quote>
+            PML_TARGET_AVX512BW_PCLMUL
+            static bool index_AVX512BW(const char* inFirst, const char* inLast, bool inIsInQuotes, std::vector<const char*>& outStructurals)
+            {
+                std::uint64_t lCarry = inIsInQuotes ? ~std::uint64_t(0) : 0;
+                char lBuffer[64];
+
+                for (auto lBlock = inFirst; lBlock < inLast; lBlock += 64)
+                {
+                    const auto lLength = std::min<std::size_t>(64, static_cast<std::size_t>(inLast - lBlock));
+                    const auto lMasks  = scan_block_AVX512BW<Delimiter, Quote>((lLength == 64) ? lBlock : pad(lBlock, lLength, lBuffer));
+
+                    flatten(lMasks, prefix_xor_CLMUL(lMasks.mQuote), lBlock, lLength, lCarry, outStructurals);
+                }
+
+                return (lCarry != 0);
+            }
+        };
+
+    } // detail
+} // pml
+
+#endif
@@ -0,0 +1,405 @@
+#ifndef UTILITY_CSV_TABLE_H
+#define UTILITY_CSV_TABLE_H
+
+/**
+* @file
+* public header provided by PML.
+*
+* @brief
+* Keyed table of CSV data in contiguous storage with an open-addressing hash.
+*/
+
+#include <PML/Core/exception_handler.h>
+#include <PML/Core/MappedFile.h>
+#include <PML/Core/Profiler.h>
+#include <PML/Utility/CSVParser.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pml {
+
+    /**
+    * @class CSVTable
+    *
+    * @brief
+    * Table of CSVParser::readTable stored without a std::string nor a std::vector per key.
+    * The characters of all keys and values are appended to one buffer reserved by the size of the file,
+    * and each key refers to a contiguous range of field slots, which are offsets into the buffer.
+    * Keys are interned into an open-addressing hash table of linear probing, which holds only the indices of keys,
+    * so that lookups compare a cached hash before the characters and never allocate.
+    * The number of records is estimated by a first pass counting newlines of the mapped file,
+    * which reserves the field slots before parsing.
+    * As std::unordered_map::emplace of readTable, the first one of duplicated keys is kept.
+    *
+    * @code
+    * const pml::CSVTable lTable("table.csv", true);
+    * const auto lValues = lTable.at("key");
+    * @endcode
+    */
+    class CSVTable final
+    {
+    public:
+
+        /**
+        * @brief Values of one key.
+        */
+        class Values final
+        {
+        public:
+            Values() noexcept
+                : mTable(nullptr), mFirst(0), mSize(0)
+            {}
+
+            Values(const CSVTable* inTable, std::size_t inFirst, std::size_t inSize) noexcept
+                : mTable(inTable), mFirst(inFirst), mSize(inSize)
+            {}
+
+            std::size_t size() const noexcept
+            {
+                return mSize;
+            }
+
+            bool empty() const noexcept
+            {
+                return (mSize == 0);
+            }
+
+            std::string_view operator[](std::size_t inIndex) const
+            {
+                return mTable->getField(mFirst + inIndex);
+            }
+
+            std::vector<std::string> toVector() const
+            {
+                std::vector<std::string> lValues;
+                lValues.reserve(mSize);
+
+                for (std::size_t i = 0; i < mSize; ++i) {
+                    lValues.emplace_back((*this)[i]);
+                }
+
+                return lValues;
+            }
+
+        private:
+            const CSVTable* mTable;
+            std::size_t mFirst;
+            std::size_t mSize;
+        };
+
+        /**
+        * @brief Read the CSV file inFilePath as CSVParser::readTable(inFilePath, inIsColumnKey).
+        *
+        * @param[in] inIsColumnKey
+        * Whether the first column is keys or not.
+        * If this is false, the first row is interpreted as keys.
+        */
+        CSVTable(const std::string& inFilePath, bool inIsColumnKey)
+        {
+            PML_CATCH_BEGIN
+
+            PML_PROFILE_SCOPE("pml::CSVTable::load");
+
+            std::size_t lRecordNumber = 0;
+            {
+                const MappedFile lFile(inFilePath, MappedFile::AccessHint::Sequential);
+                if (!lFile.isOpen()) {
+                    PML_THROW_WITH_NESTED(std::runtime_error, "File " + inFilePath + " cannot be opened.");
+                }
+
+                // unescaped fields are never longer than the file.
+                mCharacters.reserve(lFile.size());
+                lRecordNumber = estimateRecordNumber(lFile.begin(), lFile.end());
+            }
+
+            CSVParser lParser(CSVParser::InputType::MMAP, inFilePath);
+
+            if (inIsColumnKey) {
+                loadRows(lParser, lRecordNumber);
+            }
+            else {
+                loadColumns(lParser, lRecordNumber);
+            }
+
+            buildHash();
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVTable construction failed.")
+        }
+
+        CSVTable(const CSVTable&)            = delete;
+        CSVTable(CSVTable&&)                 = default;
+        CSVTable& operator=(const CSVTable&) = delete;
+        CSVTable& operator=(CSVTable&&)      = default;
+
+        /**
+        * @brief The number of keys.
+        */
+        std::size_t size() const noexcept
+        {
+            return mKeys.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return mKeys.empty();
+        }
+
+        /**
+        * @brief The inIndex-th key in the order of the file.
+        */
+        std::string_view getKey(std::size_t inIndex) const
+        {
+            return getField(mKeys[inIndex].mName);
+        }
+
+        /**
+        * @brief Values of the inIndex-th key.
+        */
+        Values getValues(std::size_t inIndex) const
+        {
+            return Values(this, mKeys[inIndex].mFirst, mKeys[inIndex].mSize);
+        }
+
+        /**
+        * @brief The index of inKey, or size() if not found.
+        */
+        std::size_t find(std::string_view inKey) const
+        {
+            if (mBuckets.empty()) {
+                return size();
+            }
+
+            const auto lHash = getHash(inKey);
+            const auto lMask = mBuckets.size() - 1;
+
+            for (auto lBucket = static_cast<std::size_t>(lHash) & lMask; ; lBucket = (lBucket + 1) & lMask)
+            {
+                const auto lIndex = mBuckets[lBucket];
+                if (lIndex == EMPTY) {
+                    return size();
+                }
+
+                if ((mKeys[lIndex].mHash == lHash) && (getKey(lIndex) == inKey)) {
+                    return lIndex;
+                }
+            }
+        }
+
+        bool contains(std::string_view inKey) const
+        {
+            return (find(inKey) != size());
+        }
+
+        /**
+        * @brief Values of inKey, which must exist.
+        */
+        Values at(std::string_view inKey) const
+        {
+            const auto lIndex = find(inKey);
+            if (lIndex == size()) {
+                PML_THROW_WITH_NESTED(std::out_of_range, "Key " + std::string(inKey) + " does not exist in the table.");
+            }
+
+            return getValues(lIndex);
+        }
+
+    private:
+
+        static constexpr std::uint32_t EMPTY = ~std::uint32_t(0);
+
+        struct Field final
+        {
+            std::size_t mOffset;
+            std::size_t mSize;
+        };
+
+        struct Key final
+        {
+            std::size_t mName;  // slot of the key
+            std::size_t mFirst; // slot of the first value
+            std::size_t mSize;  // number of values
+            std::uint64_t mHash;
+        };
+
+        /**
+        * @brief FNV-1a.
+        */
+        static std::uint64_t getHash(std::string_view inKey) noexcept
+        {
+            std::uint64_t lHash = 14695981039346656037ULL;
+            for (const auto c : inKey)
+            {
+                lHash ^= static_cast<unsigned char>(c);
+                lHash *= 1099511628211ULL;
+            }
+
+            // the lower bits select buckets.
+            return lHash ^ (lHash >> 32);
+        }
+
+        /**
+        * @brief An estimate of the number of records, which is exact for a single kind of newline unless fields contain newlines.
+        */
+        static std::size_t estimateRecordNumber(const char* inFirst, const char* inLast) noexcept
+        {
+            std::size_t lLF = 0;
+            std::size_t lCR = 0;
+
+            for (auto lit = inFirst; lit != inLast; ++lit)
+            {
+                lLF += (*lit == '\n') ? 1 : 0;
+                lCR += (*lit == '\r') ? 1 : 0;
+            }
+
+            return std::max(lLF, lCR) + 1;
+        }
+
+        std::string_view getField(std::size_t inSlot) const
+        {
+            const auto& lField = mFields[inSlot];
+            return std::string_view(mCharacters.data() + lField.mOffset, lField.mSize);
+        }
+
+        void pushField(std::string_view inField)
+        {
+            mFields.push_back(Field{ mCharacters.size(), inField.size() });
+            mCharacters.append(inField.data(), inField.size());
+        }
+
+        /**
+        * @brief The first field of each record is a key and the following ones are its values.
+        */
+        void loadRows(CSVParser& inoutParser, std::size_t inRecordNumber)
+        {
+            std::vector<std::string_view> lFields;
+
+            mKeys.reserve(inRecordNumber);
+
+            while (inoutParser.readNextOneRecordView(lFields))
+            {
+                if (lFields.empty()) {
+                    continue;
+                }
+
+                if (mFields.empty()) {
+                    mFields.reserve(inRecordNumber * lFields.size());
+                }
+
+                const auto lName = mFields.size();
+                for (const auto& field_i : lFields) {
+                    pushField(field_i);
+                }
+
+                mKeys.push_back(Key{ lName, lName + 1, lFields.size() - 1, getHash(lFields.front()) });
+            }
+        }
+
+        /**
+        * @brief
+        * The first record is keys and the following ones are their values.
+        * Fields are stored in the order of records, and their slots are transposed at last,
+        * so that the values of each key are contiguous.
+        */
+        void loadColumns(CSVParser& inoutParser, std::size_t inRecordNumber)
+        {
+            std::vector<std::string_view> lFields;
+
+            if (!inoutParser.readNextOneRecordView(lFields)) {
+                return;
+            }
+
+            const auto lColumnNumber = lFields.size();
+            for (const auto& field_i : lFields) {
+                pushField(field_i);
+            }
+
+            mFields.reserve(inRecordNumber * lColumnNumber);
+
+            std::size_t lRowNumber = 0;
+            while (inoutParser.readNextOneRecordView(lFields))
+            {
+                if (lFields.size() != lColumnNumber) {
+                    PML_THROW_WITH_NESTED(std::runtime_error, "Record size is unmatched with the key size.");
+                }
+
+                for (const auto& field_i : lFields) {
+                    pushField(field_i);
+                }
+
+                ++lRowNumber;
+            }
+
+            std::vector<Field> lTransposed(mFields.size());
+            std::copy(mFields.cbegin(), mFields.cbegin() + static_cast<std::ptrdiff_t>(lColumnNumber), lTransposed.begin());
+
+            for (std::size_t row_i = 0; row_i < lRowNumber; ++row_i)
+            {
+                for (std::size_t column_i = 0; column_i < lColumnNumber; ++column_i) {
+                    lTransposed[lColumnNumber + column_i * lRowNumber + row_i] = mFields[lColumnNumber + row_i * lColumnNumber + column_i];
+                }
+            }
+
+            mFields = std::move(lTransposed);
+
+            mKeys.reserve(lColumnNumber);
+            for (std::size_t i = 0; i < lColumnNumber; ++i) {
+                mKeys.push_back(Key{ i, lColumnNumber + i * lRowNumber, lRowNumber, getHash(getField(i)) });
+            }
+        }
+
+        /**
+        * @brief Intern the keys into mBuckets of at most half load, dropping the later ones of duplicated keys.
+        */
+        void buildHash()
+        {
+            if (mKeys.size() >= EMPTY / 2) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "Too many keys.");
+            }
+
+            std::size_t lBucketNumber = 16;
+            while (lBucketNumber < 2 * mKeys.size()) {
+                lBucketNumber *= 2;
+            }
+
+            mBuckets.assign(lBucketNumber, EMPTY);
+            const auto lMask = lBucketNumber - 1;
+
+            std::size_t lKeyNumber = 0;
+            for (std::size_t i = 0; i < mKeys.size(); ++i)
+            {
+                const auto lName = getField(mKeys[i].mName);
+                auto lBucket = static_cast<std::size_t>(mKeys[i].mHash) & lMask;
+
+                for (; mBuckets[lBucket] != EMPTY; lBucket = (lBucket + 1) & lMask)
+                {
+                    const auto& lKey = mKeys[mBuckets[lBucket]];
+                    if ((lKey.mHash == mKeys[i].mHash) && (getField(lKey.mName) == lName)) {
+                        break;
+                    }
+                }
+
+                if (mBuckets[lBucket] != EMPTY) {
+                    continue;
+                }
+
+                mKeys[lKeyNumber] = mKeys[i];
+                mBuckets[lBucket] = static_cast<std::uint32_t>(lKeyNumber++);
+            }
+
+            mKeys.resize(lKeyNumber);
+            mKeys.shrink_to_fit();
+        }
+
+        std::string mCharacters;
+        std::vector<Field> mFields;
+        std::vector<Key> mKeys;
+        std::vector<std::uint32_t> mBuckets;
+    };
+
+} // pml
+
+#endif
@@ -0,0 +1,422 @@
+#ifndef UTILITY_CSV_TABLE_CACHE_H
+#define UTILITY_CSV_TABLE_CACHE_H
+
+/**
+* @file
+* public header provided by PML.
+*
+* @brief
+* Binary columnar cache of tables read by CSVParser::readTable.
+*/
+
+#include <PML/Core/exception_handler.h>
+#include <PML/Core/MappedFile.h>
+#include <PML/Core/Profiler.h>
+#include <PML/Utility/CSVParser.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pml {
+
+    /**
+    * @class CSVTableCache
+    *
+    * @brief
+    * Read-only view of a table of CSVParser::readTable serialized by CSVTableCache::write.
+    * The cache file is mapped by MappedFile and its keys and values are returned as std::string_view of the mapping,
+    * so that loading does not parse nor copy anything.
+    * The file records the size and the modification time of the source CSV file and a checksum of its contents.
+    * Opening checks only the header, the sizes and the bounds of the offsets, so that its cost does not depend on the size of the table;
+    * the checksum is verified by verify() and by prepare().
+    *
+    * The layout is, in the native byte order,
+    *   Header,
+    *   std::uint64_t value ranges[key number + 1] in units of strings,
+    *   std::uint64_t string offsets[string number + 1] in bytes,
+    *   characters of all keys in ascending order followed by all values of each key.
+    *
+    * @code
+    * pml::CSVTableCache::prepare("table.csv", true, "table.csv.cache");
+    * pml::CSVTableCache lCache("table.csv.cache");
+    * const auto lValues = lCache.at("key");
+    * @endcode
+    */
+    class CSVTableCache final
+    {
+    public:
+
+        static constexpr std::uint32_t VERSION = 1;
+
+        /**
+        * @brief Values of one key.
+        */
+        class Values final
+        {
+        public:
+            Values() noexcept
+                : mCache(nullptr), mFirst(0), mSize(0)
+            {}
+
+            Values(const CSVTableCache* inCache, std::size_t inFirst, std::size_t inSize) noexcept
+                : mCache(inCache), mFirst(inFirst), mSize(inSize)
+            {}
+
+            std::size_t size() const noexcept
+            {
+                return mSize;
+            }
+
+            bool empty() const noexcept
+            {
+                return (mSize == 0);
+            }
+
+            std::string_view operator[](std::size_t inIndex) const
+            {
+                return mCache->getString(mFirst + inIndex);
+            }
+
+            std::vector<std::string> toVector() const
+            {
+                std::vector<std::string> lValues;
+                lValues.reserve(mSize);
+
+                for (std::size_t i = 0; i < mSize; ++i) {
+                    lValues.emplace_back((*this)[i]);
+                }
+
+                return lValues;
+            }
+
+        private:
+            const CSVTableCache* mCache;
+            std::size_t mFirst;
+            std::size_t mSize;
+        };
+
+        /**
+        * @brief
+        * Map the cache file inCachePath. If the file is truncated, of another version or its offsets are out of bounds, isValid() returns false.
+        * The characters are not read.
+        */
+        explicit CSVTableCache(const std::string& inCachePath)
+            : mFile(inCachePath, MappedFile::AccessHint::Random), mHeader(), mIsValid(false)
+        {
+            PML_PROFILE_SCOPE("pml::CSVTableCache::load");
+
+            if (!mFile.isOpen() || (mFile.size() < sizeof(Header))) {
+                return;
+            }
+
+            std::memcpy(&mHeader, mFile.data(), sizeof(Header));
+
+            if ((std::memcmp(mHeader.mMagic, MAGIC, sizeof(mHeader.mMagic)) != 0) || (mHeader.mVersion != VERSION)) {
+                return;
+            }
+
+            // sizes are checked before multiplications so that broken headers cannot overflow.
+            const auto lRest = (mFile.size() - sizeof(Header)) / sizeof(std::uint64_t);
+            if ((mHeader.mKeyNumber >= lRest) || (mHeader.mStringNumber >= lRest) || (mHeader.mKeyNumber > mHeader.mStringNumber)
+                || (getPayloadSize(mHeader) != mFile.size() - sizeof(Header))) {
+                return;
+            }
+
+            // the ends of both offset arrays; the ones in between are checked when they are read.
+            const auto lKeyNumber = static_cast<std::size_t>(mHeader.mKeyNumber);
+            const auto lStringNumber = static_cast<std::size_t>(mHeader.mStringNumber);
+            mIsValid = (getUInt64(getRangeOffset(0)) == 0)
+                && (getUInt64(getRangeOffset(lKeyNumber)) == mHeader.mStringNumber - mHeader.mKeyNumber)
+                && (getUInt64(getStringOffset(0)) == 0)
+                && (getUInt64(getStringOffset(lStringNumber)) == mHeader.mCharNumber);
+        }
+
+        CSVTableCache(const CSVTableCache&)            = delete;
+        CSVTableCache(CSVTableCache&&)                 = delete;
+        CSVTableCache& operator=(const CSVTableCache&) = delete;
+        CSVTableCache& operator=(CSVTableCache&&)      = delete;
+
+        /**
+        * @brief Whether the cache file is mapped and its header, sizes and offset bounds are consistent.
+        */
+        bool isValid() const noexcept
+        {
+            return mIsValid;
+        }
+
+        /**
+        * @brief Whether the cache is valid and its whole contents are consistent with the checksum. This reads the entire file.
+        */
+        bool verify() const
+        {
+            PML_PROFILE_SCOPE("pml::CSVTableCache::verify");
+
+            return mIsValid && (getChecksum(mFile.data() + sizeof(Header), mFile.size() - sizeof(Header)) == mHeader.mChecksum);
+        }
+
+        /**
+        * @brief Whether the cache is valid and was written from inSourcePath of the present size and modification time.
+        */
+        bool isFresh(const std::string& inSourcePath, bool inIsColumnKey) const
+        {
+            std::uint64_t lSize = 0;
+            std::int64_t lTime = 0;
+
+            return mIsValid
+                && (mHeader.mIsColumnKey == (inIsColumnKey ? 1U : 0U))
+                && MappedFile::getStatus(inSourcePath, lSize, lTime)
+                && (mHeader.mSourceSize == lSize)
+                && (mHeader.mSourceTime == lTime);
+        }
+
+        /**
+        * @brief The number of keys.
+        */
+        std::size_t size() const noexcept
+        {
+            return mIsValid ? static_cast<std::size_t>(mHeader.mKeyNumber) : 0;
+        }
+
+        /**
+        * @brief The inIndex-th key in ascending order.
+        */
+        std::string_view getKey(std::size_t inIndex) const
+        {
+            return getString(inIndex);
+        }
+
+        /**
+        * @brief Values of the inIndex-th key.
+        */
+        Values getValues(std::size_t inIndex) const
+        {
+            const auto lFirst = getUInt64(getRangeOffset(inIndex));
+            const auto lLast  = getUInt64(getRangeOffset(inIndex + 1));
+
+            if ((lFirst > lLast) || (lLast > mHeader.mStringNumber - mHeader.mKeyNumber)) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "Values of key " + std::to_string(inIndex) + " are out of the cache.");
+            }
+
+            return Values(this, size() + static_cast<std::size_t>(lFirst), static_cast<std::size_t>(lLast - lFirst));
+        }
+
+        /**
+        * @brief The index of inKey by binary search, or size() if not found.
+        */
+        std::size_t find(std::string_view inKey) const
+        {
+            std::size_t lFirst = 0;
+            std::size_t lLast  = size();
+
+            while (lFirst < lLast)
+            {
+                const auto lMiddle = lFirst + (lLast - lFirst) / 2;
+                if (getKey(lMiddle) < inKey) {
+                    lFirst = lMiddle + 1;
+                }
+                else {
+                    lLast = lMiddle;
+                }
+            }
+
+            return ((lFirst < size()) && (getKey(lFirst) == inKey)) ? lFirst : size();
+        }
+
+        bool contains(std::string_view inKey) const
+        {
+            return (find(inKey) != size());
+        }
+
+        /**
+        * @brief Values of inKey, which must exist.
+        */
+        Values at(std::string_view inKey) const
+        {
+            const auto lIndex = find(inKey);
+            if (lIndex == size()) {
+                PML_THROW_WITH_NESTED(std::out_of_range, "Key " + std::string(inKey) + " does not exist in the cache.");
+            }
+
+            return getValues(lIndex);
+        }
+
+        /**
+        * @brief
+        * Serialize inTable of CSVParser::readTable(inSourcePath, inIsColumnKey) into inCachePath.
+        * The file is written to a temporary file and renamed, so that readers never map a partial file.
+        */
+        template<class Map>
+        static void write(const Map& inTable, const std::string& inSourcePath, bool inIsColumnKey, const std::string& inCachePath)
+        {
+            PML_CATCH_BEGIN
+
+            PML_PROFILE_SCOPE("pml::CSVTableCache::write");
+
+            Header lHeader{};
+            std::memcpy(lHeader.mMagic, MAGIC, sizeof(lHeader.mMagic));
+            lHeader.mVersion = VERSION;
+            lHeader.mIsColumnKey = inIsColumnKey ? 1U : 0U;
+
+            if (!MappedFile::getStatus(inSourcePath, lHeader.mSourceSize, lHeader.mSourceTime)) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "Source " + inSourcePath + " does not exist.");
+            }
+
+            std::vector<const typename Map::value_type*> lEntries;
+            for (const auto& entry_i : inTable) {
+                lEntries.push_back(&entry_i);
+            }
+
+            std::sort(lEntries.begin(), lEntries.end(), [](const auto* inLhs, const auto* inRhs) { return inLhs->first < inRhs->first; });
+
+            std::vector<std::uint64_t> lRanges = { 0 };
+            std::vector<std::uint64_t> lOffsets = { 0 };
+            std::string lCharacters;
+
+            const auto lPush = [&](const std::string& inString)
+            {
+                lCharacters += inString;
+                lOffsets.push_back(lCharacters.size());
+            };
+
+            for (const auto* entry_i : lEntries) {
+                lPush(entry_i->first);
+            }
+
+            for (const auto* entry_i : lEntries)
+            {
+                for (const auto& value_i : entry_i->second) {
+                    lPush(value_i);
+                }
+
+                lRanges.push_back(lOffsets.size() - 1 - lEntries.size());
+            }
+
+            std::string lPayload(
+                reinterpret_cast<const char*>(lRanges.data()), lRanges.size() * sizeof(std::uint64_t));
+            lPayload.append(reinterpret_cast<const char*>(lOffsets.data()), lOffsets.size() * sizeof(std::uint64_t));
+            lPayload += lCharacters;
+
+            lHeader.mKeyNumber    = lEntries.size();
+            lHeader.mStringNumber = lOffsets.size() - 1;
+            lHeader.mCharNumber   = lCharacters.size();
+            lHeader.mChecksum     = getChecksum(lPayload.data(), lPayload.size());
+
+            detail::replace_file(inCachePath, {
+                std::string_view(reinterpret_cast<const char*>(&lHeader), sizeof(Header)), lPayload });
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVTableCache::write failed.")
+        }
+
+        /**
+        * @brief
+        * Parse inSourcePath by CSVParser::readTable and write the cache inCachePath
+        * only if the cache does not exist, is stale or is broken, which is checked by verify().
+        *
+        * @return Whether the cache has been written or not.
+        */
+        static bool prepare(const std::string& inSourcePath, bool inIsColumnKey, const std::string& inCachePath)
+        {
+            PML_CATCH_BEGIN
+
+            {
+                const CSVTableCache lCache(inCachePath);
+                if (lCache.isFresh(inSourcePath, inIsColumnKey) && lCache.verify()) {
+                    return false;
+                }
+            }
+
+            write(CSVParser::readTable(inSourcePath, inIsColumnKey), inSourcePath, inIsColumnKey, inCachePath);
+
+            return true;
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVTableCache::prepare failed.")
+        }
+
+    private:
+
+        static constexpr char MAGIC[8] = { 'P', 'M', 'L', 'C', 'S', 'V', 'T', 'C' };
+
+        struct Header final
+        {
+            char mMagic[8];
+            std::uint32_t mVersion;
+            std::uint32_t mIsColumnKey;
+            std::uint64_t mSourceSize;
+            std::int64_t mSourceTime;
+            std::uint64_t mKeyNumber;
+            std::uint64_t mStringNumber;
+            std::uint64_t mCharNumber;
+            std::uint64_t mChecksum;
+        };
+
+        static std::uint64_t getPayloadSize(const Header& inHeader) noexcept
+        {
+            return (inHeader.mKeyNumber + 1 + inHeader.mStringNumber + 1) * sizeof(std::uint64_t) + inHeader.mCharNumber;
+        }
+
+        /**
+        * @brief FNV-1a applied to 8 bytes at a time, and to the remaining bytes one by one.
+        */
+        static std::uint64_t getChecksum(const char* inData, std::size_t inSize) noexcept
+        {
+            constexpr std::uint64_t lPrime = 1099511628211ULL;
+            std::uint64_t lHash = 14695981039346656037ULL;
+
+            std::size_t i = 0;
+            for (; i + 8 <= inSize; i += 8)
+            {
+                std::uint64_t lWord;
+                std::memcpy(&lWord, inData + i, sizeof(lWord));
+                lHash = (lHash ^ lWord) * lPrime;
+            }
+
+            for (; i < inSize; ++i) {
+                lHash = (lHash ^ static_cast<unsigned char>(inData[i])) * lPrime;
+            }
+
+            return lHash;
+        }
+
+        std::uint64_t getUInt64(std::size_t inOffset) const noexcept
+        {
+            std::uint64_t lValue;
+            std::memcpy(&lValue, mFile.data() + inOffset, sizeof(lValue));
+
+            return lValue;
+        }
+
+        std::size_t getRangeOffset(std::size_t inIndex) const noexcept
+        {
+            return sizeof(Header) + inIndex * sizeof(std::uint64_t);
+        }
+
+        std::size_t getStringOffset(std::size_t inIndex) const noexcept
+        {
+            return sizeof(Header) + static_cast<std::size_t>(mHeader.mKeyNumber + 1 + inIndex) * sizeof(std::uint64_t);
+        }
+
+        std::string_view getString(std::size_t inIndex) const
+        {
+            const auto lCharacters = mFile.data() + sizeof(Header) + static_cast<std::size_t>(mHeader.mKeyNumber + 1 + mHeader.mStringNumber + 1) * sizeof(std::uint64_t);
+            const auto lFirst = getUInt64(getStringOffset(inIndex));
+            const auto lLast  = getUInt64(getStringOffset(inIndex + 1));
+
+            if ((lFirst > lLast) || (lLast > mHeader.mCharNumber)) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "String " + std::to_string(inIndex) + " is out of the cache.");
+            }
+
+            return std::string_view(lCharacters + lFirst, static_cast<std::size_t>(lLast - lFirst));
+        }
+
+        MappedFile mFile;
+        Header mHeader;
+        bool mIsValid;
+    };
+
+} // pml
+
+#endif
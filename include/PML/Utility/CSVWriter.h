@@ -0,0 +1,442 @@
+#ifndef UTILITY_CSV_WRITER_H
+#define UTILITY_CSV_WRITER_H
+
+/**
+* @file
+* public header provided by PML.
+*
+* @brief
+* Buffered writer of CSV files readable by CSVParser.
+*/
+
+#include <PML/Core/exception_handler.h>
+#include <PML/Core/Profiler.h>
+#include <PML/Core/SPSCRing.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace pml {
+
+    /**
+    * @class CSVWriter
+    *
+    * @brief
+    * Writer of CSV files with the quoting rules of CSVParser.
+    * Fields containing commas, double quotations, CR or LF are enclosed in double quotations, where a double quotation is escaped as "",
+    * and other fields are written as they are. Records are terminated by LF.
+    * Numbers are formatted by std::to_chars, which gives the shortest representation read back to the same value.
+    * Output is accumulated into large buffers and written by unbuffered std::fwrite,
+    * optionally on a background thread receiving the buffers through a lock-free ring.
+    *
+    * @code
+    * pml::CSVWriter lWriter("pl.csv");
+    * lWriter.writeRecord(std::vector<std::string>{ "scenario", "pl" });
+    * lWriter.writeColumns(lScenarios, lPLs);
+    * lWriter.close();
+    * @endcode
+    */
+    class CSVWriter final
+    {
+    public:
+
+        /**
+        * @param[in] inFilePath
+        * The path to the target CSV file, which is truncated.
+        *
+        * @param[in] inIsAsync
+        * Whether buffers are written on a background thread or not.
+        *
+        * @param[in] inBufferSize
+        * Bytes of each buffer. If this is zero, 1 MiB is used.
+        */
+        explicit CSVWriter(const std::string& inFilePath, bool inIsAsync = false, std::size_t inBufferSize = 0)
+            : mFilledRing(BUFFER_NUMBER), mFreeRing(BUFFER_NUMBER), mIsFailed(false), mFile(nullptr),
+            mIsAsync(inIsAsync), mIsFirstField(true), mRecordNumber(0)
+        {
+            const auto lBufferSize = (inBufferSize > 0) ? inBufferSize : (std::size_t(1) << 20);
+
+            mBuffer = std::make_unique<Buffer>();
+            mBuffer->mData.resize(lBufferSize);
+
+            mFile = std::fopen(inFilePath.c_str(), "wb");
+            if (!mFile) {
+                return;
+            }
+
+            // the buffers are passed directly to the OS without the buffer of stdio.
+            std::setvbuf(mFile, nullptr, _IONBF, 0);
+
+            if (mIsAsync)
+            {
+                for (std::size_t i = 1; i < BUFFER_NUMBER; ++i)
+                {
+                    auto lBuffer = std::make_unique<Buffer>();
+                    lBuffer->mData.resize(lBufferSize);
+                    mFreeRing.tryPush(std::move(lBuffer));
+                }
+
+                mWriter = std::thread([this]() { write(); });
+            }
+        }
+
+        CSVWriter(const CSVWriter&)            = delete;
+        CSVWriter(CSVWriter&&)                 = delete;
+        CSVWriter& operator=(const CSVWriter&) = delete;
+        CSVWriter& operator=(CSVWriter&&)      = delete;
+
+        /**
+        * @brief Destructor. The remaining data is written and the file is closed here, ignoring errors. Call close() to detect them.
+        */
+        ~CSVWriter()
+        {
+            try {
+                close();
+            }
+            catch (...) {
+            }
+        }
+
+        /**
+        * @brief Whether the file is open or not.
+        */
+        bool isOpen() const noexcept
+        {
+            return (mFile != nullptr);
+        }
+
+        /**
+        * @brief The number of finished records.
+        */
+        std::size_t getRecordNumber() const noexcept
+        {
+            return mRecordNumber;
+        }
+
+        /**
+        * @brief Write one field of the present record, enclosed in double quotations if necessary.
+        */
+        void writeField(std::string_view inField)
+        {
+            beginField();
+
+            if (inField.find_first_of(",\"\r\n") == std::string_view::npos)
+            {
+                append(inField.data(), inField.size());
+                return;
+            }
+
+            const auto lQuoteNumber = static_cast<std::size_t>(std::count(inField.cbegin(), inField.cend(), '\"'));
+            auto* lOut = reserve(inField.size() + lQuoteNumber + 2);
+            const auto* lFirst = lOut;
+
+            *lOut++ = '\"';
+            for (const auto c : inField)
+            {
+                if (c == '\"') {
+                    *lOut++ = '\"';
+                }
+
+                *lOut++ = c;
+            }
+            *lOut++ = '\"';
+
+            mBuffer->mSize += static_cast<std::size_t>(lOut - lFirst);
+        }
+
+        void writeField(const std::string& inField)
+        {
+            writeField(std::string_view(inField));
+        }
+
+        void writeField(const char* inField)
+        {
+            writeField(std::string_view(inField));
+        }
+
+        /**
+        * @brief Write one character as a field of one character.
+        */
+        void writeField(char inField)
+        {
+            writeField(std::string_view(&inField, 1));
+        }
+
+        /**
+        * @brief
+        * Write one number of the present record in the shortest round-trip representation of std::to_chars.
+        * signed char and unsigned char such as std::int8_t are numbers, while char is a character.
+        */
+        template<class T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>, std::nullptr_t> = nullptr>
+        void writeField(T inValue)
+        {
+            beginField();
+
+            // enough for all integers and for the shortest representations of double, such as -2.2250738585072014e-308.
+            constexpr std::size_t lMaxLength = 64;
+
+            auto* lOut = reserve(lMaxLength);
+            const auto lResult = std::to_chars(lOut, lOut + lMaxLength, inValue);
+
+            mBuffer->mSize += static_cast<std::size_t>(lResult.ptr - lOut);
+        }
+
+        /**
+        * @brief Finish the present record.
+        */
+        void endRecord()
+        {
+            checkOpen();
+
+            *reserve(1) = '\n';
+            ++mBuffer->mSize;
+
+            mIsFirstField = true;
+            ++mRecordNumber;
+        }
+
+        /**
+        * @brief Write all elements of inFields as one record.
+        */
+        template<class Container>
+        void writeRecord(const Container& inFields)
+        {
+            for (const auto& field_i : inFields) {
+                writeField(field_i);
+            }
+
+            endRecord();
+        }
+
+        /**
+        * @brief
+        * Write records column by column, where the i-th record consists of the i-th elements of inColumns.
+        * Each column is a contiguous container such as std::vector or pml::aligned_vector of strings or numbers,
+        * and all columns must have the same size.
+        */
+        template<class... Columns>
+        void writeColumns(const Columns&... inColumns)
+        {
+            PML_PROFILE_SCOPE("pml::CSVWriter::writeColumns");
+
+            const std::size_t lSizes[] = { inColumns.size()... };
+            for (const auto size_i : lSizes)
+            {
+                if (size_i != lSizes[0]) {
+                    PML_THROW_WITH_NESTED(std::logic_error, "Columns must have the same size.");
+                }
+            }
+
+            for (std::size_t i = 0; i < lSizes[0]; ++i)
+            {
+                (writeField(inColumns[i]), ...);
+                endRecord();
+            }
+        }
+
+        /**
+        * @brief Pass the buffered data to the OS. In the asynchronous mode, this waits for the background thread.
+        */
+        void flush()
+        {
+            PML_CATCH_BEGIN
+
+            PML_PROFILE_SCOPE("pml::CSVWriter::flush");
+
+            if (!mFile) {
+                return;
+            }
+
+            dispatch();
+
+            if (mIsAsync)
+            {
+                // all buffers come back after they are written, and are kept until the next dispatch.
+                BufferPtr lBuffer;
+                while ((mSpareBuffers.size() + 1 < BUFFER_NUMBER) && mFreeRing.pop(lBuffer)) {
+                    mSpareBuffers.push_back(std::move(lBuffer));
+                }
+            }
+
+            if (std::fflush(mFile) != 0) {
+                mIsFailed.store(true);
+            }
+
+            throwIfFailed();
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVWriter::flush failed.")
+        }
+
+        /**
+        * @brief Write the remaining data and close the file. Nothing is done if the file is already closed.
+        */
+        void close()
+        {
+            PML_CATCH_BEGIN
+
+            if (!mFile) {
+                return;
+            }
+
+            dispatch();
+
+            if (mIsAsync)
+            {
+                mFilledRing.close();
+                mWriter.join();
+            }
+
+            if (std::fclose(mFile) != 0) {
+                mIsFailed.store(true);
+            }
+            mFile = nullptr;
+
+            throwIfFailed();
+
+            PML_CATCH_END_AND_THROW(std::runtime_error, "CSVWriter::close failed.")
+        }
+
+    private:
+
+        static constexpr std::size_t BUFFER_NUMBER = 4;
+
+        struct Buffer final
+        {
+            std::vector<char> mData;
+            std::size_t mSize = 0;
+        };
+
+        using BufferPtr = std::unique_ptr<Buffer>;
+
+        /**
+        * @brief Reject writes after close() or to a file which cannot be opened, whose data would be lost.
+        */
+        void checkOpen() const
+        {
+            if (!mFile) {
+                PML_THROW_WITH_NESTED(std::logic_error, "CSVWriter is already closed or not open.");
+            }
+        }
+
+        void beginField()
+        {
+            checkOpen();
+
+            if (!mIsFirstField)
+            {
+                *reserve(1) = ',';
+                ++mBuffer->mSize;
+            }
+
+            mIsFirstField = false;
+        }
+
+        void append(const char* inData, std::size_t inSize)
+        {
+            std::memcpy(reserve(inSize), inData, inSize);
+            mBuffer->mSize += inSize;
+        }
+
+        /**
+        * @brief The end of the present buffer, which has at least inSize free bytes.
+        */
+        char* reserve(std::size_t inSize)
+        {
+            if (mBuffer->mSize + inSize > mBuffer->mData.size())
+            {
+                dispatch();
+
+                if (inSize > mBuffer->mData.size()) {
+                    mBuffer->mData.resize(inSize);
+                }
+            }
+
+            return mBuffer->mData.data() + mBuffer->mSize;
+        }
+
+        /**
+        * @brief Write the present buffer or pass it to the background thread, and make the next buffer empty.
+        */
+        void dispatch()
+        {
+            checkOpen();
+
+            if (mBuffer->mSize == 0) {
+                return;
+            }
+
+            if (!mIsAsync)
+            {
+                writeBuffer(*mBuffer);
+                return;
+            }
+
+            BufferPtr lNext;
+            mFilledRing.push(std::move(mBuffer));
+
+            if (!mSpareBuffers.empty())
+            {
+                lNext = std::move(mSpareBuffers.back());
+                mSpareBuffers.pop_back();
+            }
+            else {
+                mFreeRing.pop(lNext);
+            }
+
+            mBuffer = std::move(lNext);
+        }
+
+        void writeBuffer(Buffer& inoutBuffer)
+        {
+            if (std::fwrite(inoutBuffer.mData.data(), 1, inoutBuffer.mSize, mFile) != inoutBuffer.mSize) {
+                mIsFailed.store(true);
+            }
+
+            inoutBuffer.mSize = 0;
+        }
+
+        /**
+        * @brief Body of the background thread.
+        */
+        void write()
+        {
+            BufferPtr lBuffer;
+            while (mFilledRing.pop(lBuffer))
+            {
+                writeBuffer(*lBuffer);
+                mFreeRing.tryPush(std::move(lBuffer));
+            }
+        }
+
+        void throwIfFailed() const
+        {
+            if (mIsFailed.load()) {
+                PML_THROW_WITH_NESTED(std::runtime_error, "File cannot be written.");
+            }
+        }
+
+        SPSCRing<BufferPtr> mFilledRing;
+        SPSCRing<BufferPtr> mFreeRing;
+        std::atomic<bool> mIsFailed;
+        std::FILE* mFile;
+        std::thread mWriter;
+
+        BufferPtr mBuffer;
+        std::vector<BufferPtr> mSpareBuffers;
+        bool mIsAsync;
+        bool mIsFirstField;
+        std::size_t mRecordNumber;
+    };
+
+} // pml
+
+#endif
@@ -0,0 +1,49 @@
+#include "Benchmark.h"
+
+#include <PML/Core/NUMA.h>
+#include <PML/Math/numeric_simd.h>
+
+#include <vector>
+
+namespace {
+
+    using numa_vector = std::vector<double, pml::numa_allocator<double>>;
+
+    pml::ThreadPool& getPinnedPool()
+    {
+        static pml::ThreadPool lPool(0, true);
+
+        return lPool;
+    }
+
+    /**
+    * @brief Parallel sum over an array placed by inPlacement and initialized serially,
+    *        which puts all pages on one node unless they are already placed.
+    */
+    void measurePlacement(bench::State& inState, pml::NUMAPlacement inPlacement)
+    {
+        auto& lPool = getPinnedPool();
+
+        const numa_vector lArray(inState.getSize(), 1.0, pml::numa_allocator<double>(inPlacement, lPool));
+        inState.setProcessedBytes(lArray.size() * sizeof(double));
+
+        inState.measure([&]() {
+            bench::doNotOptimize(pml::accumulate_SIMD_parallel(lArray, 0.0, lPool));
+        });
+    }
+}
+
+PML_BENCHMARK(NUMA, placement_Default, 1U << 22)
+{
+    measurePlacement(inState, pml::NUMAPlacement::Default);
+}
+
+PML_BENCHMARK(NUMA, placement_Interleaved, 1U << 22)
+{
+    measurePlacement(inState, pml::NUMAPlacement::Interleaved);
+}
+
+PML_BENCHMARK(NUMA, placement_FirstTouch, 1U << 22)
+{
+    measurePlacement(inState, pml::NUMAPlacement::FirstTouch);
+}
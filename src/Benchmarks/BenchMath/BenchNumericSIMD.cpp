@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+
+#include <PML/Math/numeric_simd.h>
+
+#include <numeric>
+#include <vector>
+
+namespace {
+
+    std::vector<double> makeArray(std::size_t inSize)
+    {
+        std::vector<double> lArray(inSize);
+        for (std::size_t i = 0; i < inSize; ++i) {
+            lArray[i] = static_cast<double>(i % 1024);
+        }
+
+        return lArray;
+    }
+}
+
+PML_BENCHMARK(NumericSIMD, accumulate_STL, 1000, 100000, 10000000)
+{
+    const auto lArray = makeArray(inState.getSize());
+    inState.setProcessedBytes(lArray.size() * sizeof(double));
+
+    inState.measure([&]() {
+        bench::doNotOptimize(std::accumulate(lArray.cbegin(), lArray.cend(), 0.0));
+    });
+}
+
+PML_BENCHMARK(NumericSIMD, accumulate_SIMD, 1000, 100000, 10000000)
+{
+    const auto lArray = makeArray(inState.getSize());
+    inState.setProcessedBytes(lArray.size() * sizeof(double));
+
+    inState.measure([&]() {
+        bench::doNotOptimize(pml::accumulate_SIMD(lArray, 0.0));
+    });
+}
+
+PML_BENCHMARK(NumericSIMD, accumulate_SIMD_parallel, 100000, 10000000)
+{
+    const auto lArray = makeArray(inState.getSize());
+    inState.setProcessedBytes(lArray.size() * sizeof(double));
+
+    inState.measure([&]() {
+        bench::doNotOptimize(pml::accumulate_SIMD_parallel(lArray, 0.0));
+    });
+}
+
+PML_BENCHMARK(NumericSIMD, inner_product_STL, 1000, 100000, 10000000)
+{
+    const auto lArray1 = makeArray(inState.getSize());
+    const auto lArray2 = makeArray(inState.getSize());
+    inState.setProcessedBytes(2 * lArray1.size() * sizeof(double));
+
+    inState.measure([&]() {
+        bench::doNotOptimize(std::inner_product(lArray1.cbegin(), lArray1.cend(), lArray2.cbegin(), 0.0));
+    });
+}
+
+PML_BENCHMARK(NumericSIMD, inner_product_SIMD, 1000, 100000, 10000000)
+{
+    const auto lArray1 = makeArray(inState.getSize());
+    const auto lArray2 = makeArray(inState.getSize());
+    inState.setProcessedBytes(2 * lArray1.size() * sizeof(double));
+
+    inState.measure([&]() {
+        bench::doNotOptimize(pml::inner_product_SIMD(lArray1, lArray2, 0.0));
+    });
+}
@@ -0,0 +1,382 @@
+#include "Benchmark.h"
+
+#include <PML/Core/MemoryResource.h>
+#include <PML/Utility/CSVParser.h>
+#include <PML/Utility/CSVRecord.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef PML_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+    /**
+    * @brief Shape of synthetic CSV data.
+    */
+    struct CSVShape final
+    {
+        std::size_t mFieldNumber; // fields per record
+        std::size_t mFieldLength; // mean characters per field
+        double mQuotedRatio;      // fields in double quotations, which contain delimiters, escaped quotations and newlines
+        double mCRLFRatio;        // records terminated by CRLF instead of LF
+    };
+
+    const CSVShape MIXED   = { 8, 8, 0.1, 0.5 };
+    const CSVShape NARROW  = { 4, 4, 0.0, 0.0 };
+    const CSVShape WIDE    = { 64, 8, 0.0, 0.0 };
+    const CSVShape QUOTED  = { 8, 16, 1.0, 0.0 };
+    const CSVShape LONG    = { 4, 256, 0.0, 0.0 };
+    const CSVShape CRLF    = { 8, 8, 0.0, 1.0 };
+
+    /**
+    * @brief Synthetic CSV data of inBytes bytes at least, which is the same for the same arguments.
+    */
+    std::string generateCSV(const CSVShape& inShape, std::size_t inBytes)
+    {
+        std::mt19937_64 lEngine(inBytes);
+        std::uniform_int_distribution<std::size_t> lLength(1, 2 * inShape.mFieldLength - 1);
+        std::uniform_int_distribution<int> lCharacter('a', 'z');
+        std::uniform_int_distribution<int> lSpecial(0, 15);
+        std::bernoulli_distribution lIsQuoted(inShape.mQuotedRatio);
+        std::bernoulli_distribution lIsCRLF(inShape.mCRLFRatio);
+
+        std::string lCSV;
+        lCSV.reserve(inBytes + inShape.mFieldNumber * (4 * inShape.mFieldLength + 3) + 2);
+
+        while (lCSV.size() < inBytes)
+        {
+            for (std::size_t i = 0; i < inShape.mFieldNumber; ++i)
+            {
+                if (i > 0) {
+                    lCSV += ',';
+                }
+
+                const auto lIsInQuotes = lIsQuoted(lEngine);
+                if (lIsInQuotes) {
+                    lCSV += '"';
+                }
+
+                for (auto lSize = lLength(lEngine); lSize > 0; --lSize)
+                {
+                    switch (lIsInQuotes ? lSpecial(lEngine) : -1)
+                    {
+                    case 0:  lCSV += ',';    break;
+                    case 1:  lCSV += "\"\""; break;
+                    case 2:  lCSV += '\n';   break;
+                    default: lCSV += static_cast<char>(lCharacter(lEngine)); break;
+                    }
+                }
+
+                if (lIsInQuotes) {
+                    lCSV += '"';
+                }
+            }
+
+            lCSV += lIsCRLF(lEngine) ? "\r\n" : "\n";
+        }
+
+        return lCSV;
+    }
+
+    /**
+    * @brief Generate the data of inShape and set the processed bytes and records of inoutState.
+    */
+    std::string prepareCSV(bench::State& inoutState, const CSVShape& inShape)
+    {
+        auto lCSV = generateCSV(inShape, inoutState.getSize());
+
+        pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+        inoutState.setProcessedBytes(lCSV.size());
+        inoutState.setProcessedItems(lParser.forEachRecord([](const std::vector<std::string_view>&) {}));
+
+        return lCSV;
+    }
+
+    /**
+    * @brief File written at the construction and removed at the destruction.
+    */
+    class TemporaryFile final
+    {
+    public:
+        TemporaryFile(const std::string& inPath, const std::string& inData)
+            : mPath(inPath)
+        {
+            std::ofstream lFile(mPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            lFile.write(inData.data(), static_cast<std::streamsize>(inData.size()));
+        }
+
+        TemporaryFile(const TemporaryFile&)            = delete;
+        TemporaryFile(TemporaryFile&&)                 = delete;
+        TemporaryFile& operator=(const TemporaryFile&) = delete;
+        TemporaryFile& operator=(TemporaryFile&&)      = delete;
+
+        ~TemporaryFile()
+        {
+            std::remove(mPath.c_str());
+        }
+
+        const std::string& getPath() const noexcept
+        {
+            return mPath;
+        }
+
+    private:
+        std::string mPath;
+    };
+
+    std::size_t readAllViews(pml::CSVParser& inoutParser)
+    {
+        std::vector<std::string_view> lFields;
+        std::size_t lRecordNumber = 0;
+
+        while (inoutParser.readNextOneRecordView(lFields))
+        {
+            bench::doNotOptimize(lFields.data());
+            ++lRecordNumber;
+        }
+
+        return lRecordNumber;
+    }
+
+    /**
+    * @brief Read the data of MIXED from a file by readNextOneRecordView on inType.
+    */
+    void measureFile(bench::State& inState, pml::CSVParser::InputType inType)
+    {
+        const TemporaryFile lFile("BenchCSVParser.csv", prepareCSV(inState, MIXED));
+
+        inState.measure([&]() {
+            pml::CSVParser lParser(inType, lFile.getPath());
+            bench::doNotOptimize(readAllViews(lParser));
+        });
+    }
+
+    /**
+    * @brief Read the data of inShape from a string by readNextOneRecordView on inType.
+    */
+    void measureString(bench::State& inState, pml::CSVParser::InputType inType, const CSVShape& inShape)
+    {
+        const auto lCSV = prepareCSV(inState, inShape);
+
+        inState.measure([&]() {
+            pml::CSVParser lParser(inType, lCSV);
+            bench::doNotOptimize(readAllViews(lParser));
+        });
+    }
+
+    /**
+    * @brief Read the data of MIXED from a mapped file by inReader(CSVParser&).
+    */
+    template<class Reader>
+    void measureAPI(bench::State& inState, Reader inReader)
+    {
+        const TemporaryFile lFile("BenchCSVParser.csv", prepareCSV(inState, MIXED));
+
+        inState.measure([&]() {
+            pml::CSVParser lParser(pml::CSVParser::InputType::MMAP, lFile.getPath());
+            inReader(lParser);
+        });
+    }
+
+#ifdef PML_ENABLE_ZLIB
+
+    std::string compress(const std::string& inData)
+    {
+        z_stream lStream{};
+        deflateInit2(&lStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+
+        // data of several GB is given to zlib in pieces of 32-bit sizes.
+        const std::size_t lPieceSize = std::size_t(1) << 30;
+        std::string lCompressed;
+        std::vector<char> lOutput(std::size_t(1) << 20);
+
+        for (std::size_t lOffset = 0; ; lOffset += lPieceSize)
+        {
+            const auto lIsLast = (inData.size() - lOffset <= lPieceSize);
+            lStream.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(inData.data() + lOffset));
+            lStream.avail_in = static_cast<uInt>(lIsLast ? (inData.size() - lOffset) : lPieceSize);
+
+            do
+            {
+                lStream.next_out  = reinterpret_cast<Bytef*>(lOutput.data());
+                lStream.avail_out = static_cast<uInt>(lOutput.size());
+                deflate(&lStream, lIsLast ? Z_FINISH : Z_NO_FLUSH);
+                lCompressed.append(lOutput.data(), lOutput.size() - lStream.avail_out);
+            } while (lStream.avail_out == 0);
+
+            if (lIsLast) {
+                break;
+            }
+        }
+
+        deflateEnd(&lStream);
+
+        return lCompressed;
+    }
+
+#endif
+}
+
+// input types, where the throughput is of the uncompressed data.
+
+PML_BENCHMARK(CSVParser, input_FILE, 1U << 20, 1U << 24)
+{
+    measureFile(inState, pml::CSVParser::InputType::FILE);
+}
+
+PML_BENCHMARK(CSVParser, input_MMAP, 1U << 20, 1U << 24)
+{
+    measureFile(inState, pml::CSVParser::InputType::MMAP);
+}
+
+PML_BENCHMARK(CSVParser, input_ASYNC_FILE, 1U << 20, 1U << 24)
+{
+    measureFile(inState, pml::CSVParser::InputType::ASYNC_FILE);
+}
+
+PML_BENCHMARK(CSVParser, input_FOLLOW_FILE, 1U << 20, 1U << 24)
+{
+    measureFile(inState, pml::CSVParser::InputType::FOLLOW_FILE);
+}
+
+PML_BENCHMARK(CSVParser, input_COMPRESSED_FILE_plain, 1U << 20, 1U << 24)
+{
+    measureFile(inState, pml::CSVParser::InputType::COMPRESSED_FILE);
+}
+
+#ifdef PML_ENABLE_ZLIB
+
+PML_BENCHMARK(CSVParser, input_COMPRESSED_FILE_gzip, 1U << 20, 1U << 24)
+{
+    const TemporaryFile lFile("BenchCSVParser.csv.gz", compress(prepareCSV(inState, MIXED)));
+
+    inState.measure([&]() {
+        pml::CSVParser lParser(pml::CSVParser::InputType::COMPRESSED_FILE, lFile.getPath());
+        bench::doNotOptimize(readAllViews(lParser));
+    });
+}
+
+#endif
+
+PML_BENCHMARK(CSVParser, input_STRING_REF, 1U << 20, 1U << 24)
+{
+    measureString(inState, pml::CSVParser::InputType::STRING_REF, MIXED);
+}
+
+PML_BENCHMARK(CSVParser, input_STRING_COPY, 1U << 20, 1U << 24)
+{
+    measureString(inState, pml::CSVParser::InputType::STRING_COPY, MIXED);
+}
+
+// APIs on MMAP.
+
+PML_BENCHMARK(CSVParser, api_readNextOneRecord, 1U << 24)
+{
+    measureAPI(inState, [](pml::CSVParser& inoutParser) {
+        while (!inoutParser.isEnd()) {
+            bench::doNotOptimize(inoutParser.readNextOneRecord());
+        }
+    });
+}
+
+PML_BENCHMARK(CSVParser, api_readNextOneRecord_Arena, 1U << 24)
+{
+    auto& lArena = pml::ArenaResource::getThreadLocal();
+
+    measureAPI(inState, [&](pml::CSVParser& inoutParser) {
+        while (!inoutParser.isEnd())
+        {
+            pml::ArenaScope lScope(lArena);
+            bench::doNotOptimize(inoutParser.readNextOneRecord(&lArena));
+        }
+    });
+}
+
+PML_BENCHMARK(CSVParser, api_readNextOneRecord_CSVRecord, 1U << 24)
+{
+    measureAPI(inState, [](pml::CSVParser& inoutParser) {
+        pml::CSVRecord lRecord;
+        while (inoutParser.readNextOneRecord(lRecord)) {
+            bench::doNotOptimize(lRecord);
+        }
+    });
+}
+
+PML_BENCHMARK(CSVParser, api_readNextOneRecordView, 1U << 24)
+{
+    measureAPI(inState, [](pml::CSVParser& inoutParser) {
+        bench::doNotOptimize(readAllViews(inoutParser));
+    });
+}
+
+PML_BENCHMARK(CSVParser, api_forEachRecord, 1U << 24)
+{
+    measureAPI(inState, [](pml::CSVParser& inoutParser) {
+        std::size_t lSize = 0;
+        inoutParser.forEachRecord([&](const std::vector<std::string_view>& inFields) {
+            lSize += inFields.size();
+        });
+
+        bench::doNotOptimize(lSize);
+    });
+}
+
+PML_BENCHMARK(CSVParser, api_setProjection, 1U << 24)
+{
+    measureAPI(inState, [](pml::CSVParser& inoutParser) {
+        inoutParser.setProjection(std::vector<std::size_t>{ 6, 1 });
+        bench::doNotOptimize(readAllViews(inoutParser));
+    });
+}
+
+PML_BENCHMARK(CSVParser, api_readAllRecords, 1U << 24)
+{
+    const TemporaryFile lFile("BenchCSVParser.csv", prepareCSV(inState, MIXED));
+
+    inState.measure([&]() {
+        bench::doNotOptimize(pml::CSVParser::readAllRecords(lFile.getPath()));
+    });
+}
+
+PML_BENCHMARK(CSVParser, api_readAllRecordsParallel, 1U << 24)
+{
+    const TemporaryFile lFile("BenchCSVParser.csv", prepareCSV(inState, MIXED));
+
+    inState.measure([&]() {
+        bench::doNotOptimize(pml::CSVParser::readAllRecordsParallel(lFile.getPath()));
+    });
+}
+
+// shapes of data on STRING_REF.
+
+PML_BENCHMARK(CSVParser, shape_Narrow, 1U << 24)
+{
+    measureString(inState, pml::CSVParser::InputType::STRING_REF, NARROW);
+}
+
+PML_BENCHMARK(CSVParser, shape_Wide, 1U << 24)
+{
+    measureString(inState, pml::CSVParser::InputType::STRING_REF, WIDE);
+}
+
+PML_BENCHMARK(CSVParser, shape_Quoted, 1U << 24)
+{
+    measureString(inState, pml::CSVParser::InputType::STRING_REF, QUOTED);
+}
+
+PML_BENCHMARK(CSVParser, shape_LongFields, 1U << 24)
+{
+    measureString(inState, pml::CSVParser::InputType::STRING_REF, LONG);
+}
+
+PML_BENCHMARK(CSVParser, shape_CRLF, 1U << 24)
+{
+    measureString(inState, pml::CSVParser::InputType::STRING_REF, CRLF);
+}
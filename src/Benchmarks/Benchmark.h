@@ -0,0 +1,272 @@
+#ifndef BENCHMARKS_BENCHMARK_H
+#define BENCHMARKS_BENCHMARK_H
+
+/**
+* @file
+*
+* @brief Minimal benchmark harness of PML.
+*        Each case is run with warm-up and repeated samples, and the median and percentiles of the time per iteration are reported.
+*/
+
+#include <PML/Core/PerfCounters.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+* @def
+* Define and register a benchmark case GROUP/NAME run for each size of the following arguments.
+* The body receives bench::State& inState and must call inState.measure(kernel) once.
+*
+* @code
+* PML_BENCHMARK(NumericSIMD, accumulate_SIMD, 1000, 1000000)
+* {
+*     std::vector<double> lVector(inState.getSize(), 1.0);
+*     inState.setProcessedBytes(lVector.size() * sizeof(double));
+*     inState.measure([&]() { bench::doNotOptimize(pml::accumulate_SIMD(lVector, 0.0)); });
+* }
+* @endcode
+*/
+#define PML_BENCHMARK(GROUP, NAME, ...)                                                                            \
+static void Benchmark_##GROUP##_##NAME(bench::State& inState);                                                     \
+static const bench::Registrar lRegistrar_##GROUP##_##NAME(#GROUP "/" #NAME, { __VA_ARGS__ }, &Benchmark_##GROUP##_##NAME); \
+static void Benchmark_##GROUP##_##NAME(bench::State& inState)
+
+namespace bench {
+
+    /**
+    * @brief Prevent the compiler from optimizing away the computation of inValue.
+    */
+    template<class T>
+    inline void doNotOptimize(const T& inValue)
+    {
+#ifdef _MSC_VER
+        static volatile char lSink;
+        lSink = *reinterpret_cast<const volatile char*>(&inValue);
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(inValue) : "memory");
+#endif
+    }
+
+    /**
+    * @brief Run settings given by the command line.
+    */
+    struct Options final
+    {
+        std::size_t mWarmupNumber = 2;
+        std::size_t mRepetitionNumber = 15;
+        double mMinSampleSeconds = 0.01;
+    };
+
+    /**
+    * @brief Statistics of one case with one size.
+    */
+    struct Result final
+    {
+        std::string mName;
+        std::size_t mSize = 0;
+        std::size_t mIterationNumber = 0;
+        std::size_t mRepetitionNumber = 0;
+
+        // nano seconds per iteration.
+        double mMedian = 0.0;
+        double mP10 = 0.0;
+        double mP90 = 0.0;
+        double mMin = 0.0;
+        double mMean = 0.0;
+
+        // bytes per second by the median, or zero if not set.
+        double mBytesPerSecond = 0.0;
+
+        // items such as records per second by the median, or zero if not set.
+        double mItemsPerSecond = 0.0;
+
+        // per iteration, or negative if unavailable.
+        double mCycles = -1.0;
+        double mInstructions = -1.0;
+        double mLLCMisses = -1.0;
+        double mBranchMisses = -1.0;
+    };
+
+    /**
+    * @brief Linear interpolated percentile of sorted samples, inRatio in [0, 1].
+    */
+    inline double getPercentile(const std::vector<double>& inSorted, double inRatio)
+    {
+        if (inSorted.empty()) {
+            return 0.0;
+        }
+
+        const auto lPosition = inRatio * static_cast<double>(inSorted.size() - 1);
+        const auto lLower = static_cast<std::size_t>(std::floor(lPosition));
+        const auto lUpper = std::min(lLower + 1, inSorted.size() - 1);
+        const auto lWeight = lPosition - static_cast<double>(lLower);
+
+        return inSorted[lLower] * (1.0 - lWeight) + inSorted[lUpper] * lWeight;
+    }
+
+    /**
+    * @class State
+    *
+    * @brief Passed to the body of a case, which prepares inputs and measures its kernel.
+    */
+    class State final
+    {
+    public:
+        State(const std::string& inName, std::size_t inSize, const Options& inOptions)
+            : mOptions(inOptions), mProcessedBytes(0), mProcessedItems(0), mResult()
+        {
+            mResult.mName = inName;
+            mResult.mSize = inSize;
+        }
+
+        /**
+        * @brief The problem size of the present run.
+        */
+        std::size_t getSize() const noexcept
+        {
+            return mResult.mSize;
+        }
+
+        /**
+        * @brief Bytes processed by one iteration, used for the throughput.
+        */
+        void setProcessedBytes(std::size_t inBytes) noexcept
+        {
+            mProcessedBytes = inBytes;
+        }
+
+        /**
+        * @brief Items such as records processed by one iteration, used for the throughput of items.
+        */
+        void setProcessedItems(std::size_t inItems) noexcept
+        {
+            mProcessedItems = inItems;
+        }
+
+        /**
+        * @brief
+        * Measure inKernel.
+        * The number of iterations per sample is doubled until one sample takes Options::mMinSampleSeconds,
+        * then Options::mWarmupNumber samples are discarded and Options::mRepetitionNumber samples are recorded.
+        * Hardware counters are read over the recorded samples.
+        */
+        template<class F>
+        void measure(F&& inKernel)
+        {
+            std::size_t lIterationNumber = 1;
+            while (runSample(inKernel, lIterationNumber) < mOptions.mMinSampleSeconds && lIterationNumber < (std::size_t(1) << 30)) {
+                lIterationNumber *= 2;
+            }
+
+            for (std::size_t i = 0; i < mOptions.mWarmupNumber; ++i) {
+                runSample(inKernel, lIterationNumber);
+            }
+
+            std::vector<double> lSamples;
+            lSamples.reserve(mOptions.mRepetitionNumber);
+
+            pml::PerfCounters lCounters;
+            lCounters.start();
+            for (std::size_t i = 0; i < std::max<std::size_t>(mOptions.mRepetitionNumber, 1); ++i) {
+                lSamples.push_back(runSample(inKernel, lIterationNumber) * 1.0e9 / static_cast<double>(lIterationNumber));
+            }
+            lCounters.stop();
+
+            std::sort(lSamples.begin(), lSamples.end());
+
+            mResult.mIterationNumber  = lIterationNumber;
+            mResult.mRepetitionNumber = lSamples.size();
+            mResult.mMedian = getPercentile(lSamples, 0.5);
+            mResult.mP10    = getPercentile(lSamples, 0.1);
+            mResult.mP90    = getPercentile(lSamples, 0.9);
+            mResult.mMin    = lSamples.front();
+            mResult.mMean   = std::accumulate(lSamples.cbegin(), lSamples.cend(), 0.0) / static_cast<double>(lSamples.size());
+
+            if (mProcessedBytes > 0 && mResult.mMedian > 0.0) {
+                mResult.mBytesPerSecond = static_cast<double>(mProcessedBytes) * 1.0e9 / mResult.mMedian;
+            }
+
+            if (mProcessedItems > 0 && mResult.mMedian > 0.0) {
+                mResult.mItemsPerSecond = static_cast<double>(mProcessedItems) * 1.0e9 / mResult.mMedian;
+            }
+
+            const auto lTotalIterationNumber = static_cast<double>(lIterationNumber * lSamples.size());
+            const auto lPerIteration = [&](pml::PerfEvent inEvent)
+            {
+                return lCounters.isAvailable(inEvent) ? static_cast<double>(lCounters.getValue(inEvent)) / lTotalIterationNumber : -1.0;
+            };
+
+            mResult.mCycles       = lPerIteration(pml::PerfEvent::Cycles);
+            mResult.mInstructions = lPerIteration(pml::PerfEvent::Instructions);
+            mResult.mLLCMisses    = lPerIteration(pml::PerfEvent::LLCMisses);
+            mResult.mBranchMisses = lPerIteration(pml::PerfEvent::BranchMisses);
+        }
+
+        const Result& getResult() const noexcept
+        {
+            return mResult;
+        }
+
+    private:
+        template<class F>
+        static double runSample(F& inKernel, std::size_t inIterationNumber)
+        {
+            const auto lStart = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < inIterationNumber; ++i) {
+                inKernel();
+            }
+            const auto lEnd = std::chrono::steady_clock::now();
+
+            return std::chrono::duration<double>(lEnd - lStart).count();
+        }
+
+        const Options& mOptions;
+        std::size_t mProcessedBytes;
+        std::size_t mProcessedItems;
+        Result mResult;
+    };
+
+    /**
+    * @brief A registered case.
+    */
+    struct Case final
+    {
+        std::string mName;
+        std::vector<std::size_t> mSizes;
+        std::function<void(State&)> mBody;
+    };
+
+    inline std::vector<Case>& getCases()
+    {
+        static std::vector<Case> lCases;
+
+        return lCases;
+    }
+
+    /**
+    * @brief Static registration used by PML_BENCHMARK.
+    */
+    struct Registrar final
+    {
+        Registrar(const char* inName, std::vector<std::size_t> inSizes, void (*inBody)(State&))
+        {
+            getCases().push_back(Case{ inName, std::move(inSizes), inBody });
+        }
+    };
+
+} // bench
+
+#endif
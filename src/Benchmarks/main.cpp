@@ -0,0 +1,344 @@
+#include "Benchmark.h"
+
+#include <PML/Core/CPUDispatcher.h>
+#include <PML/Core/exception_handler.h>
+#include <PML/Utility/CSVParser.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    struct Settings final
+    {
+        bench::Options mOptions;
+        std::string mFilter;
+        std::vector<std::size_t> mSizes;
+        std::string mJSONPath;
+        std::string mCSVPath;
+        std::string mBaselinePath;
+        double mTolerance = 0.10;
+        bool mIsListOnly = false;
+    };
+
+    void outputUsage(std::ostream& outStream)
+    {
+        outStream
+            << "Usage: Benchmarks [options]\n"
+            << "  --filter=TEXT        run cases whose name contains TEXT\n"
+            << "  --list               list cases and sizes\n"
+            << "  --sizes=N,M,...      run cases with these sizes instead of the registered ones\n"
+            << "  --warmup=N           discarded samples per case (default 2)\n"
+            << "  --repetitions=N      recorded samples per case (default 15)\n"
+            << "  --min-time=SEC       minimum duration of one sample (default 0.01)\n"
+            << "  --json=PATH          write results as JSON\n"
+            << "  --csv=PATH           write results as CSV, which can be used as a baseline\n"
+            << "  --baseline=PATH      compare with a CSV written by --csv, and exit with 1 on a regression\n"
+            << "  --tolerance=RATIO    allowed slowdown beyond the spread of the baseline (default 0.10)\n";
+    }
+
+    bool parseArguments(int argc, char** argv, Settings& outSettings)
+    {
+        for (auto i = 1; i < argc; ++i)
+        {
+            const std::string lArgument = argv[i];
+            const auto lEqual = lArgument.find('=');
+            const auto lKey   = lArgument.substr(0, lEqual);
+            const auto lValue = (lEqual == std::string::npos) ? std::string() : lArgument.substr(lEqual + 1);
+
+            if      (lKey == "--filter")      { outSettings.mFilter = lValue; }
+            else if (lKey == "--list")        { outSettings.mIsListOnly = true; }
+            else if (lKey == "--sizes")
+            {
+                std::stringstream lStream(lValue);
+                for (std::string lSize; std::getline(lStream, lSize, ','); ) {
+                    outSettings.mSizes.push_back(std::stoull(lSize));
+                }
+            }
+            else if (lKey == "--warmup")      { outSettings.mOptions.mWarmupNumber = std::stoul(lValue); }
+            else if (lKey == "--repetitions") { outSettings.mOptions.mRepetitionNumber = std::stoul(lValue); }
+            else if (lKey == "--min-time")    { outSettings.mOptions.mMinSampleSeconds = std::stod(lValue); }
+            else if (lKey == "--json")        { outSettings.mJSONPath = lValue; }
+            else if (lKey == "--csv")         { outSettings.mCSVPath = lValue; }
+            else if (lKey == "--baseline")    { outSettings.mBaselinePath = lValue; }
+            else if (lKey == "--tolerance")   { outSettings.mTolerance = std::stod(lValue); }
+            else
+            {
+                std::cerr << "Unknown option: " << lArgument << "\n";
+                outputUsage(std::cerr);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::string formatCounter(double inValue)
+    {
+        if (inValue < 0.0) {
+            return "n/a";
+        }
+
+        std::stringstream lStream;
+        lStream << std::fixed << std::setprecision(1) << inValue;
+
+        return lStream.str();
+    }
+
+    void outputResult(const bench::Result& inResult, std::ostream& outStream)
+    {
+        const auto lIPC = (inResult.mCycles > 0.0 && inResult.mInstructions >= 0.0) ? inResult.mInstructions / inResult.mCycles : -1.0;
+
+        outStream
+            << std::left  << std::setw(48) << (inResult.mName + "/" + std::to_string(inResult.mSize))
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << inResult.mMedian
+            << std::setw(14) << inResult.mP10
+            << std::setw(14) << inResult.mP90
+            << std::setw(12) << std::setprecision(2) << inResult.mBytesPerSecond * 1.0e-9
+            << std::setw(12) << inResult.mItemsPerSecond * 1.0e-6
+            << std::setw(12) << formatCounter(inResult.mCycles)
+            << std::setw(8)  << ((lIPC < 0.0) ? std::string("n/a") : std::to_string(lIPC).substr(0, 4))
+            << std::setw(10) << formatCounter(inResult.mLLCMisses)
+            << std::setw(10) << formatCounter(inResult.mBranchMisses)
+            << std::defaultfloat << std::endl;
+    }
+
+    void writeCSV(const std::vector<bench::Result>& inResults, const std::string& inPath)
+    {
+        std::ofstream lFile(inPath);
+        lFile << "name,size,iterations,repetitions,median_ns,p10_ns,p90_ns,min_ns,mean_ns,bytes_per_second,items_per_second,cycles,instructions,llc_misses,branch_misses\n";
+        lFile << std::setprecision(10);
+
+        for (const auto& result_i : inResults)
+        {
+            lFile << result_i.mName << "," << result_i.mSize << ","
+                << result_i.mIterationNumber << "," << result_i.mRepetitionNumber << ","
+                << result_i.mMedian << "," << result_i.mP10 << "," << result_i.mP90 << ","
+                << result_i.mMin << "," << result_i.mMean << "," << result_i.mBytesPerSecond << "," << result_i.mItemsPerSecond << ","
+                << result_i.mCycles << "," << result_i.mInstructions << ","
+                << result_i.mLLCMisses << "," << result_i.mBranchMisses << "\n";
+        }
+    }
+
+    void writeJSON(const std::vector<bench::Result>& inResults, const std::string& inPath)
+    {
+        const auto lNumberOrNull = [](double inValue) {
+            return (inValue < 0.0) ? std::string("null") : std::to_string(inValue);
+        };
+
+        std::ofstream lFile(inPath);
+        lFile << std::setprecision(10);
+        lFile << "{\n"
+            << "  \"context\": {\n"
+            << "    \"cpu\": \"" << pml::CPUDispatcher::getBrand().c_str() << "\",\n"
+            << "    \"logical_cores\": " << pml::CPUDispatcher::getAvailableCores().size() << ",\n"
+#ifdef NDEBUG
+            << "    \"build\": \"release\"\n"
+#else
+            << "    \"build\": \"debug\"\n"
+#endif
+            << "  },\n"
+            << "  \"benchmarks\": [";
+
+        for (std::size_t i = 0; i < inResults.size(); ++i)
+        {
+            const auto& lResult = inResults[i];
+            lFile << ((i == 0) ? "\n" : ",\n")
+                << "    {\"name\": \"" << lResult.mName << "\", \"size\": " << lResult.mSize
+                << ", \"iterations\": " << lResult.mIterationNumber
+                << ", \"repetitions\": " << lResult.mRepetitionNumber
+                << ", \"median_ns\": " << lResult.mMedian
+                << ", \"p10_ns\": " << lResult.mP10
+                << ", \"p90_ns\": " << lResult.mP90
+                << ", \"min_ns\": " << lResult.mMin
+                << ", \"mean_ns\": " << lResult.mMean
+                << ", \"bytes_per_second\": " << lResult.mBytesPerSecond
+                << ", \"items_per_second\": " << lResult.mItemsPerSecond
+                << ", \"cycles\": " << lNumberOrNull(lResult.mCycles)
+                << ", \"instructions\": " << lNumberOrNull(lResult.mInstructions)
+                << ", \"llc_misses\": " << lNumberOrNull(lResult.mLLCMisses)
+                << ", \"branch_misses\": " << lNumberOrNull(lResult.mBranchMisses) << "}";
+        }
+
+        lFile << "\n  ]\n}\n";
+    }
+
+    /**
+    * @brief
+    * Compare with the baseline and return the number of regressions.
+    * The verdict is based on the noise of both runs rather than on the medians:
+    * a case regresses only if its fastest sample is slower than the P90 of the baseline by more than inTolerance,
+    * and improves only if its P90 is faster than the fastest sample of the baseline by more than inTolerance.
+    * The ratio of the medians is shown for information.
+    */
+    std::size_t compareWithBaseline(const std::vector<bench::Result>& inResults, const std::string& inPath, double inTolerance)
+    {
+        const auto lRecords = pml::CSVParser::readAllRecords(inPath);
+        if (lRecords.empty()) {
+            throw std::runtime_error("Baseline " + inPath + " cannot be read or is empty.");
+        }
+
+        const auto& lHeader = lRecords.front();
+        const auto lColumn = [&](const std::string& inName)
+        {
+            const auto lIt = std::find(lHeader.cbegin(), lHeader.cend(), inName);
+            if (lIt == lHeader.cend()) {
+                throw std::runtime_error("Baseline " + inPath + " has no column " + inName + ".");
+            }
+
+            return static_cast<std::size_t>(lIt - lHeader.cbegin());
+        };
+
+        const auto lNameColumn   = lColumn("name");
+        const auto lSizeColumn   = lColumn("size");
+        const auto lRepetitionColumn = lColumn("repetitions");
+        const auto lMedianColumn = lColumn("median_ns");
+        const auto lP90Column    = lColumn("p90_ns");
+        const auto lMinColumn    = lColumn("min_ns");
+
+        struct Entry final
+        {
+            std::size_t mRepetitionNumber;
+            double mMedian;
+            double mP90;
+            double mMin;
+        };
+
+        std::map<std::pair<std::string, std::size_t>, Entry> lBaseline;
+        for (std::size_t i = 1; i < lRecords.size(); ++i)
+        {
+            const auto& lRecord = lRecords[i];
+            if (lRecord.size() > std::max({ lNameColumn, lSizeColumn, lRepetitionColumn, lMedianColumn, lP90Column, lMinColumn }))
+            {
+                lBaseline[{ lRecord[lNameColumn], std::stoul(lRecord[lSizeColumn]) }] = Entry{
+                    std::stoul(lRecord[lRepetitionColumn]),
+                    std::stod(lRecord[lMedianColumn]),
+                    std::stod(lRecord[lP90Column]),
+                    std::stod(lRecord[lMinColumn]) };
+            }
+        }
+
+        std::cout << "\nComparison with " << inPath << " (tolerance " << inTolerance * 100.0 << "% beyond the baseline P90)\n";
+
+        std::size_t lRegressionNumber = 0;
+        for (const auto& result_i : inResults)
+        {
+            const auto lIt = lBaseline.find({ result_i.mName, result_i.mSize });
+            const auto lLabel = result_i.mName + "/" + std::to_string(result_i.mSize);
+
+            if (lIt == lBaseline.cend())
+            {
+                std::cout << std::left << std::setw(48) << lLabel << "  new\n";
+                continue;
+            }
+
+            const auto& lEntry = lIt->second;
+            const auto lRatio = result_i.mMedian / lEntry.mMedian;
+            std::string lVerdict = "ok";
+            if (result_i.mMin > lEntry.mP90 * (1.0 + inTolerance))
+            {
+                lVerdict = "REGRESSION";
+                ++lRegressionNumber;
+            }
+            else if (result_i.mP90 < lEntry.mMin * (1.0 - inTolerance)) {
+                lVerdict = "improved";
+            }
+
+            // samples of different numbers have different spreads.
+            if (lEntry.mRepetitionNumber != result_i.mRepetitionNumber) {
+                lVerdict += " (baseline has " + std::to_string(lEntry.mRepetitionNumber) + " repetitions)";
+            }
+
+            std::cout << std::left << std::setw(48) << lLabel
+                << std::right << std::fixed << std::setprecision(3) << std::setw(10) << lRatio << "x  "
+                << lVerdict << std::defaultfloat << "\n";
+        }
+
+        return lRegressionNumber;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Settings lSettings;
+    if (!parseArguments(argc, argv, lSettings)) {
+        return 2;
+    }
+
+    if (lSettings.mIsListOnly)
+    {
+        for (const auto& case_i : bench::getCases())
+        {
+            std::cout << case_i.mName << ":";
+            for (const auto size_i : case_i.mSizes) {
+                std::cout << " " << size_i;
+            }
+            std::cout << "\n";
+        }
+
+        return 0;
+    }
+
+    pml::CPUDispatcher::outputCPUInfo(std::cout);
+#ifndef NDEBUG
+    std::cout << "\n*** Debug build: timings are not representative. ***\n";
+#endif
+
+    std::cout << "\n"
+        << std::left  << std::setw(48) << "Name/Size"
+        << std::right << std::setw(14) << "Median[ns]"
+        << std::setw(14) << "P10[ns]"
+        << std::setw(14) << "P90[ns]"
+        << std::setw(12) << "GB/s"
+        << std::setw(12) << "Mitems/s"
+        << std::setw(12) << "Cycles"
+        << std::setw(8)  << "IPC"
+        << std::setw(10) << "LLC-miss"
+        << std::setw(10) << "Br-miss" << std::endl;
+
+    std::vector<bench::Result> lResults;
+    for (const auto& case_i : bench::getCases())
+    {
+        if (case_i.mName.find(lSettings.mFilter) == std::string::npos) {
+            continue;
+        }
+
+        for (const auto size_i : lSettings.mSizes.empty() ? case_i.mSizes : lSettings.mSizes)
+        {
+            bench::State lState(case_i.mName, size_i, lSettings.mOptions);
+            case_i.mBody(lState);
+
+            lResults.push_back(lState.getResult());
+            outputResult(lResults.back(), std::cout);
+        }
+    }
+
+    if (!lSettings.mCSVPath.empty()) {
+        writeCSV(lResults, lSettings.mCSVPath);
+    }
+
+    if (!lSettings.mJSONPath.empty()) {
+        writeJSON(lResults, lSettings.mJSONPath);
+    }
+
+    if (!lSettings.mBaselinePath.empty())
+    {
+        auto lExitCode = 2;
+
+        PML_CATCH_BEGIN
+        lExitCode = (compareWithBaseline(lResults, lSettings.mBaselinePath, lSettings.mTolerance) > 0) ? 1 : 0;
+        PML_CATCH_END(std::cerr)
+
+        return lExitCode;
+    }
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/AlignedAllocator.h>
+
+#include <cstdint>
+#include <numeric>
+
+TEST(TestAlignedAllocator, alignment)
+{
+    for (const auto size_i : { 1, 3, 17, 1000 })
+    {
+        pml::aligned_vector<double> lDoubles(size_i, 1.0);
+        pml::aligned_vector<char, 128> lChars(size_i);
+
+        EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(lDoubles.data()) % 64);
+        EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(lChars.data()) % 128);
+        EXPECT_EQ(static_cast<double>(size_i), std::accumulate(lDoubles.cbegin(), lDoubles.cend(), 0.0));
+
+        lDoubles.resize(3 * size_i);
+        EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(lDoubles.data()) % 64);
+    }
+
+    EXPECT_TRUE(pml::aligned_allocator<double>() == pml::aligned_allocator<int>());
+}
@@ -6,4 +6,21 @@
 TEST(TestCore, CPUInfo)
 {
     EXPECT_NO_THROW(pml::CPUDispatcher::outputCPUInfo(std::cout));
+}
+
+TEST(TestCore, OSSupportOfSIMD)
+{
+    // AVX and AVX512 are reported only if the OS saves their registers.
+    if (pml::CPUDispatcher::isAVX2() || pml::CPUDispatcher::isAVX()) {
+        EXPECT_TRUE(pml::CPUDispatcher::isOSXSAVE() && pml::CPUDispatcher::isAVXStateEnabled());
+    }
+
+    if (pml::CPUDispatcher::isAVX512BW() || pml::CPUDispatcher::isAVX512F()) {
+        EXPECT_TRUE(pml::CPUDispatcher::isAVX512StateEnabled());
+    }
+
+    // the ZMM state includes the YMM state.
+    if (pml::CPUDispatcher::isAVX512StateEnabled()) {
+        EXPECT_TRUE(pml::CPUDispatcher::isAVXStateEnabled());
+    }
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/expected.h>
+
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+    pml::expected<std::vector<int>> makeValues(bool inIsValid)
+    {
+        if (!inIsValid) {
+            return PML_MAKE_ERROR(pml::errc::out_of_range, "Values are out of range.", 7);
+        }
+
+        return std::vector<int>{ 1, 2, 3 };
+    }
+
+    template<class E>
+    pml::expected<int> convert() noexcept
+    {
+        PML_CATCH_BEGIN
+
+        PML_THROW_WITH_NESTED(E, "Thrown.");
+
+        PML_CATCH_END_AND_RETURN_ERROR("convert failed.")
+    }
+}
+
+TEST(TestExpected, valueAndError)
+{
+    auto lValues = makeValues(true);
+    ASSERT_TRUE(lValues.has_value());
+    EXPECT_EQ(3U, lValues->size());
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3 }), *lValues);
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3 }), std::move(lValues).value());
+
+    const auto lError = makeValues(false);
+    ASSERT_FALSE(lError);
+    EXPECT_EQ(pml::errc::out_of_range, lError.error().code());
+    EXPECT_STREQ("Values are out of range.", lError.error().reason());
+    EXPECT_EQ(7U, lError.error().context());
+    EXPECT_FALSE(lError.error().exception());
+    EXPECT_TRUE(lError.value_or(std::vector<int>{}).empty());
+
+    // the message is formatted as PML_THROW_WITH_NESTED.
+    const auto lMessage = lError.error().message();
+    EXPECT_EQ(0U, lMessage.find("l."));
+    EXPECT_NE(std::string::npos, lMessage.find("TestExpected.cpp: Values are out of range. (7)"));
+
+    EXPECT_THROW(lError.value(), std::runtime_error);
+
+    // errors are copied without allocations.
+    static_assert(std::is_nothrow_copy_constructible_v<pml::error>, "pml::error must be copied without exceptions.");
+}
+
+TEST(TestExpected, fromCurrentException)
+{
+    const auto lLogic = convert<std::logic_error>();
+    ASSERT_FALSE(lLogic);
+    EXPECT_EQ(pml::errc::logic_error, lLogic.error().code());
+    EXPECT_TRUE(lLogic.error().exception());
+    EXPECT_STREQ("convert failed.", lLogic.error().reason());
+
+    // messages of the converted exception follow.
+    EXPECT_NE(std::string::npos, lLogic.error().message().find("Thrown."));
+
+    EXPECT_EQ(pml::errc::runtime_error, convert<std::runtime_error>().error().code());
+    EXPECT_EQ(pml::errc::out_of_range, convert<std::out_of_range>().error().code());
+
+    const auto lAlloc = []() noexcept -> pml::expected<int>
+    {
+        PML_CATCH_BEGIN
+        throw std::bad_alloc();
+        PML_CATCH_END_AND_RETURN_ERROR("Allocation failed.")
+    }();
+
+    EXPECT_EQ(pml::errc::out_of_memory, lAlloc.error().code());
+}
@@ -0,0 +1,88 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/MappedFile.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+TEST(TestMappedFile, map)
+{
+    const std::string lFilePath = "TestMappedFile_map.bin";
+    std::string lContents(100000, '\0');
+    for (std::size_t i = 0; i < lContents.size(); ++i) {
+        lContents[i] = static_cast<char>(i % 251);
+    }
+
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lContents;
+    }
+
+    for (const auto hint_i : { pml::MappedFile::AccessHint::Normal, pml::MappedFile::AccessHint::Sequential, pml::MappedFile::AccessHint::Random })
+    {
+        pml::MappedFile lFile(lFilePath, hint_i);
+
+        EXPECT_TRUE(lFile.isOpen());
+        ASSERT_EQ(lContents.size(), lFile.size());
+        EXPECT_EQ(lContents, std::string(lFile.begin(), lFile.end()));
+    }
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(TestMappedFile, emptyAndNotFound)
+{
+    const std::string lFilePath = "TestMappedFile_empty.bin";
+    std::ofstream(lFilePath, std::ios::out | std::ios::trunc).close();
+
+    {
+        pml::MappedFile lFile(lFilePath);
+        EXPECT_TRUE(lFile.isOpen());
+        EXPECT_EQ(0U, lFile.size());
+        EXPECT_EQ(lFile.begin(), lFile.end());
+    }
+
+    std::remove(lFilePath.c_str());
+
+    pml::MappedFile lNotFound("TestMappedFile_notFound.bin");
+    EXPECT_FALSE(lNotFound.isOpen());
+    EXPECT_EQ(0U, lNotFound.size());
+    EXPECT_EQ(lNotFound.begin(), lNotFound.end());
+}
+
+TEST(TestMappedFile, replaceFile)
+{
+    const std::string lFilePath = "TestMappedFile_replace.bin";
+
+    pml::detail::replace_file(lFilePath, { "abc", std::string_view("\0d", 2) });
+    {
+        pml::MappedFile lFile(lFilePath);
+        EXPECT_EQ(std::string("abc\0d", 5), std::string(lFile.begin(), lFile.end()));
+    }
+
+    pml::detail::replace_file(lFilePath, { "e" });
+    {
+        pml::MappedFile lFile(lFilePath);
+        EXPECT_EQ("e", std::string(lFile.begin(), lFile.end()));
+    }
+
+    std::remove(lFilePath.c_str());
+
+    // a directory cannot be replaced, and the temporary file is removed.
+    const std::string lDirectoryPath = "TestMappedFile_replace.dir";
+    std::filesystem::create_directory(lDirectoryPath);
+    std::ofstream(lDirectoryPath + "/file").close();
+
+    EXPECT_THROW(pml::detail::replace_file(lDirectoryPath, { "abc" }), std::runtime_error);
+    EXPECT_FALSE(std::filesystem::exists(lDirectoryPath + ".tmp"));
+    EXPECT_TRUE (std::filesystem::is_directory(lDirectoryPath));
+
+    // the temporary file cannot be created in a missing directory.
+    EXPECT_THROW(pml::detail::replace_file("TestMappedFile_missing/file", { "abc" }), std::runtime_error);
+
+    std::filesystem::remove_all(lDirectoryPath);
+}
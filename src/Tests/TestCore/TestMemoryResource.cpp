@@ -0,0 +1,132 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/MemoryResource.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    class CountingResource final : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t mAllocationNumber = 0;
+        std::size_t mDeallocationNumber = 0;
+
+    private:
+        void* do_allocate(std::size_t inBytes, std::size_t inAlignment) override
+        {
+            ++mAllocationNumber;
+            return std::pmr::new_delete_resource()->allocate(inBytes, inAlignment);
+        }
+
+        void do_deallocate(void* inPtr, std::size_t inBytes, std::size_t inAlignment) override
+        {
+            ++mDeallocationNumber;
+            std::pmr::new_delete_resource()->deallocate(inPtr, inBytes, inAlignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& inOther) const noexcept override
+        {
+            return (this == &inOther);
+        }
+    };
+
+    bool isAligned(const void* inPtr, std::size_t inAlignment)
+    {
+        return (reinterpret_cast<std::uintptr_t>(inPtr) % inAlignment) == 0;
+    }
+}
+
+TEST(TestMemoryResource, arena)
+{
+    CountingResource lUpstream;
+    {
+        pml::ArenaResource lArena(256, &lUpstream);
+
+        for (const std::size_t align_i : { 1U, 2U, 8U, 16U, 64U })
+        {
+            auto* lPtr = lArena.allocate(3, align_i);
+            EXPECT_TRUE(isAligned(lPtr, align_i));
+        }
+
+        auto* lLarge = static_cast<char*>(lArena.allocate(10000, 32));
+        EXPECT_TRUE(isAligned(lLarge, 32));
+        lLarge[9999] = 'a';
+
+        const auto lAllocationNumber = lUpstream.mAllocationNumber;
+        const auto lCapacity = lArena.getCapacity();
+        EXPECT_LE(10000U, lCapacity);
+
+        // the second batch reuses chunks.
+        lArena.reset();
+        for (auto i = 0; i < 100; ++i)
+        {
+            std::pmr::vector<std::pmr::string> lStrings(&lArena);
+            lStrings.emplace_back("a string longer than the small buffer of std::string.");
+        }
+
+        EXPECT_EQ(lAllocationNumber, lUpstream.mAllocationNumber);
+        EXPECT_EQ(lCapacity, lArena.getCapacity());
+    }
+
+    EXPECT_EQ(lUpstream.mAllocationNumber, lUpstream.mDeallocationNumber);
+}
+
+TEST(TestMemoryResource, arenaScope)
+{
+    pml::ArenaResource lArena(1024);
+
+    void* lFirst = nullptr;
+    {
+        pml::ArenaScope lScope(lArena);
+        lFirst = lArena.allocate(100);
+    }
+    {
+        pml::ArenaScope lScope(lArena);
+        EXPECT_EQ(lFirst, lArena.allocate(100));
+    }
+
+    auto& lThreadLocal = pml::ArenaResource::getThreadLocal();
+    EXPECT_EQ(&lThreadLocal, &pml::ArenaResource::getThreadLocal());
+
+    pml::ArenaResource* lOtherThreadLocal = nullptr;
+    std::thread([&lOtherThreadLocal]() { lOtherThreadLocal = &pml::ArenaResource::getThreadLocal(); }).join();
+    EXPECT_NE(&lThreadLocal, lOtherThreadLocal);
+}
+
+TEST(TestMemoryResource, pool)
+{
+    CountingResource lUpstream;
+    {
+        pml::PoolResource lPool(&lUpstream);
+
+        auto* lBlock = lPool.allocate(24, 8);
+        EXPECT_TRUE(isAligned(lBlock, 8));
+        lPool.deallocate(lBlock, 24, 8);
+
+        // the freed block is reused.
+        EXPECT_EQ(lBlock, lPool.allocate(20, 8));
+
+        auto* lAligned = lPool.allocate(100, 128);
+        EXPECT_TRUE(isAligned(lAligned, 128));
+
+        const auto lAllocationNumber = lUpstream.mAllocationNumber;
+        for (auto i = 0; i < 1000; ++i)
+        {
+            std::pmr::vector<double> lVector(100, 1.0, &lPool);
+            std::pmr::string lString(50, 'a', &lPool);
+        }
+        EXPECT_GE(lAllocationNumber + 2, lUpstream.mAllocationNumber);
+
+        // large blocks are forwarded to the upstream.
+        auto* lLarge = lPool.allocate(10000, 8);
+        lPool.deallocate(lLarge, 10000, 8);
+    }
+
+    EXPECT_EQ(lUpstream.mAllocationNumber, lUpstream.mDeallocationNumber);
+}
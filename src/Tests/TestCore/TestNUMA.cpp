@@ -0,0 +1,125 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/NUMA.h>
+#include <PML/Math/numeric_simd.h>
+
+#include <atomic>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using numa_vector = std::vector<double, pml::numa_allocator<double>>;
+}
+
+TEST(TestNUMA, topology)
+{
+    EXPECT_LE(1U, pml::NUMATopology::getNodeNumber());
+
+    std::size_t lCoreNumber = 0;
+    for (std::size_t i = 0; i < pml::NUMATopology::getNodeNumber(); ++i)
+    {
+        for (const auto core_i : pml::NUMATopology::getCoresOfNode(i)) {
+            EXPECT_EQ(i, pml::NUMATopology::getNodeOfCore(core_i));
+        }
+
+        lCoreNumber += pml::NUMATopology::getCoresOfNode(i).size();
+
+        // ids of the OS increase with the node, and can skip some.
+        if (i > 0) {
+            EXPECT_LT(pml::NUMATopology::getNodeID(i - 1), pml::NUMATopology::getNodeID(i));
+        }
+    }
+
+    EXPECT_LE(1U, lCoreNumber);
+    EXPECT_NO_THROW(pml::NUMATopology::outputNUMAInfo(std::cout));
+}
+
+TEST(TestNUMA, nodeMask)
+{
+    constexpr std::size_t lBits = 8 * sizeof(unsigned long);
+
+    EXPECT_EQ((std::vector<unsigned long>{ 1UL }), pml::detail::make_node_mask({ 0 }));
+    EXPECT_EQ((std::vector<unsigned long>{ 0x5UL }), pml::detail::make_node_mask({ 0, 2 }));
+
+    // the mask is sized from the largest id, not from the number of nodes.
+    const auto lMask = pml::detail::make_node_mask({ 1, lBits + 3 });
+    ASSERT_EQ(2U, lMask.size());
+    EXPECT_EQ(0x2UL, lMask[0]);
+    EXPECT_EQ(0x8UL, lMask[1]);
+
+    // the kernel reads maxnode - 1 bits, so that the largest id is followed by another bit.
+    const auto lLastBit = pml::detail::make_node_mask({ 0, lBits - 1 });
+    ASSERT_EQ(2U, lLastBit.size());
+    EXPECT_EQ(1UL | (1UL << (lBits - 1)), lLastBit[0]);
+    EXPECT_EQ(0UL, lLastBit[1]);
+    EXPECT_LT(lBits - 1, lLastBit.size() * lBits - 1);
+}
+
+TEST(TestNUMA, staticRange)
+{
+    pml::ThreadPool lPool(3);
+
+    auto lNext = std::size_t(5);
+    for (std::size_t i = 0; i < lPool.getThreadNumber(); ++i)
+    {
+        const auto lRange = lPool.getStaticRange(5, 16, i);
+        EXPECT_EQ(lNext, lRange.first);
+        EXPECT_LE(3U, lRange.second - lRange.first);
+        EXPECT_GE(4U, lRange.second - lRange.first);
+
+        lNext = lRange.second;
+    }
+    EXPECT_EQ(16U, lNext);
+
+    std::vector<std::atomic<int>> lCounts(10);
+    lPool.parallelForStatic(0, lCounts.size(), [&](std::size_t inFirst, std::size_t inLast)
+    {
+        for (auto i = inFirst; i < inLast; ++i) {
+            ++lCounts[i];
+        }
+    });
+
+    for (const auto& count_i : lCounts) {
+        EXPECT_EQ(1, count_i.load());
+    }
+
+    // the index of each subrange, also with fewer elements than workers.
+    for (const auto size_i : { 2U, 10U, 11U, 12U })
+    {
+        std::vector<std::atomic<int>> lIndexCounts(lPool.getThreadNumber());
+        std::atomic<std::size_t> lSize(0);
+        lPool.parallelForStatic(7, 7 + size_i, [&](std::size_t inIndex, std::size_t inFirst, std::size_t inLast)
+        {
+            ASSERT_LT(inIndex, lIndexCounts.size());
+            EXPECT_EQ(lPool.getStaticRange(7, 7 + size_i, inIndex), std::make_pair(inFirst, inLast));
+
+            ++lIndexCounts[inIndex];
+            lSize += inLast - inFirst;
+        });
+
+        EXPECT_EQ(size_i, lSize.load());
+        for (std::size_t i = 0; i < lIndexCounts.size(); ++i) {
+            EXPECT_EQ((i < size_i) ? 1 : 0, lIndexCounts[i].load());
+        }
+    }
+}
+
+TEST(TestNUMA, allocator)
+{
+    pml::ThreadPool lPool(2, true);
+
+    for (const auto placement_i : { pml::NUMAPlacement::Default, pml::NUMAPlacement::Interleaved, pml::NUMAPlacement::FirstTouch })
+    {
+        numa_vector lVector(12345, 1.0, pml::numa_allocator<double>(placement_i, lPool));
+        EXPECT_EQ(12345.0, pml::accumulate_SIMD_parallel(lVector, 0.0, lPool));
+
+        lVector.resize(100000, 2.0);
+        EXPECT_EQ(187655.0 + 0.5, pml::accumulate_SIMD_parallel(lVector, 0.5, lPool));
+
+        numa_vector lEmpty(pml::numa_allocator<double>(placement_i, lPool));
+        EXPECT_EQ(1.0, pml::accumulate_SIMD_parallel(lEmpty, 1.0, lPool));
+    }
+}
@@ -0,0 +1,64 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/PerfCounters.h>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+TEST(TestPerfCounters, counters)
+{
+    pml::PerfCounters lCounters;
+
+    volatile double lSum = 0.0;
+
+    lCounters.start();
+    for (auto i = 0; i < 1000000; ++i) {
+        lSum = lSum + static_cast<double>(i);
+    }
+    lCounters.stop();
+
+    EXPECT_EQ(499999500000.0, lSum);
+
+    for (const auto event_i : { pml::PerfEvent::Cycles, pml::PerfEvent::Instructions })
+    {
+        if (lCounters.isAvailable(event_i)) {
+            EXPECT_LT(0U, lCounters.getValue(event_i));
+        }
+        else {
+            EXPECT_EQ(0U, lCounters.getValue(event_i));
+        }
+    }
+
+    std::stringstream lStream;
+    lCounters.outputCounters(lStream);
+    EXPECT_NE(std::string::npos, lStream.str().find("cycles:"));
+    EXPECT_NE(std::string::npos, lStream.str().find("branch-misses:"));
+
+    if (!lCounters.isAvailable()) {
+        EXPECT_NE(std::string::npos, lStream.str().find("n/a"));
+    }
+
+    std::cout << lStream.str() << std::endl;
+}
+
+TEST(TestPerfCounters, streamState)
+{
+    pml::PerfCounters lCounters;
+    lCounters.start();
+    lCounters.stop();
+
+    // the precision and the flags of the caller's stream are kept.
+    std::stringstream lStream;
+    lStream << std::hex << std::setprecision(5);
+    const auto lFlags = lStream.flags();
+
+    lCounters.outputCounters(lStream);
+    EXPECT_EQ(5, lStream.precision());
+    EXPECT_EQ(lFlags, lStream.flags());
+
+    lStream.str("");
+    lStream << 1.0 / 3.0 << " " << 255;
+    EXPECT_EQ("0.33333 ff", lStream.str());
+}
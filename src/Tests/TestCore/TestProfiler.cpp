@@ -0,0 +1,128 @@
+#include "stdafx.h"
+
+#ifndef PML_ENABLE_PROFILING
+#define PML_ENABLE_PROFILING
+#endif
+
+#include <gtest/gtest.h>
+#include <PML/Core/Profiler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    std::uint64_t getCallNumber(const std::string& inName)
+    {
+        const auto lEntries = pml::Profiler::getEntries();
+        const auto lIt = std::find_if(lEntries.cbegin(), lEntries.cend(), [&](const pml::Profiler::Entry& inEntry) {
+            return (inEntry.mName == inName);
+        });
+
+        return (lIt == lEntries.cend()) ? 0 : lIt->mCallNumber;
+    }
+
+    void profiledFunction()
+    {
+        PML_PROFILE_SCOPE("TestProfiler::profiledFunction");
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    void nestedFunction()
+    {
+        PML_PROFILE_SCOPE("TestProfiler::nestedFunction");
+
+        profiledFunction();
+        profiledFunction();
+    }
+}
+
+TEST(TestProfiler, scope)
+{
+    pml::Profiler::reset();
+
+    for (auto i = 0; i < 10; ++i) {
+        profiledFunction();
+    }
+    nestedFunction();
+
+    EXPECT_EQ(12U, getCallNumber("TestProfiler::profiledFunction"));
+    EXPECT_EQ(1U, getCallNumber("TestProfiler::nestedFunction"));
+
+    for (const auto& entry_i : pml::Profiler::getEntries())
+    {
+        if (entry_i.mName == "TestProfiler::profiledFunction") {
+            EXPECT_LE(12 * 100e-6, entry_i.mSeconds);
+        }
+        else if (entry_i.mName == "TestProfiler::nestedFunction") {
+            EXPECT_LE(2 * 100e-6, entry_i.mSeconds);
+        }
+    }
+
+    pml::Profiler::reset();
+    EXPECT_EQ(0U, getCallNumber("TestProfiler::profiledFunction"));
+}
+
+TEST(TestProfiler, threads)
+{
+    pml::Profiler::reset();
+
+    std::vector<std::thread> lThreads;
+    for (auto i = 0; i < 4; ++i)
+    {
+        lThreads.emplace_back([]()
+        {
+            for (auto j = 0; j < 5; ++j) {
+                profiledFunction();
+            }
+        });
+    }
+
+    // counters of living threads and finished ones are both merged.
+    for (auto i = 0; i < 5; ++i) {
+        profiledFunction();
+    }
+
+    for (auto& thread_i : lThreads) {
+        thread_i.join();
+    }
+
+    EXPECT_EQ(25U, getCallNumber("TestProfiler::profiledFunction"));
+}
+
+TEST(TestProfiler, report)
+{
+    pml::Profiler::reset();
+    nestedFunction();
+
+    std::stringstream lStream;
+    EXPECT_NO_THROW(pml::Profiler::outputReport(lStream));
+    EXPECT_NE(std::string::npos, lStream.str().find("TestProfiler::nestedFunction"));
+    EXPECT_NE(std::string::npos, lStream.str().find("TestProfiler::profiledFunction"));
+
+    EXPECT_NO_THROW(pml::Profiler::outputReport(std::cout));
+}
+
+TEST(TestProfiler, streamState)
+{
+    pml::Profiler::reset();
+    nestedFunction();
+
+    // the adjustment, the precision and the flags of the caller's stream are kept.
+    std::stringstream lStream;
+    lStream << std::hex << std::setprecision(5);
+    const auto lFlags = lStream.flags();
+
+    pml::Profiler::outputReport(lStream);
+    EXPECT_EQ(5, lStream.precision());
+    EXPECT_EQ(lFlags, lStream.flags());
+
+    lStream.str("");
+    lStream << std::setw(8) << 1.0 / 3.0 << " " << std::setw(4) << 255;
+    EXPECT_EQ(" 0.33333   ff", lStream.str());
+}
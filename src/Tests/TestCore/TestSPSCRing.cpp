@@ -0,0 +1,63 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/SPSCRing.h>
+
+#include <memory>
+#include <thread>
+
+TEST(TestSPSCRing, tryPushAndPop)
+{
+    EXPECT_THROW(pml::SPSCRing<int>(3), std::logic_error);
+
+    pml::SPSCRing<std::unique_ptr<int>> lRing(2);
+    EXPECT_EQ(2U, lRing.capacity());
+
+    EXPECT_TRUE (lRing.tryPush(std::make_unique<int>(1)));
+    EXPECT_TRUE (lRing.tryPush(std::make_unique<int>(2)));
+    EXPECT_FALSE(lRing.tryPush(std::make_unique<int>(3)));
+
+    std::unique_ptr<int> lItem;
+    ASSERT_TRUE(lRing.tryPop(lItem));
+    EXPECT_EQ(1, *lItem);
+    ASSERT_TRUE(lRing.tryPop(lItem));
+    EXPECT_EQ(2, *lItem);
+    EXPECT_FALSE(lRing.tryPop(lItem));
+
+    // items pushed before close are still popped.
+    EXPECT_TRUE(lRing.push(std::make_unique<int>(4)));
+    lRing.close();
+    EXPECT_FALSE(lRing.push(std::make_unique<int>(5)));
+    ASSERT_TRUE(lRing.pop(lItem));
+    EXPECT_EQ(4, *lItem);
+    EXPECT_FALSE(lRing.pop(lItem));
+}
+
+TEST(TestSPSCRing, producerAndConsumer)
+{
+    constexpr int lNumber = 200000;
+    pml::SPSCRing<int> lRing(8);
+
+    std::thread lProducer([&]()
+    {
+        for (int i = 0; i < lNumber; ++i) {
+            lRing.push(std::move(i));
+        }
+
+        lRing.close();
+    });
+
+    std::size_t lSum = 0;
+    int lExpected = 0;
+    int lItem = 0;
+    while (lRing.pop(lItem))
+    {
+        EXPECT_EQ(lExpected++, lItem);
+        lSum += static_cast<std::size_t>(lItem);
+    }
+
+    lProducer.join();
+
+    EXPECT_EQ(lNumber, lExpected);
+    EXPECT_EQ(static_cast<std::size_t>(lNumber) * (lNumber - 1) / 2, lSum);
+}
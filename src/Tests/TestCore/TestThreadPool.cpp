@@ -0,0 +1,171 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/ThreadPool.h>
+
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST(TestThreadPool, deque)
+{
+    constexpr int lNumber = 100000;
+    std::vector<int> lItems(lNumber);
+    std::vector<std::atomic<int>> lCounts(lNumber);
+
+    pml::detail::WorkStealingDeque<int> lDeque(2);
+    std::atomic<bool> lIsPushed(false);
+    std::atomic<int> lStolenNumber(0);
+
+    std::vector<std::thread> lThieves;
+    for (auto t = 0; t < 3; ++t)
+    {
+        lThieves.emplace_back([&]()
+        {
+            for (;;)
+            {
+                const bool lIsFinished = lIsPushed.load();
+                if (auto* lItem = lDeque.steal())
+                {
+                    ++lCounts[static_cast<std::size_t>(lItem - lItems.data())];
+                    ++lStolenNumber;
+                }
+                else if (lIsFinished && lDeque.empty()) {
+                    return;
+                }
+            }
+        });
+    }
+
+    for (auto i = 0; i < lNumber; ++i)
+    {
+        lDeque.push(&lItems[static_cast<std::size_t>(i)]);
+
+        if ((i % 3) == 0)
+        {
+            if (auto* lItem = lDeque.pop()) {
+                ++lCounts[static_cast<std::size_t>(lItem - lItems.data())];
+            }
+        }
+    }
+
+    while (auto* lItem = lDeque.pop()) {
+        ++lCounts[static_cast<std::size_t>(lItem - lItems.data())];
+    }
+
+    lIsPushed = true;
+    for (auto& thief_i : lThieves) {
+        thief_i.join();
+    }
+
+    for (const auto& count_i : lCounts) {
+        EXPECT_EQ(1, count_i.load());
+    }
+}
+
+TEST(TestThreadPool, parallelFor)
+{
+    pml::ThreadPool lPool(4);
+    EXPECT_EQ(4U, lPool.getThreadNumber());
+
+    for (const std::size_t grain_i : { 0U, 1U, 7U, 1000U, 100000U })
+    {
+        std::vector<std::atomic<int>> lCounts(10007);
+        lPool.parallelFor(0, lCounts.size(), grain_i, [&](std::size_t inFirst, std::size_t inLast)
+        {
+            EXPECT_LT(inFirst, inLast);
+            for (auto i = inFirst; i < inLast; ++i) {
+                ++lCounts[i];
+            }
+        });
+
+        for (const auto& count_i : lCounts) {
+            EXPECT_EQ(1, count_i.load());
+        }
+    }
+
+    auto lIsCalled = false;
+    lPool.parallelFor(5, 5, 1, [&](std::size_t, std::size_t) { lIsCalled = true; });
+    EXPECT_FALSE(lIsCalled);
+}
+
+TEST(TestThreadPool, parallelReduce)
+{
+    pml::ThreadPool lPool(3, true);
+    EXPECT_TRUE(lPool.isPinned());
+
+    std::vector<double> lArray(100003);
+    std::iota(lArray.begin(), lArray.end(), 0.0);
+
+    const auto lSum = lPool.parallelReduce(
+        0, lArray.size(), 1000, 0.0,
+        [&](std::size_t inFirst, std::size_t inLast) {
+            return std::accumulate(lArray.cbegin() + static_cast<std::ptrdiff_t>(inFirst), lArray.cbegin() + static_cast<std::ptrdiff_t>(inLast), 0.0);
+        },
+        [](double inX, double inY) { return inX + inY; });
+
+    EXPECT_EQ(std::accumulate(lArray.cbegin(), lArray.cend(), 0.0), lSum);
+
+    const auto lEmpty = lPool.parallelReduce(
+        3, 3, 0, 1.5,
+        [](std::size_t, std::size_t) { return 0.0; },
+        [](double inX, double inY) { return inX + inY; });
+
+    EXPECT_EQ(1.5, lEmpty);
+}
+
+TEST(TestThreadPool, nested)
+{
+    pml::ThreadPool lPool(2);
+
+    std::atomic<std::size_t> lCount(0);
+    lPool.parallelFor(0, 16, 1, [&](std::size_t inFirst, std::size_t inLast)
+    {
+        for (auto i = inFirst; i < inLast; ++i)
+        {
+            lPool.parallelFor(0, 1000, 10, [&](std::size_t inInnerFirst, std::size_t inInnerLast) {
+                lCount += (inInnerLast - inInnerFirst);
+            });
+        }
+    });
+
+    EXPECT_EQ(16000U, lCount.load());
+}
+
+TEST(TestThreadPool, exception)
+{
+    pml::ThreadPool lPool(4);
+
+    EXPECT_THROW(
+        lPool.parallelFor(0, 1000, 1, [](std::size_t inFirst, std::size_t) {
+            if (inFirst == 500) {
+                throw std::logic_error("Error in a task.");
+            }
+        }),
+        std::runtime_error);
+
+    // the pool is still usable.
+    std::atomic<std::size_t> lCount(0);
+    lPool.parallelFor(0, 1000, 1, [&](std::size_t inFirst, std::size_t inLast) { lCount += (inLast - inFirst); });
+    EXPECT_EQ(1000U, lCount.load());
+}
+
+TEST(TestThreadPool, global)
+{
+    EXPECT_LE(1U, pml::ThreadPool::getInstance().getThreadNumber());
+    EXPECT_THROW(pml::ThreadPool::configure(2, false), std::logic_error);
+
+    const auto lSum = pml::parallel_reduce(
+        0, 1000, 10, std::size_t(0),
+        [](std::size_t inFirst, std::size_t inLast) {
+            auto lPartial = std::size_t(0);
+            for (auto i = inFirst; i < inLast; ++i) {
+                lPartial += i;
+            }
+            return lPartial;
+        },
+        [](std::size_t inX, std::size_t inY) { return inX + inY; });
+
+    EXPECT_EQ(999U * 1000U / 2U, lSum);
+}
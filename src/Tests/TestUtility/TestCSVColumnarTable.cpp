@@ -0,0 +1,101 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Utility/CSVColumnarTable.h>
+#include <PML/Math/numeric_simd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+
+namespace {
+
+    const std::vector<pml::CSVColumnType> TEST_SCHEMA = {
+        pml::CSVColumnType::String, pml::CSVColumnType::Double, pml::CSVColumnType::Int64, pml::CSVColumnType::Date };
+}
+
+TEST(TestCSVColumnarTable, read)
+{
+    const std::string lCSV =
+        "name,price,volume,date\n"
+        "abc,1.5,100,1970-01-01\n"
+        "\" d,e \", -2.25e1 ,+7,2000-02-29\r\n"
+        "\n"
+        "f,,-9223372036854775808,1969-12-31\n";
+
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+    const pml::CSVColumnarTable lTable(lParser, TEST_SCHEMA, true);
+
+    EXPECT_EQ(3U, lTable.getRowNumber());
+    EXPECT_EQ(4U, lTable.getColumnNumber());
+    EXPECT_EQ((std::vector<std::string>{ "name", "price", "volume", "date" }), lTable.getNames());
+    EXPECT_EQ(2U, lTable.getColumnIndex("volume"));
+
+    EXPECT_EQ((std::vector<std::string>{ "abc", " d,e ", "f" }), lTable.getStrings(0));
+
+    const auto& lPrices = lTable.getDoubles(1);
+    EXPECT_EQ(1.5, lPrices[0]);
+    EXPECT_EQ(-22.5, lPrices[1]);
+    EXPECT_TRUE(std::isnan(lPrices[2]));
+    EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(lPrices.data()) % 64);
+
+    EXPECT_EQ((pml::CSVColumnarTable::Int64Column{ 100, 7, INT64_MIN }), lTable.getInt64s(2));
+    EXPECT_EQ((pml::CSVColumnarTable::DateColumn{ 0, 11016, -1 }), lTable.getDates(3));
+
+    EXPECT_THROW(lTable.getDoubles(0), std::logic_error);
+    EXPECT_THROW(lTable.getColumnIndex("none"), std::logic_error);
+}
+
+TEST(TestCSVColumnarTable, accumulate)
+{
+    const std::string lFilePath = "TestCSVColumnarTable_accumulate.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::trunc);
+        for (auto i = 0; i < 1001; ++i) {
+            lFile << i << "," << 0.5 * i << "\n";
+        }
+    }
+
+    const pml::CSVColumnarTable lTable(lFilePath, { pml::CSVColumnType::Int64, pml::CSVColumnType::Double }, false);
+
+    EXPECT_EQ(1001U, lTable.getRowNumber());
+    EXPECT_TRUE(lTable.getNames().empty());
+    EXPECT_EQ(250250.0, pml::accumulate_SIMD(lTable.getDoubles(1), 0.0));
+    EXPECT_EQ(500500, std::accumulate(lTable.getInt64s(0).cbegin(), lTable.getInt64s(0).cend(), std::int64_t(0)));
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(TestCSVColumnarTable, error)
+{
+    const std::vector<std::string> lInvalids = {
+        "a,1.5x,1,2000-01-01", "a,1.5,1.0,2000-01-01", "a,1.5,1,2001-02-29", "a,1.5,1,2000/01/01", "a,1.5,1", "a,1.5,99999999999999999999,2000-01-01",
+        "a,+-5,1,2000-01-01", "a,1.5,+-5,2000-01-01", "a,1.5,++5,2000-01-01", "a,+,1,2000-01-01" };
+
+    for (const auto& invalid_i : lInvalids)
+    {
+        pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, invalid_i);
+        EXPECT_THROW(pml::CSVColumnarTable(lParser, TEST_SCHEMA, false), std::runtime_error);
+    }
+}
+
+TEST(TestCSVColumnarTable, oneColumn)
+{
+    // blank lines are empty fields in a schema of one column.
+    const std::string lCSV = "a\n\n\"\"\nb\n";
+
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+    const pml::CSVColumnarTable lTable(lParser, { pml::CSVColumnType::String }, false);
+    EXPECT_EQ((std::vector<std::string>{ "a", "", "", "b" }), lTable.getStrings(0));
+
+    const std::string lNumbers = "+1.5\n\n+.5\n";
+    pml::CSVParser lNumberParser(pml::CSVParser::InputType::STRING_REF, lNumbers);
+    const pml::CSVColumnarTable lNumberTable(lNumberParser, { pml::CSVColumnType::Double }, false);
+
+    ASSERT_EQ(3U, lNumberTable.getRowNumber());
+    EXPECT_EQ(1.5, lNumberTable.getDoubles(0)[0]);
+    EXPECT_TRUE(std::isnan(lNumberTable.getDoubles(0)[1]));
+    EXPECT_EQ(0.5, lNumberTable.getDoubles(0)[2]);
+}
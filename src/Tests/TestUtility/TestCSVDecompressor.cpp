@@ -0,0 +1,197 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Utility/CSVDecompressor.h>
+#include <PML/Utility/CSVParser.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+namespace {
+
+    std::string makeCSV()
+    {
+        std::mt19937 lEngine(6);
+        const std::vector<std::string> lFields = { "", "a", " b ", "\"c,d\"", "\"e\"\"f\"", "\"g\nh\"", "\"\r\n\"", std::string(300, 'i') };
+        const std::vector<std::string> lNewLines = { "\n", "\r", "\r\n" };
+
+        std::string lCSV;
+        while (lCSV.size() < 100000)
+        {
+            const auto lFieldNumber = std::uniform_int_distribution<std::size_t>(1, 4)(lEngine);
+            for (std::size_t i = 0; i < lFieldNumber; ++i) {
+                lCSV += ((i == 0) ? "" : ",") + lFields[std::uniform_int_distribution<std::size_t>(0, lFields.size() - 1)(lEngine)];
+            }
+
+            lCSV += lNewLines[std::uniform_int_distribution<std::size_t>(0, lNewLines.size() - 1)(lEngine)];
+        }
+
+        return lCSV;
+    }
+
+    void writeFile(const std::string& inFilePath, const std::string& inData)
+    {
+        std::ofstream lFile(inFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << inData;
+    }
+
+    std::vector<std::vector<std::string>> readAll(const std::string& inFilePath, std::size_t inBufferSize)
+    {
+        pml::CSVParser lParser(pml::CSVParser::InputType::COMPRESSED_FILE, inFilePath, inBufferSize);
+
+        std::vector<std::vector<std::string>> lRecords;
+        std::vector<std::string_view> lView;
+        while (lParser.readNextOneRecordView(lView)) {
+            lRecords.emplace_back(lView.cbegin(), lView.cend());
+        }
+
+        return lRecords;
+    }
+
+#ifdef PML_ENABLE_ZLIB
+
+    std::string compress(const std::string& inData)
+    {
+        z_stream lStream{};
+        deflateInit2(&lStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+
+        std::string lCompressed(deflateBound(&lStream, static_cast<uLong>(inData.size())) + 32, '\0');
+        lStream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(inData.data()));
+        lStream.avail_in  = static_cast<uInt>(inData.size());
+        lStream.next_out  = reinterpret_cast<Bytef*>(&lCompressed[0]);
+        lStream.avail_out = static_cast<uInt>(lCompressed.size());
+
+        deflate(&lStream, Z_FINISH);
+        lCompressed.resize(lStream.total_out);
+        deflateEnd(&lStream);
+
+        return lCompressed;
+    }
+
+#endif
+
+#ifdef PML_ENABLE_ZSTD
+
+    std::string compressZstd(const std::string& inData)
+    {
+        std::string lCompressed(ZSTD_compressBound(inData.size()), '\0');
+        lCompressed.resize(ZSTD_compress(&lCompressed[0], lCompressed.size(), inData.data(), inData.size(), 3));
+
+        return lCompressed;
+    }
+
+#endif
+}
+
+TEST(TestCSVDecompressor, uncompressed)
+{
+    const std::string lFilePath = "TestCSVDecompressor_uncompressed.csv";
+    writeFile(lFilePath, makeCSV());
+
+    const auto lExpected = pml::CSVParser::readAllRecords(lFilePath);
+    EXPECT_EQ(lExpected, readAll(lFilePath, 0));
+    EXPECT_EQ(lExpected, readAll(lFilePath, 7));
+
+    writeFile(lFilePath, "");
+    EXPECT_TRUE(readAll(lFilePath, 0).empty());
+
+    EXPECT_FALSE(pml::CSVParser(pml::CSVParser::InputType::COMPRESSED_FILE, "TestCSVDecompressor_notFound.csv.gz").isOpen());
+
+    std::remove(lFilePath.c_str());
+}
+
+#ifdef PML_ENABLE_ZLIB
+
+TEST(TestCSVDecompressor, gzip)
+{
+    const auto lCSV = makeCSV();
+    const std::string lFilePath = "TestCSVDecompressor_gzip.csv";
+    const std::string lGzipPath = lFilePath + ".gz";
+
+    writeFile(lFilePath, lCSV);
+    const auto lExpected = pml::CSVParser::readAllRecords(lFilePath);
+
+    writeFile(lGzipPath, compress(lCSV));
+    for (const auto buffer_i : { 7, 1000, 0 }) {
+        EXPECT_EQ(lExpected, readAll(lGzipPath, buffer_i)) << buffer_i;
+    }
+
+    // concatenated members are one data as gzip -d.
+    const auto lHalf = lCSV.size() / 2;
+    writeFile(lGzipPath, compress(lCSV.substr(0, lHalf)) + compress(lCSV.substr(lHalf)));
+    EXPECT_EQ(lExpected, readAll(lGzipPath, 64));
+
+    // errors are thrown by the parsing thread.
+    const auto lCompressed = compress(lCSV);
+    writeFile(lGzipPath, lCompressed.substr(0, lCompressed.size() / 2));
+    EXPECT_THROW(readAll(lGzipPath, 64), std::runtime_error);
+
+    writeFile(lGzipPath, lCompressed.substr(0, 10) + std::string(100, 'x'));
+    EXPECT_THROW(readAll(lGzipPath, 0), std::runtime_error);
+
+    std::remove(lFilePath.c_str());
+    std::remove(lGzipPath.c_str());
+}
+
+#else
+
+TEST(TestCSVDecompressor, gzipDisabled)
+{
+    const std::string lFilePath = "TestCSVDecompressor_gzipDisabled.csv.gz";
+    writeFile(lFilePath, std::string("\x1F\x8B\x08\x00", 4));
+
+    EXPECT_THROW(pml::CSVParser(pml::CSVParser::InputType::COMPRESSED_FILE, lFilePath), std::runtime_error);
+
+    std::remove(lFilePath.c_str());
+}
+
+#endif
+
+#ifdef PML_ENABLE_ZSTD
+
+TEST(TestCSVDecompressor, zstd)
+{
+    const auto lCSV = makeCSV();
+    const std::string lFilePath = "TestCSVDecompressor_zstd.csv";
+    const std::string lZstdPath = lFilePath + ".zst";
+
+    writeFile(lFilePath, lCSV);
+    const auto lExpected = pml::CSVParser::readAllRecords(lFilePath);
+
+    // small buffers are filled while the stream still holds decoded bytes at the end of the file.
+    writeFile(lZstdPath, compressZstd(lCSV));
+    for (const auto buffer_i : { 7, 1000, 0 }) {
+        EXPECT_EQ(lExpected, readAll(lZstdPath, buffer_i)) << buffer_i;
+    }
+
+    // concatenated frames are one data as zstd -d.
+    const auto lHalf = lCSV.size() / 2;
+    writeFile(lZstdPath, compressZstd(lCSV.substr(0, lHalf)) + compressZstd(lCSV.substr(lHalf)));
+    EXPECT_EQ(lExpected, readAll(lZstdPath, 64));
+
+    // errors are thrown by the parsing thread.
+    const auto lCompressed = compressZstd(lCSV);
+    writeFile(lZstdPath, lCompressed.substr(0, lCompressed.size() / 2));
+    EXPECT_THROW(readAll(lZstdPath, 64), std::runtime_error);
+
+    writeFile(lZstdPath, lCompressed.substr(0, 10) + std::string(100, 'x'));
+    EXPECT_THROW(readAll(lZstdPath, 0), std::runtime_error);
+
+    std::remove(lFilePath.c_str());
+    std::remove(lZstdPath.c_str());
+}
+
+#else
+
+TEST(TestCSVDecompressor, zstdDisabled)
+{
+    const std::string lFilePath = "TestCSVDecompressor_zstdDisabled.csv.zst";
+    writeFile(lFilePath, std::string("\x28\xB5\x2F\xFD", 4));
+
+    EXPECT_THROW(pml::CSVParser(pml::CSVParser::InputType::COMPRESSED_FILE, lFilePath), std::runtime_error);
+
+    std::remove(lFilePath.c_str());
+}
+
+#endif
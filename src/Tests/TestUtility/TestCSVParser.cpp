@@ -2,6 +2,18 @@
 
 #include <gtest/gtest.h>
 #include <PML/Utility/CSVParser.h>
+#include <PML/Core/MemoryResource.h>
+#include <PML/Core/ThreadPool.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 
 class CSVParserString : public ::testing::TestWithParam<std::pair<std::string,std::vector<std::string>>> {};
 
@@ -38,6 +50,130 @@ TEST_P(CSVParserString, refAndCopy)
     }
 }
 
+TEST_P(CSVParserString, memoryResource)
+{
+    pml::ArenaResource lArena(64);
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, GetParam().first);
+
+    auto lIdx = 0U;
+    while (!lParser.isEnd())
+    {
+        pml::ArenaScope lScope(lArena);
+        const auto lBuffer = lParser.readNextOneRecord(&lArena);
+
+        for (const auto& field_i : lBuffer)
+        {
+            EXPECT_EQ(&lArena, field_i.get_allocator().resource());
+            EXPECT_EQ(GetParam().second[lIdx], std::string(field_i.cbegin(), field_i.cend()));
+            ++lIdx;
+        }
+    }
+
+    EXPECT_EQ(GetParam().second.size(), lIdx);
+}
+
+TEST_P(CSVParserString, view)
+{
+    std::vector<pml::CSVParser::InputType> lTypes
+        = { pml::CSVParser::InputType::STRING_REF ,pml::CSVParser::InputType::STRING_COPY };
+
+    for (const auto& type_i : lTypes)
+    {
+        pml::CSVParser lParser(type_i, GetParam().first);
+
+        std::vector<std::string_view> lFields;
+        auto lIdx = 0U;
+        while (lParser.readNextOneRecordView(lFields))
+        {
+            for (const auto& field_i : lFields)
+            {
+                EXPECT_EQ(GetParam().second[lIdx], field_i);
+                ++lIdx;
+            }
+        }
+
+        EXPECT_TRUE(lFields.empty());
+        EXPECT_EQ(GetParam().second.size(), lIdx);
+    }
+}
+
+TEST_P(CSVParserString, fileAndMMap)
+{
+    const std::string lFilePath = "TestCSVParser_fileAndMMap.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << GetParam().first;
+    }
+
+    std::vector<pml::CSVParser::InputType> lTypes
+        = { pml::CSVParser::InputType::FILE ,pml::CSVParser::InputType::MMAP, pml::CSVParser::InputType::ASYNC_FILE };
+
+    for (const auto& type_i : lTypes)
+    {
+        pml::CSVParser lParser(type_i, lFilePath);
+
+        EXPECT_TRUE(lParser.isOpen());
+
+        auto lIdx = 0U;
+        while (!lParser.isEnd())
+        {
+            for (const auto& field_i : lParser.readNextOneRecord())
+            {
+                EXPECT_EQ(GetParam().second[lIdx], field_i);
+                ++lIdx;
+            }
+        }
+
+        EXPECT_EQ(GetParam().second.size(), lIdx);
+
+        pml::CSVParser lViewParser(type_i, lFilePath);
+        std::vector<std::string_view> lFields;
+        lIdx = 0U;
+        while (lViewParser.readNextOneRecordView(lFields))
+        {
+            for (const auto& field_i : lFields)
+            {
+                EXPECT_EQ(GetParam().second[lIdx], field_i);
+                ++lIdx;
+            }
+        }
+
+        EXPECT_EQ(GetParam().second.size(), lIdx);
+    }
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST_P(CSVParserString, forEachRecord)
+{
+    const std::string lFilePath = "TestCSVParser_forEachRecord.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << GetParam().first;
+    }
+
+    for (const auto type_i : { pml::CSVParser::InputType::FILE, pml::CSVParser::InputType::STRING_REF, pml::CSVParser::InputType::MMAP })
+    {
+        pml::CSVParser lParser(type_i, (type_i == pml::CSVParser::InputType::STRING_REF) ? GetParam().first : lFilePath);
+
+        auto lIdx = 0U;
+        const auto lRecordNumber = lParser.forEachRecord([&](const std::vector<std::string_view>& inFields)
+        {
+            for (const auto& field_i : inFields)
+            {
+                EXPECT_EQ(GetParam().second[lIdx], field_i);
+                ++lIdx;
+            }
+        });
+
+        EXPECT_EQ(GetParam().second.size(), lIdx);
+        EXPECT_EQ(lParser.getLineNumber(), lRecordNumber);
+        EXPECT_TRUE(lParser.isEnd());
+    }
+
+    std::remove(lFilePath.c_str());
+}
+
 INSTANTIATE_TEST_CASE_P(
     name, CSVParserString,
     ::testing::Values(
@@ -56,7 +192,90 @@ INSTANTIATE_TEST_CASE_P(
         std::make_pair(std::string("abc,def,ghi\njkl,mn,op\n"), std::vector<std::string>{ "abc", "def", "ghi", "jkl", "mn", "op" }),
         std::make_pair(std::string("abc,def,ghi\rjkl,mn,op\r"), std::vector<std::string>{ "abc", "def", "ghi", "jkl", "mn", "op" }),
         std::make_pair(std::string("abc,def,ghi\r\njkl,mn,op\r\n"), std::vector<std::string>{ "abc", "def", "ghi", "jkl", "mn", "op" }),
-        std::make_pair(std::string("ab,cd,ef\ngh,ij,kl\nmn,op"), std::vector<std::string>{ "ab", "cd", "ef", "gh", "ij", "kl","mn","op" })));
+        std::make_pair(std::string("ab,cd,ef\ngh,ij,kl\nmn,op"), std::vector<std::string>{ "ab", "cd", "ef", "gh", "ij", "kl","mn","op" }),
+        std::make_pair(std::string("\"a\"\"b\",\"\"\"\"\n\"\",c"), std::vector<std::string>{ "a\"b", "\"", "", "c" })));
+
+TEST(CSVParserStatic, viewLifetime)
+{
+    const std::string lData = "abc,\"d\"\"e\",\"fg\"\n\"h\"\"\"\"\",ij";
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lData);
+
+    std::vector<std::string_view> lFirst;
+    ASSERT_TRUE(lParser.readNextOneRecordView(lFirst));
+    ASSERT_EQ(3U, lFirst.size());
+    EXPECT_EQ("abc", lFirst[0]);
+    EXPECT_EQ("d\"e", lFirst[1]);
+    EXPECT_EQ("fg", lFirst[2]);
+
+    // fields without escapes refer to the input itself and outlive the next call.
+    EXPECT_EQ(lData.data(), lFirst[0].data());
+    EXPECT_EQ(lData.data() + 12, lFirst[2].data());
+
+    std::vector<std::string_view> lSecond;
+    ASSERT_TRUE(lParser.readNextOneRecordView(lSecond));
+    ASSERT_EQ(2U, lSecond.size());
+    EXPECT_EQ("h\"\"", lSecond[0]);
+    EXPECT_EQ("ij", lSecond[1]);
+    EXPECT_EQ("abc", lFirst[0]);
+    EXPECT_EQ("fg", lFirst[2]);
+
+    EXPECT_FALSE(lParser.readNextOneRecordView(lSecond));
+    EXPECT_TRUE(lSecond.empty());
+}
+
+TEST(CSVParserStatic, mmap)
+{
+    pml::CSVParser lNotFound(pml::CSVParser::InputType::MMAP, "TestCSVParser_notFound.csv");
+    EXPECT_FALSE(lNotFound.isOpen());
+    EXPECT_TRUE(lNotFound.isEnd());
+
+    const std::string lFilePath = "TestCSVParser_empty.csv";
+    std::ofstream(lFilePath, std::ios::out | std::ios::trunc).close();
+
+    {
+        pml::CSVParser lEmpty(pml::CSVParser::InputType::MMAP, lFilePath);
+        EXPECT_TRUE(lEmpty.isOpen());
+        EXPECT_TRUE(lEmpty.isEnd());
+        EXPECT_TRUE(lEmpty.readNextOneRecord().empty());
+    }
+
+    std::remove(lFilePath.c_str());
+}
+
+#ifndef _WIN32
+TEST(CSVParserStatic, pipe)
+{
+    // pipes cannot be mapped, and the convenience APIs read them by FILE only once.
+    const std::string lFilePath = "TestCSVParser_pipe.csv";
+    std::remove(lFilePath.c_str());
+    ASSERT_EQ(0, ::mkfifo(lFilePath.c_str(), 0600));
+
+    const auto lFeed = [&]() {
+        return std::thread([&]() {
+            std::ofstream lPipe(lFilePath, std::ios::out | std::ios::binary);
+            lPipe << "x,y,z\n1,2,3\n";
+        });
+    };
+
+    auto lWriter = lFeed();
+    EXPECT_EQ(std::vector<std::vector<std::string>>({ { "x", "y", "z" }, { "1", "2", "3" } }), pml::CSVParser::readAllRecords(lFilePath));
+    lWriter.join();
+
+    lWriter = lFeed();
+    EXPECT_EQ(2U, pml::CSVParser::readAllRecordsParallel(lFilePath).size());
+    lWriter.join();
+
+    lWriter = lFeed();
+    const auto lTable = pml::CSVParser::readTable(lFilePath, false, std::vector<std::string>{ "z", "x" });
+    lWriter.join();
+
+    EXPECT_EQ(2U, lTable.size());
+    EXPECT_EQ(std::vector<std::string>({ "3" }), lTable.at("z"));
+    EXPECT_EQ(std::vector<std::string>({ "1" }), lTable.at("x"));
+
+    std::remove(lFilePath.c_str());
+}
+#endif
 
 TEST(CSVParserStatic, allRecords)
 {
@@ -93,4 +312,638 @@ TEST(CSVParserStatic, table_map)
     EXPECT_EQ(lTable_ColumnKey, lTable_RowKey);
     EXPECT_EQ(3U, lTable_ColumnKey.size());
     EXPECT_EQ(3U, lTable_RowKey.size());
-}
\ No newline at end of file
+}
+TEST(CSVParserStatic, structuralIndex)
+{
+    // contiguous sources are parsed by the structural index and files by the character-wise parser,
+    // so both must give the same records over chunk boundaries of the index.
+    std::mt19937 lEngine(0);
+    const std::vector<std::string> lFields = {
+        "", "a", " b ", "cd,e", "\"f\"", " \"g\" ", "\"h\"\"i\"", "\"\"\"\"", "\"j\nk\"", "\"l\r\n,m\"", "\"\" \"\"", std::string(70, 'n') };
+    const std::vector<std::string> lNewLines = { "\n", "\r", "\r\n" };
+
+    std::string lCSV;
+    while (lCSV.size() < 40000)
+    {
+        const auto lFieldNumber = std::uniform_int_distribution<std::size_t>(1, 5)(lEngine);
+        for (std::size_t i = 0; i < lFieldNumber; ++i) {
+            lCSV += ((i == 0) ? "" : ",") + lFields[std::uniform_int_distribution<std::size_t>(0, lFields.size() - 1)(lEngine)];
+        }
+
+        lCSV += lNewLines[std::uniform_int_distribution<std::size_t>(0, lNewLines.size() - 1)(lEngine)];
+    }
+
+    const std::string lFilePath = "TestCSVParser_structuralIndex.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    pml::CSVParser lIndexed(pml::CSVParser::InputType::STRING_REF, lCSV);
+    pml::CSVParser lScalar (pml::CSVParser::InputType::FILE, lFilePath);
+    std::vector<std::string_view> lView;
+
+    while (!lScalar.isEnd())
+    {
+        const auto lExpected = lScalar.readNextOneRecord();
+        ASSERT_TRUE(lIndexed.readNextOneRecordView(lView));
+        ASSERT_EQ(lExpected, std::vector<std::string>(lView.cbegin(), lView.cend()));
+        ASSERT_EQ(lScalar.getLineNumber(), lIndexed.getLineNumber());
+    }
+
+    EXPECT_TRUE(lIndexed.isEnd());
+    EXPECT_EQ(lScalar.getLineNumber(), pml::CSVParser::readAllRecords(lFilePath).size());
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(CSVParserStatic, allRecordsParallel)
+{
+    // small chunks split records, quoted newlines and CRLF at arbitrary points.
+    std::mt19937 lEngine(1);
+    const std::vector<std::string> lFields = { "", "a", " b ", "\"c,d\"", "\"e\"\"f\"", "\"g\nh\"", "\"\r\n\"", std::string(300, 'i') };
+    const std::vector<std::string> lNewLines = { "\n", "\r", "\r\n" };
+
+    std::string lCSV;
+    while (lCSV.size() < 20000)
+    {
+        const auto lFieldNumber = std::uniform_int_distribution<std::size_t>(1, 4)(lEngine);
+        for (std::size_t i = 0; i < lFieldNumber; ++i) {
+            lCSV += ((i == 0) ? "" : ",") + lFields[std::uniform_int_distribution<std::size_t>(0, lFields.size() - 1)(lEngine)];
+        }
+
+        lCSV += lNewLines[std::uniform_int_distribution<std::size_t>(0, lNewLines.size() - 1)(lEngine)];
+    }
+
+    const std::string lFilePath = "TestCSVParser_allRecordsParallel.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    const auto lExpected = pml::CSVParser::readAllRecords(lFilePath);
+    pml::ThreadPool lPool(4);
+
+    for (const auto chunk_i : { 1, 7, 64, 1000, 0 }) {
+        EXPECT_EQ(lExpected, pml::CSVParser::readAllRecordsParallel(lFilePath, lPool, chunk_i));
+    }
+
+    EXPECT_TRUE(pml::CSVParser::readAllRecordsParallel("TestCSVParser_notFound.csv", lPool, 7).empty());
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(CSVParserStatic, asyncFile)
+{
+    // small buffers split records, quoted newlines and CRLF at arbitrary points, and long records span several buffers.
+    std::mt19937 lEngine(3);
+    const std::vector<std::string> lFields = { "", "a", " b ", "\"c,d\"", "\"e\"\"f\"", "\"g\nh\"", "\"\r\n\"", std::string(300, 'i') };
+    const std::vector<std::string> lNewLines = { "\n", "\r", "\r\n" };
+
+    std::string lCSV;
+    while (lCSV.size() < 20000)
+    {
+        const auto lFieldNumber = std::uniform_int_distribution<std::size_t>(1, 4)(lEngine);
+        for (std::size_t i = 0; i < lFieldNumber; ++i) {
+            lCSV += ((i == 0) ? "" : ",") + lFields[std::uniform_int_distribution<std::size_t>(0, lFields.size() - 1)(lEngine)];
+        }
+
+        lCSV += lNewLines[std::uniform_int_distribution<std::size_t>(0, lNewLines.size() - 1)(lEngine)];
+    }
+
+    const std::string lFilePath = "TestCSVParser_asyncFile.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    const auto lExpected = pml::CSVParser::readAllRecords(lFilePath);
+
+    for (const auto buffer_i : { 1, 2, 7, 64, 1000, 0 })
+    {
+        pml::CSVParser lParser(pml::CSVParser::InputType::ASYNC_FILE, lFilePath, buffer_i);
+        ASSERT_TRUE(lParser.isOpen());
+
+        std::vector<std::string_view> lView;
+        for (std::size_t i = 0; i < lExpected.size(); ++i)
+        {
+            ASSERT_TRUE(lParser.readNextOneRecordView(lView));
+            ASSERT_EQ(lExpected[i], std::vector<std::string>(lView.cbegin(), lView.cend())) << buffer_i;
+            ASSERT_EQ(i + 1, lParser.getLineNumber());
+        }
+
+        EXPECT_TRUE(lParser.isEnd());
+        EXPECT_FALSE(lParser.readNextOneRecordView(lView));
+    }
+
+    // the reader thread is stopped if the parser is destroyed before the end.
+    {
+        pml::CSVParser lParser(pml::CSVParser::InputType::ASYNC_FILE, lFilePath, 16);
+        EXPECT_EQ(lExpected[0], lParser.readNextOneRecord());
+    }
+
+    EXPECT_FALSE(pml::CSVParser(pml::CSVParser::InputType::ASYNC_FILE, "TestCSVParser_notFound.csv").isOpen());
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(CSVParserStatic, forEachRecordStop)
+{
+    const std::string lCSV = "a\nb\nc\nd";
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+
+    std::vector<std::string> lVisited;
+    const auto lRecordNumber = lParser.forEachRecord([&](const std::vector<std::string_view>& inFields)
+    {
+        lVisited.emplace_back(inFields.front());
+        return (inFields.front() != "b");
+    });
+
+    EXPECT_EQ(2U, lRecordNumber);
+    EXPECT_EQ((std::vector<std::string>{ "a", "b" }), lVisited);
+    EXPECT_FALSE(lParser.isEnd());
+    EXPECT_EQ(1U, lParser.forEachRecord([](const std::vector<std::string_view>&) { return false; }));
+    EXPECT_EQ(1U, lParser.forEachRecord([](const std::vector<std::string_view>&) {}));
+    EXPECT_TRUE(lParser.isEnd());
+}
+
+TEST(CSVParserStatic, projection)
+{
+    const std::string lCSV = "a,b,c,d\n1,\"x\"\"y\",3\n\"p\" ,q,\"r,\",s";
+    const std::vector<std::vector<std::string>> lExpected = { { "d", "b" }, { "", "x\"y" }, { "s", "q" } };
+
+    const std::string lFilePath = "TestCSVParser_projection.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    for (const auto type_i : { pml::CSVParser::InputType::FILE, pml::CSVParser::InputType::STRING_REF, pml::CSVParser::InputType::MMAP })
+    {
+        const auto& lSource = (type_i == pml::CSVParser::InputType::STRING_REF) ? lCSV : lFilePath;
+
+        pml::CSVParser lParser(type_i, lSource);
+        lParser.setProjection(std::vector<std::size_t>{ 3, 1 });
+        for (const auto& expected_i : lExpected) {
+            EXPECT_EQ(expected_i, lParser.readNextOneRecord());
+        }
+        EXPECT_TRUE(lParser.isEnd());
+
+        pml::CSVParser lViewParser(type_i, lSource);
+        lViewParser.setProjection(std::vector<std::size_t>{ 3, 1 });
+        std::vector<std::string_view> lFields;
+        for (const auto& expected_i : lExpected)
+        {
+            ASSERT_TRUE(lViewParser.readNextOneRecordView(lFields));
+            EXPECT_EQ(expected_i, std::vector<std::string>(lFields.cbegin(), lFields.cend()));
+        }
+
+        pml::CSVParser lNameParser(type_i, lSource);
+        lNameParser.setProjection(std::vector<std::string>{ "c", "a" });
+        EXPECT_EQ((std::vector<std::string>{ "3", "1" }), lNameParser.readNextOneRecord());
+        EXPECT_EQ((std::vector<std::string>{ "r,", "p" }), lNameParser.readNextOneRecord());
+
+        lNameParser.resetProjection();
+        EXPECT_TRUE(lNameParser.readNextOneRecord().empty());
+        EXPECT_EQ(3U, lNameParser.getLineNumber());
+    }
+
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+    EXPECT_THROW(lParser.setProjection(std::vector<std::size_t>{ 1, 1 }), std::logic_error);
+    EXPECT_THROW(lParser.setProjection(std::vector<std::string>{ "e" }), std::runtime_error);
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(CSVParserStatic, table_projection)
+{
+    const std::string lColumnKeyPath = "..\\..\\..\\src\\Tests\\TestUtility\\TestTable_ColumnKey.csv";
+    const std::string lRowKeyPath    = "..\\..\\..\\src\\Tests\\TestUtility\\TestTable_RowKey.csv";
+
+    const std::unordered_map<std::string, std::vector<std::string>> lColumnKeyExpected = {
+        { "a", { "0.1", "0.1" } }, { "b", { "0.5", "0.4" } }, { "c", { "0.3", "0.2" } } };
+    EXPECT_EQ(lColumnKeyExpected, pml::CSVParser::readTable(lColumnKeyPath, true, std::vector<std::size_t>{ 3, 1 }));
+    EXPECT_EQ(
+        (std::unordered_map<std::string, std::vector<std::string>>{ { "a", { "0.1", "0.15" } }, { "b", { "0.4", "0.3" } }, { "c", { "0.2", "0.3" } } }),
+        pml::CSVParser::readTable(lColumnKeyPath, true, std::vector<std::string>{ "0.1", "0.15" }));
+
+    const std::map<std::string, std::vector<std::string>> lRowKeyExpected = { { "a", { "0.1", "0.15", "0.1" } }, { "c", { "0.2", "0.3", "0.3" } } };
+    EXPECT_EQ(lRowKeyExpected, pml::CSVParser::readTable<std::map>(lRowKeyPath, false, std::vector<std::size_t>{ 2, 0 }));
+    EXPECT_EQ(lRowKeyExpected, pml::CSVParser::readTable<std::map>(lRowKeyPath, false, std::vector<std::string>{ "c", "a" }));
+}
+
+TEST(CSVParserStatic, errorTolerant)
+{
+    // a double quotation in an unquoted field, characters after a quoted field and an unclosed quoted field.
+    const std::string lCSV = "a,b\nc\"d,e\nf,\"g\"h\ni,j\nk,\"l\nm,n";
+    const std::vector<std::size_t> lLines   = { 2, 3, 5 };
+    const std::vector<std::size_t> lColumns = { 0, 1, 1 };
+
+    const std::string lFilePath = "TestCSVParser_errorTolerant.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    const auto lCheckErrors = [&](const pml::CSVParser& inParser) {
+        ASSERT_EQ(lLines.size(), inParser.getErrors().size());
+        for (std::size_t i = 0; i < lLines.size(); ++i)
+        {
+            EXPECT_EQ(lLines[i], inParser.getErrors()[i].mLineNumber);
+            EXPECT_EQ(lColumns[i], inParser.getErrors()[i].mColumn);
+            EXPECT_NE(nullptr, inParser.getErrors()[i].mReason);
+        }
+    };
+
+    std::vector<std::unique_ptr<pml::CSVParser>> lParsers;
+    lParsers.push_back(std::make_unique<pml::CSVParser>(pml::CSVParser::InputType::STRING_REF, lCSV));
+    lParsers.push_back(std::make_unique<pml::CSVParser>(pml::CSVParser::InputType::STRING_COPY, lCSV));
+    lParsers.push_back(std::make_unique<pml::CSVParser>(pml::CSVParser::InputType::MMAP, lFilePath));
+    lParsers.push_back(std::make_unique<pml::CSVParser>(pml::CSVParser::InputType::ASYNC_FILE, lFilePath, 4));
+
+    for (auto& parser_i : lParsers)
+    {
+        parser_i->setErrorTolerant(true);
+
+        std::vector<std::string_view> lView;
+        ASSERT_TRUE(parser_i->readNextOneRecordView(lView));
+        EXPECT_EQ(std::vector<std::string_view>({ "a", "b" }), lView);
+        EXPECT_EQ(std::vector<std::string>({ "i", "j" }), parser_i->readNextOneRecord());
+        EXPECT_EQ(std::vector<std::string>({ "m", "n" }), parser_i->readNextOneRecord());
+        EXPECT_TRUE(parser_i->isEnd());
+        EXPECT_EQ(6U, parser_i->getLineNumber());
+
+        lCheckErrors(*parser_i);
+        parser_i->clearErrors();
+        EXPECT_TRUE(parser_i->getErrors().empty());
+    }
+
+    // FILE cannot go back, so that the unclosed field swallows the rest.
+    {
+        pml::CSVParser lParser(pml::CSVParser::InputType::FILE, lFilePath);
+        lParser.setErrorTolerant(true);
+
+        EXPECT_EQ(std::vector<std::string>({ "a", "b" }), lParser.readNextOneRecord());
+        EXPECT_EQ(std::vector<std::string>({ "i", "j" }), lParser.readNextOneRecord());
+
+        std::vector<std::string_view> lView;
+        EXPECT_FALSE(lParser.readNextOneRecordView(lView));
+        EXPECT_TRUE(lParser.isEnd());
+        lCheckErrors(lParser);
+    }
+
+    // the third error exceeds the cap.
+    {
+        pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+        lParser.setErrorTolerant(true, 2);
+        lParser.setProjection(std::vector<std::size_t>{ 1 });
+
+        EXPECT_EQ(std::vector<std::string>({ "b" }), lParser.readNextOneRecord());
+        EXPECT_EQ(std::vector<std::string>({ "j" }), lParser.readNextOneRecord());
+        EXPECT_THROW(lParser.readNextOneRecord(), std::runtime_error);
+        EXPECT_EQ(2U, lParser.getErrors().size());
+    }
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(CSVParserStatic, errorResync)
+{
+    // malformed records throw by default, and the following records are read after them.
+    const std::string lCSV = "a\n\"b\nc\nd\"e\nf";
+
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+    EXPECT_EQ(std::vector<std::string>({ "a" }), lParser.readNextOneRecord());
+    EXPECT_THROW(lParser.readNextOneRecord(), std::runtime_error);
+    EXPECT_EQ(std::vector<std::string>({ "c" }), lParser.readNextOneRecord());
+    EXPECT_THROW(lParser.readNextOneRecord(), std::runtime_error);
+    EXPECT_EQ(std::vector<std::string>({ "f" }), lParser.readNextOneRecord());
+    EXPECT_TRUE(lParser.isEnd());
+    EXPECT_TRUE(lParser.getErrors().empty());
+
+    // many unclosed fields are skipped without scanning the rest of data again for each of them.
+    std::string lDirty;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        lDirty += "x,\"y\n";
+    }
+    lDirty += "z";
+
+    pml::CSVParser lDirtyParser(pml::CSVParser::InputType::STRING_REF, lDirty);
+    lDirtyParser.setErrorTolerant(true);
+    EXPECT_EQ(std::vector<std::string>({ "z" }), lDirtyParser.readNextOneRecord());
+    EXPECT_EQ(100000U, lDirtyParser.getErrors().size());
+}
+
+TEST(CSVParserStatic, tryRead)
+{
+    const std::string lCSV = "a,b\nc\"d,e\nf,\"g\"h\ni,j\nk,\"l\nm,n";
+    const std::string lFilePath = "TestCSVParser_tryRead.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    // malformed records are returned as errors and the following records are read after them.
+    for (const auto type_i : {
+        pml::CSVParser::InputType::STRING_REF, pml::CSVParser::InputType::MMAP, pml::CSVParser::InputType::ASYNC_FILE })
+    {
+        pml::CSVParser lParser(type_i, (type_i == pml::CSVParser::InputType::STRING_REF) ? lCSV : lFilePath, 4);
+        std::vector<std::string_view> lView;
+        pml::CSVRecord lRecord;
+
+        auto lResult = lParser.tryReadNextOneRecordView(lView);
+        ASSERT_TRUE(lResult && *lResult);
+        EXPECT_EQ(std::vector<std::string_view>({ "a", "b" }), lView);
+
+        for (const auto line_i : { 2, 3 })
+        {
+            lResult = lParser.tryReadNextOneRecordView(lView);
+            ASSERT_FALSE(lResult);
+            EXPECT_EQ(pml::errc::malformed_record, lResult.error().code());
+            EXPECT_EQ(static_cast<std::uint64_t>(line_i), lResult.error().context());
+            EXPECT_TRUE(lView.empty());
+        }
+
+        lResult = lParser.tryReadNextOneRecord(lRecord);
+        ASSERT_TRUE(lResult && *lResult);
+        EXPECT_EQ(std::vector<std::string>({ "i", "j" }), lRecord.toVector());
+
+        lResult = lParser.tryReadNextOneRecord(lRecord);
+        ASSERT_FALSE(lResult);
+        EXPECT_EQ(5U, lResult.error().context());
+        EXPECT_NE(std::string::npos, lResult.error().message().find("Field is not closed by right side double quotation."));
+
+        lResult = lParser.tryReadNextOneRecordView(lView);
+        ASSERT_TRUE(lResult && *lResult);
+        EXPECT_EQ(std::vector<std::string_view>({ "m", "n" }), lView);
+
+        lResult = lParser.tryReadNextOneRecordView(lView);
+        ASSERT_TRUE(lResult);
+        EXPECT_FALSE(*lResult);
+        EXPECT_TRUE(lParser.getErrors().empty());
+
+        // the throwing reads are unchanged after the non-throwing ones.
+        pml::CSVParser lThrowing(type_i, (type_i == pml::CSVParser::InputType::STRING_REF) ? lCSV : lFilePath, 4);
+        ASSERT_TRUE(lThrowing.tryReadNextOneRecordView(lView).value());
+        EXPECT_THROW(lThrowing.readNextOneRecord(), std::runtime_error);
+    }
+
+    // the error-tolerant mode skips malformed records.
+    {
+        pml::CSVParser lParser(pml::CSVParser::InputType::FILE, lFilePath);
+        lParser.setErrorTolerant(true);
+
+        pml::CSVRecord lRecord;
+        ASSERT_TRUE(lParser.tryReadNextOneRecord(lRecord).value());
+        ASSERT_TRUE(lParser.tryReadNextOneRecord(lRecord).value());
+        EXPECT_EQ(std::vector<std::string>({ "i", "j" }), lRecord.toVector());
+        EXPECT_FALSE(lParser.tryReadNextOneRecord(lRecord).value());
+        EXPECT_EQ(3U, lParser.getErrors().size());
+    }
+
+    const auto lMalformed = pml::CSVParser::tryReadAllRecords(lFilePath);
+    ASSERT_FALSE(lMalformed);
+    EXPECT_EQ(pml::errc::malformed_record, lMalformed.error().code());
+    EXPECT_EQ(2U, lMalformed.error().context());
+
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << "a,\"b\"\"c\"\r\nd";
+    }
+
+    const auto lRecords = pml::CSVParser::tryReadAllRecords(lFilePath);
+    ASSERT_TRUE(lRecords);
+    EXPECT_EQ(pml::CSVParser::readAllRecords(lFilePath), *lRecords);
+
+    EXPECT_EQ(pml::errc::not_open, pml::CSVParser::tryReadAllRecords("TestCSVParser_notFound.csv").error().code());
+
+    std::vector<std::string_view> lView;
+    pml::CSVParser lClosed(pml::CSVParser::InputType::FILE, "TestCSVParser_notFound.csv");
+    EXPECT_EQ(pml::errc::not_open, lClosed.tryReadNextOneRecordView(lView).error().code());
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(CSVParserStatic, follow)
+{
+    const std::string lFilePath = "TestCSVParser_follow.csv";
+    const auto lAppend = [&](const std::string& inData, bool inIsTruncated = false) {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | (inIsTruncated ? std::ios::trunc : std::ios::app));
+        lFile << inData;
+    };
+
+    lAppend("a,b\nc,", true);
+
+    pml::CSVParser lParser(pml::CSVParser::InputType::FOLLOW_FILE, lFilePath, 4);
+    ASSERT_TRUE(lParser.isOpen());
+    EXPECT_EQ(std::vector<std::string>({ "a", "b" }), lParser.readNextOneRecord());
+    EXPECT_TRUE(lParser.isEnd());
+    EXPECT_FALSE(lParser.follow());
+
+    // only complete records are returned, where CR at the end may be followed by LF.
+    lAppend("d\n\"e\r");
+    EXPECT_TRUE(lParser.follow());
+    EXPECT_EQ(std::vector<std::string>({ "c", "d" }), lParser.readNextOneRecord());
+    EXPECT_FALSE(lParser.follow());
+
+    lAppend("f\"\r");
+    EXPECT_FALSE(lParser.follow());
+    lAppend("\n");
+    EXPECT_TRUE(lParser.follow());
+
+    std::vector<std::string_view> lView;
+    ASSERT_TRUE(lParser.readNextOneRecordView(lView));
+    EXPECT_EQ(std::vector<std::string_view>({ "e\rf" }), lView);
+    EXPECT_FALSE(lParser.readNextOneRecordView(lView));
+    EXPECT_EQ(3U, lParser.getLineNumber());
+
+    const auto lOffset = lParser.getOffset();
+    EXPECT_EQ(15U, lOffset);
+
+    // an append by another thread wakes up the waiting parser.
+    std::thread lWriter([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        lAppend("g,h\ni");
+    });
+
+    EXPECT_TRUE(lParser.follow(std::chrono::seconds(10)));
+    lWriter.join();
+    EXPECT_EQ(std::vector<std::string>({ "g", "h" }), lParser.readNextOneRecord());
+    EXPECT_FALSE(lParser.follow(std::chrono::milliseconds(20)));
+
+    // another parser resumes from the offset.
+    {
+        pml::CSVParser lResumed(pml::CSVParser::InputType::FOLLOW_FILE, lFilePath);
+        lResumed.seekToOffset(lOffset, 3);
+        EXPECT_EQ(std::vector<std::string>({ "g", "h" }), lResumed.readNextOneRecord());
+        EXPECT_EQ(4U, lResumed.getLineNumber());
+        EXPECT_TRUE(lResumed.isEnd());
+    }
+
+    // the rewritten file is followed from the beginning.
+    lAppend("j\n", true);
+    EXPECT_TRUE(lParser.follow());
+    EXPECT_EQ(std::vector<std::string>({ "j" }), lParser.readNextOneRecord());
+    EXPECT_EQ(1U, lParser.getLineNumber());
+
+#ifndef _WIN32
+    // a rotated file is read to its end, and then the new file at the path is followed from the beginning.
+    // Windows does not rename open files.
+    const auto lRotatedPath = lFilePath + ".1";
+    std::remove(lRotatedPath.c_str());
+    ASSERT_EQ(0, std::rename(lFilePath.c_str(), lRotatedPath.c_str()));
+    {
+        std::ofstream lRotated(lRotatedPath, std::ios::out | std::ios::binary | std::ios::app);
+        lRotated << "k\n";
+    }
+
+    EXPECT_TRUE(lParser.follow());
+    EXPECT_EQ(std::vector<std::string>({ "k" }), lParser.readNextOneRecord());
+    EXPECT_FALSE(lParser.follow(std::chrono::milliseconds(20)));
+
+    // the new file is not smaller than the read bytes of the old one.
+    std::thread lCreator([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        lAppend("l,m\n", true);
+    });
+
+    EXPECT_TRUE(lParser.follow(std::chrono::seconds(10)));
+    lCreator.join();
+    EXPECT_EQ(std::vector<std::string>({ "l", "m" }), lParser.readNextOneRecord());
+    EXPECT_EQ(1U, lParser.getLineNumber());
+    EXPECT_EQ(4U, lParser.getOffset());
+    std::remove(lRotatedPath.c_str());
+#endif
+
+    EXPECT_FALSE(pml::CSVParser(pml::CSVParser::InputType::FOLLOW_FILE, "TestCSVParser_notFound.csv").isOpen());
+
+    const std::string lCSV = "k";
+    pml::CSVParser lStringParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+    EXPECT_TRUE(lStringParser.follow());
+    EXPECT_EQ(0U, lStringParser.getOffset());
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(CSVParserStatic, tsv)
+{
+    const std::string lTSV = "a b\t \"c\td\" \t\n\t\r\ne,f";
+    const std::vector<std::vector<std::string>> lExpected = { { "a b", "c\td", "" }, { "", "" }, { "e,f" } };
+
+    const std::string lFilePath = "TestCSVParser_tsv.tsv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lTSV;
+    }
+
+    for (const auto type_i : { pml::CSVParser::InputType::STRING_REF, pml::CSVParser::InputType::FILE, pml::CSVParser::InputType::MMAP })
+    {
+        pml::CSVParser lParser(type_i, (type_i == pml::CSVParser::InputType::STRING_REF) ? lTSV : lFilePath, 0, pml::TSVDialect());
+
+        std::vector<std::vector<std::string>> lRecords;
+        while (!lParser.isEnd()) {
+            lRecords.push_back(lParser.readNextOneRecord());
+        }
+
+        EXPECT_EQ(lExpected, lRecords);
+    }
+
+    // the default dialect is unchanged.
+    EXPECT_EQ(std::vector<std::string>({ "a b\tc" }), pml::CSVParser(pml::CSVParser::InputType::STRING_REF, "a b\tc").readNextOneRecord());
+    EXPECT_EQ(std::vector<std::string>({ "a", "b" }), pml::CSVParser(pml::CSVParser::InputType::STRING_REF, "a|b", 0, pml::PSVDialect()).readNextOneRecord());
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(CSVParserStatic, dialect)
+{
+    using Dialect = pml::BasicCSVDialect<';', '\'', false, '#', true>;
+
+    // comment lines may appear anywhere except inside quotations, where # is an ordinary character.
+    // quotations in comment lines are ordinary characters, and they do not break the boundaries of ASYNC_FILE and FOLLOW_FILE.
+    std::mt19937 lEngine(4);
+    const std::vector<std::pair<std::string, std::string>> lFields = {
+        { "", "" }, { "a", "a" }, { " b ", " b " }, { "'c;d'", "c;d" }, { "'e''f'", "e'f" }, { "'g\n#h'", "g\n#h" },
+        { "\"i\"", "\"i\"" }, { "j#", "j#" }, { "'#k'", "#k" }, { "l,m", "l,m" }, { std::string(100, 'n'), std::string(100, 'n') } };
+    const std::vector<std::string> lNewLines = { "\n", "\r", "\r\n" };
+
+    std::string lCSV = "# header follows\r\nx;y;z\n";
+    std::vector<std::vector<std::string>> lExpected;
+    while (lCSV.size() < 50000)
+    {
+        if (std::uniform_int_distribution<int>(0, 3)(lEngine) == 0) {
+            lCSV += "#;comment, isn't a record" + lNewLines[std::uniform_int_distribution<std::size_t>(0, lNewLines.size() - 1)(lEngine)];
+        }
+
+        lExpected.emplace_back();
+        const auto lFieldNumber = std::uniform_int_distribution<std::size_t>(1, 4)(lEngine);
+        for (std::size_t i = 0; i < lFieldNumber; ++i)
+        {
+            // an empty line after CR would be a part of CRLF.
+            const auto& lField = lFields[std::uniform_int_distribution<std::size_t>((i == 0) ? 1 : 0, lFields.size() - 1)(lEngine)];
+            lCSV += ((i == 0) ? "" : ";") + lField.first;
+            lExpected.back().push_back(lField.second);
+        }
+
+        lCSV += lNewLines[std::uniform_int_distribution<std::size_t>(0, lNewLines.size() - 1)(lEngine)];
+    }
+    lCSV += "#'\n#end";
+
+    const std::string lFilePath = "TestCSVParser_dialect.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    const std::vector<std::pair<pml::CSVParser::InputType, std::size_t>> lTypes = {
+        { pml::CSVParser::InputType::STRING_REF, 0 }, { pml::CSVParser::InputType::STRING_COPY, 0 }, { pml::CSVParser::InputType::FILE, 0 },
+        { pml::CSVParser::InputType::MMAP, 0 }, { pml::CSVParser::InputType::ASYNC_FILE, 7 }, { pml::CSVParser::InputType::ASYNC_FILE, 0 },
+        { pml::CSVParser::InputType::ASYNC_FILE, 1 }, { pml::CSVParser::InputType::FOLLOW_FILE, 16 }, { pml::CSVParser::InputType::FOLLOW_FILE, 1 } };
+
+    for (const auto& type_i : lTypes)
+    {
+        const auto lIsString = (type_i.first == pml::CSVParser::InputType::STRING_REF) || (type_i.first == pml::CSVParser::InputType::STRING_COPY);
+        pml::CSVParser lParser(type_i.first, lIsString ? lCSV : lFilePath, type_i.second, Dialect());
+        ASSERT_EQ(std::vector<std::string>({ "x", "y", "z" }), lParser.getHeader());
+        EXPECT_EQ(1U, lParser.getLineNumber());
+
+        std::vector<std::string_view> lView;
+        for (std::size_t i = 0; i < lExpected.size(); ++i)
+        {
+            ASSERT_TRUE(lParser.readNextOneRecordView(lView));
+            ASSERT_EQ(lExpected[i], std::vector<std::string>(lView.cbegin(), lView.cend())) << i;
+        }
+
+        // the last comment lines are skipped by the last read.
+        EXPECT_TRUE(lParser.isEnd());
+        EXPECT_FALSE(lParser.readNextOneRecordView(lView));
+        EXPECT_EQ(lExpected.size() + 1, lParser.getLineNumber());
+
+        // the loop of isEnd() reads no empty record after them.
+        pml::CSVParser lLoop(type_i.first, lIsString ? lCSV : lFilePath, type_i.second, Dialect());
+        std::size_t lRecordNumber = 0;
+        while (!lLoop.isEnd())
+        {
+            EXPECT_EQ(lExpected[lRecordNumber], lLoop.readNextOneRecord());
+            ++lRecordNumber;
+        }
+
+        EXPECT_EQ(lExpected.size(), lRecordNumber);
+    }
+
+    // names of projections are looked up in the header.
+    pml::CSVParser lProjected(pml::CSVParser::InputType::STRING_REF, lCSV, 0, Dialect());
+    lProjected.setProjection(std::vector<std::string>{ "z", "x" });
+    const auto lRecord = lProjected.readNextOneRecord();
+    ASSERT_EQ(2U, lRecord.size());
+    EXPECT_EQ(lExpected[0][0], lRecord[1]);
+
+    // spaces outside quotations are a part of fields without trimming.
+    EXPECT_EQ(std::vector<std::string>({ "a" }), pml::CSVParser(pml::CSVParser::InputType::STRING_REF, " 'a' ", 0, pml::BasicCSVDialect<',', '\''>()).readNextOneRecord());
+    EXPECT_THROW(pml::CSVParser(pml::CSVParser::InputType::STRING_REF, "x\n 'a' ", 0, Dialect()).readNextOneRecord(), std::runtime_error);
+
+    pml::CSVParser lComments(pml::CSVParser::InputType::STRING_REF, "#a\n#b", 0, pml::BasicCSVDialect<',', '\"', true, '#'>());
+    EXPECT_TRUE(lComments.isEnd());
+
+    std::remove(lFilePath.c_str());
+}
@@ -0,0 +1,119 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Utility/CSVParser.h>
+#include <PML/Utility/CSVRecord.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+TEST(TestCSVRecord, inputTypes)
+{
+    std::mt19937 lEngine(5);
+    const std::vector<std::string> lFields = { "", "a", " b ", " \"c,d\" ", "\"e\"\"f\"", "\"g\nh\"", "\"\r\n\"", std::string(100, 'i') };
+    const std::vector<std::string> lNewLines = { "\n", "\r", "\r\n" };
+
+    std::string lCSV;
+    while (lCSV.size() < 20000)
+    {
+        const auto lFieldNumber = std::uniform_int_distribution<std::size_t>(1, 4)(lEngine);
+        for (std::size_t i = 0; i < lFieldNumber; ++i) {
+            lCSV += ((i == 0) ? "" : ",") + lFields[std::uniform_int_distribution<std::size_t>(0, lFields.size() - 1)(lEngine)];
+        }
+
+        lCSV += lNewLines[std::uniform_int_distribution<std::size_t>(0, lNewLines.size() - 1)(lEngine)];
+    }
+
+    const std::string lFilePath = "TestCSVRecord_inputTypes.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    const auto lExpected = pml::CSVParser::readAllRecords(lFilePath);
+
+    for (const auto type_i : {
+        pml::CSVParser::InputType::FILE, pml::CSVParser::InputType::STRING_REF, pml::CSVParser::InputType::STRING_COPY,
+        pml::CSVParser::InputType::MMAP, pml::CSVParser::InputType::ASYNC_FILE })
+    {
+        const auto lIsString = (type_i == pml::CSVParser::InputType::STRING_REF) || (type_i == pml::CSVParser::InputType::STRING_COPY);
+        pml::CSVParser lParser(type_i, lIsString ? lCSV : lFilePath, 64);
+
+        pml::CSVRecord lRecord;
+        for (std::size_t i = 0; i < lExpected.size(); ++i)
+        {
+            ASSERT_TRUE(lParser.readNextOneRecord(lRecord));
+            ASSERT_EQ(lExpected[i], lRecord.toVector()) << i;
+        }
+
+        EXPECT_FALSE(lParser.readNextOneRecord(lRecord));
+        EXPECT_TRUE(lRecord.empty());
+        EXPECT_EQ(lExpected.size(), lParser.getLineNumber());
+    }
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(TestCSVRecord, reuse)
+{
+    const std::string lCSV = std::string(100, 'a') + ",\"b\"\"c\"\nd,e\r\nf\n,\n\"g\"";
+
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_REF, lCSV);
+    pml::CSVRecord lRecord;
+
+    ASSERT_TRUE(lParser.readNextOneRecord(lRecord));
+    ASSERT_EQ(2U, lRecord.size());
+    EXPECT_EQ(std::string(100, 'a'), lRecord[0]);
+    EXPECT_EQ("b\"c", lRecord.at(1));
+    EXPECT_THROW(lRecord.at(2), std::out_of_range);
+
+    // the buffer of the longest record is reused by the following ones.
+    const auto lData = lRecord[0].data();
+    ASSERT_TRUE(lParser.readNextOneRecord(lRecord));
+    EXPECT_EQ((std::vector<std::string>{ "d", "e" }), lRecord.toVector());
+    EXPECT_EQ(lData, lRecord[0].data());
+
+    ASSERT_TRUE(lParser.readNextOneRecord(lRecord));
+    EXPECT_EQ((std::vector<std::string>{ "f" }), lRecord.toVector());
+    ASSERT_TRUE(lParser.readNextOneRecord(lRecord));
+    EXPECT_EQ((std::vector<std::string>{ "", "" }), lRecord.toVector());
+
+    // a copy is independent of the parser and the original.
+    const auto lCopy = lRecord;
+    ASSERT_TRUE(lParser.readNextOneRecord(lRecord));
+    EXPECT_EQ((std::vector<std::string>{ "g" }), lRecord.toVector());
+    EXPECT_EQ((std::vector<std::string>{ "", "" }), lCopy.toVector());
+
+    EXPECT_TRUE(lParser.isEnd());
+    EXPECT_FALSE(lParser.readNextOneRecord(lRecord));
+}
+
+TEST(TestCSVRecord, projectionAndErrors)
+{
+    const std::string lCSV = "a,b,c\n1,\"x\"y,3\n\"p\" ,q";
+
+    for (const auto type_i : { pml::CSVParser::InputType::STRING_REF, pml::CSVParser::InputType::FILE })
+    {
+        const std::string lFilePath = "TestCSVRecord_projectionAndErrors.csv";
+        {
+            std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+            lFile << lCSV;
+        }
+
+        pml::CSVParser lParser(type_i, (type_i == pml::CSVParser::InputType::STRING_REF) ? lCSV : lFilePath);
+        lParser.setErrorTolerant(true);
+        lParser.setProjection(std::vector<std::size_t>{ 2, 0 });
+
+        pml::CSVRecord lRecord;
+        ASSERT_TRUE(lParser.readNextOneRecord(lRecord));
+        EXPECT_EQ((std::vector<std::string>{ "c", "a" }), lRecord.toVector());
+
+        // the malformed record is discarded from the buffer.
+        ASSERT_TRUE(lParser.readNextOneRecord(lRecord));
+        EXPECT_EQ((std::vector<std::string>{ "", "p" }), lRecord.toVector());
+        EXPECT_EQ(1U, lParser.getErrors().size());
+
+        std::remove(lFilePath.c_str());
+    }
+}
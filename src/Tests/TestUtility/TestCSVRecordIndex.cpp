@@ -0,0 +1,121 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Utility/CSVParser.h>
+#include <PML/Utility/CSVRecordIndex.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+TEST(TestCSVRecordIndex, offsets)
+{
+    const std::string lCSV = "a,\"b\nc\"\r\n\nd\r\"e\r\n\",f\n";
+    const pml::CSVRecordIndex lIndex(lCSV.data(), lCSV.data() + lCSV.size());
+
+    ASSERT_EQ(4U, lIndex.size());
+    EXPECT_EQ(0U,  lIndex.getOffset(0));
+    EXPECT_EQ(9U,  lIndex.getOffset(1));
+    EXPECT_EQ(10U, lIndex.getOffset(2));
+    EXPECT_EQ(12U, lIndex.getOffset(3));
+    EXPECT_EQ(lCSV.size(), lIndex.getOffset(4));
+    EXPECT_THROW(lIndex.getOffset(5), std::out_of_range);
+
+    EXPECT_TRUE(pml::CSVRecordIndex().empty());
+    EXPECT_EQ(1U, pml::CSVRecordIndex(lCSV.data(), lCSV.data() + 1).size());
+}
+
+TEST(TestCSVRecordIndex, seekAndRanges)
+{
+    // more than 1 MiB so that the index is built over several chunks.
+    std::mt19937 lEngine(2);
+    const std::vector<std::string> lFields = { "", "a", "\"b,c\"", "\"d\"\"e\"", "\"f\ng\"", "\"\r\n\"", std::string(100, 'h') };
+    const std::vector<std::string> lNewLines = { "\n", "\r", "\r\n" };
+
+    std::string lCSV;
+    while (lCSV.size() < (std::size_t(1) << 20) + 50000)
+    {
+        const auto lFieldNumber = std::uniform_int_distribution<std::size_t>(1, 4)(lEngine);
+        for (std::size_t i = 0; i < lFieldNumber; ++i) {
+            lCSV += ((i == 0) ? "" : ",") + lFields[std::uniform_int_distribution<std::size_t>(0, lFields.size() - 1)(lEngine)];
+        }
+
+        lCSV += lNewLines[std::uniform_int_distribution<std::size_t>(0, lNewLines.size() - 1)(lEngine)];
+    }
+
+    const std::string lFilePath  = "TestCSVRecordIndex_seekAndRanges.csv";
+    const std::string lIndexPath = lFilePath + ".idx";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+
+    const auto lRecords = pml::CSVParser::readAllRecords(lFilePath);
+    const pml::CSVRecordIndex lIndex(lFilePath);
+    ASSERT_EQ(lRecords.size(), lIndex.size());
+    EXPECT_EQ(lCSV.size(), lIndex.getDataSize());
+
+    pml::CSVParser lParser(pml::CSVParser::InputType::MMAP, lFilePath);
+    for (const auto record_i : { lRecords.size() - 1, std::size_t(0), lRecords.size() / 2, std::size_t(1) })
+    {
+        lParser.seekToRecord(lIndex, record_i);
+        EXPECT_EQ(record_i, lParser.getLineNumber());
+        EXPECT_EQ(lRecords[record_i], lParser.readNextOneRecord());
+    }
+
+    lParser.seekToRecord(lIndex, lIndex.size());
+    EXPECT_TRUE(lParser.isEnd());
+
+    pml::ThreadPool lPool(3);
+    EXPECT_EQ(lRecords, pml::CSVParser::readRecordsParallel(lFilePath, lIndex, 0, lIndex.size(), lPool));
+
+    const auto lRange = pml::CSVParser::readRecordsParallel(lFilePath, lIndex, 100, 110, lPool);
+    EXPECT_EQ(std::vector<std::vector<std::string>>(lRecords.begin() + 100, lRecords.begin() + 110), lRange);
+    EXPECT_TRUE(pml::CSVParser::readRecordsParallel(lFilePath, lIndex, 5, 5, lPool).empty());
+    EXPECT_THROW(pml::CSVParser::readRecordsParallel(lFilePath, lIndex, 0, lIndex.size() + 1, lPool), std::runtime_error);
+
+    // the sidecar file is loaded only while the source is not modified.
+    pml::CSVRecordIndex lLoaded;
+    EXPECT_FALSE(lLoaded.load(lIndexPath, lFilePath));
+
+    lIndex.save(lIndexPath, lFilePath);
+    ASSERT_TRUE(lLoaded.load(lIndexPath, lFilePath));
+    ASSERT_EQ(lIndex.size(), lLoaded.size());
+    EXPECT_EQ(lIndex.getOffset(lIndex.size() / 3), lLoaded.getOffset(lIndex.size() / 3));
+
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::app);
+        lFile << "z\n";
+    }
+
+    EXPECT_FALSE(pml::CSVRecordIndex().load(lIndexPath, lFilePath));
+
+    std::remove(lFilePath.c_str());
+    std::remove(lIndexPath.c_str());
+}
+
+TEST(TestCSVRecordIndex, seekString)
+{
+    const std::string lCSV = "a,b\n\"c\nd\",e\nf";
+    const pml::CSVRecordIndex lIndex(lCSV.data(), lCSV.data() + lCSV.size());
+
+    pml::CSVParser lParser(pml::CSVParser::InputType::STRING_COPY, lCSV);
+    lParser.seekToRecord(lIndex, 2);
+    EXPECT_EQ(std::vector<std::string>({ "f" }), lParser.readNextOneRecord());
+
+    lParser.seekToRecord(lIndex, 1);
+    EXPECT_EQ(std::vector<std::string>({ "c\nd", "e" }), lParser.readNextOneRecord());
+    EXPECT_EQ(2U, lParser.getLineNumber());
+
+    const std::string lFilePath = "TestCSVRecordIndex_seekString.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << lCSV;
+    }
+    {
+        pml::CSVParser lFileParser(pml::CSVParser::InputType::FILE, lFilePath);
+        EXPECT_THROW(lFileParser.seekToRecord(lIndex, 1), std::logic_error);
+    }
+
+    std::remove(lFilePath.c_str());
+}
@@ -0,0 +1,118 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Utility/CSVStructuralIndex.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using Indexer = pml::detail::CSVStructuralIndexer;
+
+    std::vector<Indexer::Kernel> getSupportedKernels()
+    {
+        std::vector<Indexer::Kernel> lKernels = { Indexer::Kernel::Scalar };
+
+        if (pml::CPUDispatcher::isPCLMULQDQ() && pml::CPUDispatcher::isAVX2()) {
+            lKernels.push_back(Indexer::Kernel::AVX2);
+        }
+
+        if (pml::CPUDispatcher::isPCLMULQDQ() && pml::CPUDispatcher::isAVX512BW()) {
+            lKernels.push_back(Indexer::Kernel::AVX512BW);
+        }
+
+        return lKernels;
+    }
+}
+
+TEST(TestCSVStructuralIndex, structurals)
+{
+    const std::string lCSV = "a,\"b,\r\nc\"\"\"\r\n,d\n";
+    std::vector<std::size_t> lExpected = { 1, 2, 8, 9, 10, 11, 12, 13, 15 };
+
+    for (const auto kernel_i : getSupportedKernels())
+    {
+        std::vector<const char*> lStructurals;
+        EXPECT_FALSE(Indexer::index(kernel_i, lCSV.data(), lCSV.data() + lCSV.size(), false, lStructurals));
+
+        std::vector<std::size_t> lPositions;
+        for (const auto structural_i : lStructurals) {
+            lPositions.push_back(static_cast<std::size_t>(structural_i - lCSV.data()));
+        }
+
+        EXPECT_EQ(lExpected, lPositions);
+    }
+}
+
+TEST(TestCSVStructuralIndex, kernels)
+{
+    std::mt19937 lEngine(0);
+    const char lAlphabet[] = { 'a', ' ', ',', '\"', '\r', '\n' };
+
+    for (const auto size_i : { 0, 1, 63, 64, 65, 127, 128, 1000, 4099 })
+    {
+        std::string lCSV;
+        for (auto i = 0; i < size_i; ++i) {
+            lCSV.push_back(lAlphabet[std::uniform_int_distribution<std::size_t>(0, sizeof(lAlphabet) - 1)(lEngine)]);
+        }
+
+        // the scalar kernel indexing the whole data at once is the reference.
+        std::vector<const char*> lExpected;
+        const auto lIsInQuotes = Indexer::index(Indexer::Kernel::Scalar, lCSV.data(), lCSV.data() + lCSV.size(), false, lExpected);
+
+        for (const auto kernel_i : getSupportedKernels())
+        {
+            // the quotation state is carried between calls splitting the data at arbitrary points.
+            std::vector<const char*> lStructurals;
+            auto lState = false;
+            for (std::size_t lFirst = 0; lFirst < lCSV.size(); )
+            {
+                const auto lLast = std::min(lCSV.size(), lFirst + std::uniform_int_distribution<std::size_t>(1, 200)(lEngine));
+                lState = Indexer::index(kernel_i, lCSV.data() + lFirst, lCSV.data() + lLast, lState, lStructurals);
+                lFirst = lLast;
+            }
+
+            EXPECT_EQ(lIsInQuotes, lState);
+            EXPECT_EQ(lExpected, lStructurals);
+        }
+    }
+}
+
+TEST(TestCSVStructuralIndex, dialect)
+{
+    const std::string lCSV = "a\t'b\t,\"\nc'''\t\"d\r\n";
+    std::vector<std::size_t> lExpected = { 1, 2, 9, 10, 11, 12, 15, 16 };
+
+    for (const auto kernel_i : getSupportedKernels())
+    {
+        std::vector<const char*> lStructurals;
+        EXPECT_FALSE((Indexer::index<'\t', '\''>(kernel_i, lCSV.data(), lCSV.data() + lCSV.size(), false, lStructurals)));
+
+        std::vector<std::size_t> lPositions;
+        for (const auto structural_i : lStructurals) {
+            lPositions.push_back(static_cast<std::size_t>(structural_i - lCSV.data()));
+        }
+
+        EXPECT_EQ(lExpected, lPositions);
+    }
+
+    std::mt19937 lEngine(1);
+    const char lAlphabet[] = { 'a', ' ', ',', '\t', '\"', '|', '\'', '\r', '\n' };
+
+    std::string lRandom;
+    for (auto i = 0; i < 1000; ++i) {
+        lRandom.push_back(lAlphabet[std::uniform_int_distribution<std::size_t>(0, sizeof(lAlphabet) - 1)(lEngine)]);
+    }
+
+    std::vector<const char*> lReference;
+    const auto lIsInQuotes = Indexer::index<'|', '\''>(Indexer::Kernel::Scalar, lRandom.data(), lRandom.data() + lRandom.size(), false, lReference);
+
+    for (const auto kernel_i : getSupportedKernels())
+    {
+        std::vector<const char*> lStructurals;
+        EXPECT_EQ(lIsInQuotes, (Indexer::index<'|', '\''>(kernel_i, lRandom.data(), lRandom.data() + lRandom.size(), false, lStructurals)));
+        EXPECT_EQ(lReference, lStructurals);
+    }
+}
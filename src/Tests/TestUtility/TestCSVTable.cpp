@@ -0,0 +1,88 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Utility/CSVTable.h>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+TEST(TestCSVTable, rowsAndColumns)
+{
+    const std::string lFilePath = "TestCSVTable_rowsAndColumns.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << "b,\"x,y\",\nc\r\na,1,\"2\"\"\",3\nb,z";
+    }
+
+    const pml::CSVTable lRows(lFilePath, true);
+    const auto lExpectedRows = pml::CSVParser::readTable(lFilePath, true);
+
+    ASSERT_EQ(lExpectedRows.size(), lRows.size());
+    for (const auto& entry_i : lExpectedRows)
+    {
+        ASSERT_TRUE(lRows.contains(entry_i.first));
+        EXPECT_EQ(entry_i.second, lRows.at(entry_i.first).toVector());
+    }
+
+    EXPECT_EQ("b", lRows.getKey(0));
+    EXPECT_EQ("x,y", lRows.at("b")[0]);
+    EXPECT_EQ("2\"", lRows.at("a")[1]);
+    EXPECT_TRUE(lRows.at("c").empty());
+    EXPECT_EQ(lRows.size(), lRows.find("d"));
+    EXPECT_THROW(lRows.at("d"), std::out_of_range);
+
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << "k1,k2,k1\n1,2,3\r4,\"5\n6\",7\n";
+    }
+
+    const pml::CSVTable lColumns(lFilePath, false);
+    const auto lExpectedColumns = pml::CSVParser::readTable(lFilePath, false);
+
+    ASSERT_EQ(2U, lColumns.size());
+    for (const auto& entry_i : lExpectedColumns) {
+        EXPECT_EQ(entry_i.second, lColumns.at(entry_i.first).toVector());
+    }
+
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << "k1,k2\n1,2\n3\n";
+    }
+
+    EXPECT_THROW(pml::CSVTable(lFilePath, false), std::runtime_error);
+    EXPECT_THROW(pml::CSVTable("TestCSVTable_notFound.csv", true), std::runtime_error);
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(TestCSVTable, manyKeys)
+{
+    // many keys collide in the lower bits of the buckets and are resolved by probing.
+    std::mt19937 lEngine(5);
+    std::uniform_int_distribution<int> lDistribution(0, 1000000);
+
+    const std::string lFilePath = "TestCSVTable_manyKeys.csv";
+    {
+        std::ofstream lFile(lFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        for (std::size_t i = 0; i < 20000; ++i) {
+            lFile << "key" << lDistribution(lEngine) << "," << i << "," << lDistribution(lEngine) << "\n";
+        }
+    }
+
+    const pml::CSVTable lTable(lFilePath, true);
+    const auto lExpected = pml::CSVParser::readTable(lFilePath, true);
+
+    ASSERT_EQ(lExpected.size(), lTable.size());
+    for (const auto& entry_i : lExpected)
+    {
+        const auto lIndex = lTable.find(entry_i.first);
+        ASSERT_NE(lTable.size(), lIndex);
+        EXPECT_EQ(entry_i.first, lTable.getKey(lIndex));
+        EXPECT_EQ(entry_i.second, lTable.getValues(lIndex).toVector());
+    }
+
+    EXPECT_FALSE(lTable.contains("key-1"));
+
+    std::remove(lFilePath.c_str());
+}
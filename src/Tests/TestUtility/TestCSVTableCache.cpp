@@ -0,0 +1,93 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Utility/CSVTableCache.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+TEST(TestCSVTableCache, writeAndLoad)
+{
+    const std::string lSourcePath = "TestCSVTableCache_writeAndLoad.csv";
+    const std::string lCachePath  = lSourcePath + ".cache";
+    {
+        std::ofstream lFile(lSourcePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        lFile << "b,\"x,y\",\nc\na,1,2,3";
+    }
+
+    EXPECT_FALSE(pml::CSVTableCache(lCachePath).isValid());
+    EXPECT_TRUE (pml::CSVTableCache::prepare(lSourcePath, true, lCachePath));
+    EXPECT_FALSE(pml::CSVTableCache::prepare(lSourcePath, true, lCachePath));
+
+    const auto lTable = pml::CSVParser::readTable(lSourcePath, true);
+    {
+        pml::CSVTableCache lCache(lCachePath);
+
+        EXPECT_TRUE (lCache.isValid());
+        EXPECT_TRUE (lCache.verify());
+        EXPECT_TRUE (lCache.isFresh(lSourcePath, true));
+        EXPECT_FALSE(lCache.isFresh(lSourcePath, false));
+        ASSERT_EQ(3U, lCache.size());
+
+        EXPECT_EQ("a", lCache.getKey(0));
+        EXPECT_EQ("c", lCache.getKey(2));
+        EXPECT_TRUE(lCache.getValues(2).empty());
+
+        for (const auto& entry_i : lTable)
+        {
+            ASSERT_TRUE(lCache.contains(entry_i.first));
+            EXPECT_EQ(entry_i.second, lCache.at(entry_i.first).toVector());
+        }
+
+        EXPECT_EQ("x,y", lCache.at("b")[0]);
+        EXPECT_EQ(lCache.size(), lCache.find("d"));
+        EXPECT_THROW(lCache.at("d"), std::out_of_range);
+    }
+
+    // a modified source makes the cache stale.
+    {
+        std::ofstream lFile(lSourcePath, std::ios::out | std::ios::app);
+        lFile << "\nd,4";
+    }
+
+    EXPECT_FALSE(pml::CSVTableCache(lCachePath).isFresh(lSourcePath, true));
+    EXPECT_TRUE (pml::CSVTableCache::prepare(lSourcePath, true, lCachePath));
+    EXPECT_EQ("4", pml::CSVTableCache(lCachePath).at("d")[0]);
+
+    // a broken character is not read at opening, but is detected by the checksum and rewritten by prepare.
+    {
+        std::fstream lFile(lCachePath, std::ios::in | std::ios::out | std::ios::binary);
+        lFile.seekp(-1, std::ios::end);
+        lFile.put('?');
+    }
+
+    EXPECT_TRUE (pml::CSVTableCache(lCachePath).isValid());
+    EXPECT_FALSE(pml::CSVTableCache(lCachePath).verify());
+    EXPECT_TRUE (pml::CSVTableCache::prepare(lSourcePath, true, lCachePath));
+    EXPECT_TRUE (pml::CSVTableCache(lCachePath).verify());
+
+    // a broken offset between the ends is detected when it is read.
+    {
+        // Header is 64 bytes, followed by 5 value ranges of the 4 keys and the string offsets; this is the end of the first key.
+        const std::uint64_t lBroken = 1ULL << 40;
+        std::fstream lFile(lCachePath, std::ios::in | std::ios::out | std::ios::binary);
+        lFile.seekp(64 + 6 * sizeof(std::uint64_t));
+        lFile.write(reinterpret_cast<const char*>(&lBroken), sizeof(lBroken));
+    }
+    {
+        pml::CSVTableCache lCache(lCachePath);
+        EXPECT_TRUE (lCache.isValid());
+        EXPECT_FALSE(lCache.verify());
+        EXPECT_THROW(lCache.getKey(0), std::runtime_error);
+    }
+
+    // a truncated file is detected at opening.
+    std::filesystem::resize_file(lCachePath, std::filesystem::file_size(lCachePath) - 1);
+    EXPECT_FALSE(pml::CSVTableCache(lCachePath).isValid());
+    EXPECT_EQ(0U, pml::CSVTableCache(lCachePath).size());
+
+    std::remove(lSourcePath.c_str());
+    std::remove(lCachePath.c_str());
+}
@@ -0,0 +1,151 @@
+#include "stdafx.h"
+
+#include <gtest/gtest.h>
+#include <PML/Core/AlignedAllocator.h>
+#include <PML/Utility/CSVParser.h>
+#include <PML/Utility/CSVWriter.h>
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+
+class CSVWriterMode : public ::testing::TestWithParam<std::pair<bool, std::size_t>>
+{};
+
+TEST_P(CSVWriterMode, roundTrip)
+{
+    const std::string lFilePath = "TestCSVWriter_roundTrip.csv";
+    const std::vector<std::vector<std::string>> lRecords = {
+        { "abc", " d e ", "" },
+        { "f,g", "h\"i", "\"" },
+        { "j\nk", "l\r\nm", "n\r" },
+        { "" },
+        { std::string(100, 'o'), "p" } };
+
+    {
+        pml::CSVWriter lWriter(lFilePath, GetParam().first, GetParam().second);
+        ASSERT_TRUE(lWriter.isOpen());
+
+        for (const auto& record_i : lRecords) {
+            lWriter.writeRecord(record_i);
+        }
+
+        EXPECT_EQ(lRecords.size(), lWriter.getRecordNumber());
+        lWriter.close();
+        EXPECT_FALSE(lWriter.isOpen());
+    }
+
+    EXPECT_EQ(lRecords, pml::CSVParser::readAllRecords(lFilePath));
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST_P(CSVWriterMode, columns)
+{
+    const std::string lFilePath = "TestCSVWriter_columns.csv";
+
+    std::mt19937_64 lEngine(0);
+    std::uniform_real_distribution<double> lDistribution(-1.0e6, 1.0e6);
+
+    std::vector<std::string> lNames;
+    pml::aligned_vector<double> lValues;
+    std::vector<std::int64_t> lCounts;
+
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        lNames.push_back("s" + std::to_string(i));
+        lValues.push_back(lDistribution(lEngine) / ((i % 7) + 1.0e-3));
+        lCounts.push_back(static_cast<std::int64_t>(i) - 500);
+    }
+
+    lValues[0] = std::numeric_limits<double>::denorm_min();
+    lValues[1] = -std::numeric_limits<double>::max();
+    lValues[2] = 0.1;
+
+    {
+        pml::CSVWriter lWriter(lFilePath, GetParam().first, GetParam().second);
+
+        lWriter.writeField("name");
+        lWriter.writeField(std::string("value"));
+        lWriter.writeField(std::string_view("count"));
+        lWriter.endRecord();
+
+        lWriter.writeColumns(lNames, lValues, lCounts);
+        lWriter.flush();
+        lWriter.writeColumns(lNames, lValues, lCounts);
+
+        EXPECT_THROW(lWriter.writeColumns(lNames, lCounts, std::vector<float>(3)), std::logic_error);
+    }
+
+    const auto lRecords = pml::CSVParser::readAllRecords(lFilePath);
+    ASSERT_EQ(2 * lNames.size() + 1, lRecords.size());
+    EXPECT_EQ((std::vector<std::string>{ "name", "value", "count" }), lRecords[0]);
+    EXPECT_EQ("0.1", lRecords[3][1]);
+
+    for (std::size_t i = 0; i < 2 * lNames.size(); ++i)
+    {
+        const auto& lRecord = lRecords[i + 1];
+        const auto lIndex = i % lNames.size();
+
+        ASSERT_EQ(3U, lRecord.size());
+        EXPECT_EQ(lNames[lIndex], lRecord[0]);
+        double lValue = 0.0;
+        std::from_chars(lRecord[1].data(), lRecord[1].data() + lRecord[1].size(), lValue);
+        EXPECT_EQ(lValues[lIndex], lValue);
+        EXPECT_EQ(lCounts[lIndex], static_cast<std::int64_t>(std::stoll(lRecord[2])));
+    }
+
+    std::remove(lFilePath.c_str());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    name, CSVWriterMode,
+    ::testing::Values(
+        std::make_pair(false, std::size_t(0)),
+        std::make_pair(false, std::size_t(7)),
+        std::make_pair(true,  std::size_t(0)),
+        std::make_pair(true,  std::size_t(7)),
+        std::make_pair(true,  std::size_t(256))));
+
+TEST(TestCSVWriter, closed)
+{
+    pml::CSVWriter lNotOpen("TestCSVWriter_notFound/a.csv");
+    EXPECT_FALSE(lNotOpen.isOpen());
+    EXPECT_THROW(lNotOpen.writeField("a"), std::logic_error);
+    EXPECT_THROW(lNotOpen.endRecord(), std::logic_error);
+    EXPECT_NO_THROW(lNotOpen.close());
+
+    const std::string lFilePath = "TestCSVWriter_closed.csv";
+    {
+        pml::CSVWriter lWriter(lFilePath, false, 4);
+        lWriter.writeRecord(std::vector<int>{ 1, 2 });
+        lWriter.close();
+
+        EXPECT_THROW(lWriter.writeField("a"), std::logic_error);
+        EXPECT_THROW(lWriter.writeField(3), std::logic_error);
+        EXPECT_THROW(lWriter.endRecord(), std::logic_error);
+    }
+
+    EXPECT_EQ((std::vector<std::vector<std::string>>{ { "1", "2" } }), pml::CSVParser::readAllRecords(lFilePath));
+
+    std::remove(lFilePath.c_str());
+}
+
+TEST(TestCSVWriter, characters)
+{
+    const std::string lFilePath = "TestCSVWriter_characters.csv";
+    {
+        pml::CSVWriter lWriter(lFilePath);
+        lWriter.writeField('a');
+        lWriter.writeField(',');
+        lWriter.writeField(std::int8_t(-5));
+        lWriter.writeField(std::uint8_t(200));
+        lWriter.endRecord();
+    }
+
+    EXPECT_EQ((std::vector<std::vector<std::string>>{ { "a", ",", "-5", "200" } }), pml::CSVParser::readAllRecords(lFilePath));
+
+    std::remove(lFilePath.c_str());
+}